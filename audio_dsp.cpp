@@ -0,0 +1,724 @@
+// 音频处理 WASM 模块 - DSP 功能模块: 重采样 / 音量 / 交叉淡化 / 融合流水线 / 电平分析 / 参考音频预处理
+// 只做 WAV 编码 / 切分 / 合并的页面不需要这些函数, 可以构建不含本文件的核心模块, 首次使用时再加载本模块
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "audio_internal.h"
+#include "audio_pipeline.h"
+
+// 融合流水线导出函数共用: 在 stages 末尾接上 16 位 PCM 输出并运行, WAV 写入 g_memory_buffer; total 为 WAV 总字节数
+template <typename Stages>
+static uint32_t run_to_wav(AudioBuffer* source, const Stages& stages, uint32_t* total) {
+    uint32_t data_size = source->length * source->num_channels * 2;
+    *total = 44 + data_size;
+    if (source->num_channels > PIPELINE_MAX_CHANNELS) return 0;
+    if (!ensure_buffer_capacity(*total)) return 0;
+
+    write_wav_header((WAVHeader*)g_memory_buffer.buffer, source->num_channels, source->sample_rate, 16, data_size);
+    auto chain = stages | audio_pipeline::Pcm16Sink((int16_t*)(g_memory_buffer.buffer + 44));
+    audio_pipeline::pipeline_run(chain, source);
+
+    g_memory_buffer.size = *total;
+    return *total;
+}
+
+// 线性插值重采样核心: 按 view 读取, 按 output 的布局写入输出的第 [begin, end) 帧
+// 两侧都是平面布局时逐声道处理; 否则逐帧处理, 插值位置对所有声道只计算一次
+// 每个输出帧只取决于自身的位置, 任意切分范围的结果都相同
+static void resample_view_into(const AudioView* view, double ratio, const AudioBuffer* output,
+                               uint32_t begin, uint32_t end) {
+    AudioView out = audio_view_of(output);
+
+    if (view->frame_stride == 1 && out.frame_stride == 1) {
+        for (uint16_t ch = 0; ch < view->num_channels; ch++) {
+            const float* src = audio_view_channel(view, ch);
+            float* dst = view_write_ptr(&out, ch);
+
+            for (uint32_t i = begin; i < end; i++) {
+                double src_pos = i / ratio;
+                uint32_t src_idx = (uint32_t)src_pos;
+                double frac = src_pos - src_idx;
+
+                if (src_idx >= view->length - 1) {
+                    dst[i] = src[view->length - 1];
+                } else {
+                    dst[i] = (float)(src[src_idx] * (1 - frac) + src[src_idx + 1] * frac);
+                }
+            }
+        }
+        return;
+    }
+
+    const uint32_t fs = view->frame_stride;
+    const float* base = audio_view_channel(view, 0);
+    float* dst_base = view_write_ptr(&out, 0);
+    for (uint32_t i = begin; i < end; i++) {
+        double src_pos = i / ratio;
+        uint32_t src_idx = (uint32_t)src_pos;
+        double frac = src_pos - src_idx;
+        float* dst = dst_base + (size_t)i * out.frame_stride;
+
+        if (src_idx >= view->length - 1) {
+            const float* src = base + (size_t)(view->length - 1) * fs;
+            for (uint16_t ch = 0; ch < view->num_channels; ch++) {
+                dst[(size_t)ch * out.channel_stride] = src[(size_t)ch * view->channel_stride];
+            }
+        } else {
+            const float* src = base + (size_t)src_idx * fs;
+            for (uint16_t ch = 0; ch < view->num_channels; ch++) {
+                const float* s = src + (size_t)ch * view->channel_stride;
+                dst[(size_t)ch * out.channel_stride] = (float)(s[0] * (1 - frac) + s[fs] * frac);
+            }
+        }
+    }
+}
+
+typedef struct {
+    const AudioView* view;
+    double ratio;
+    const AudioBuffer* output;
+} ResampleTask;
+
+static void resample_task(void* ctx, uint32_t begin, uint32_t end) {
+    const ResampleTask* task = (const ResampleTask*)ctx;
+    resample_view_into(task->view, task->ratio, task->output, begin, end);
+}
+
+// 按输出帧切块重采样
+static void resample_parallel(const AudioView* view, double ratio, const AudioBuffer* output) {
+    ResampleTask task = {view, ratio, output};
+    uint32_t min_frames = PARALLEL_MIN_SAMPLES / (output->num_channels ? output->num_channels : 1);
+    task_pool_run(output->length, parallel_grain(output->length, min_frames), resample_task, &task);
+}
+
+// 分步重采样: 每步计算一段输出帧 (各输出帧只取决于自身位置, 结果与一次性调用相同)
+static void resample_job_step(AudioJob* job, uint32_t begin, uint32_t end) {
+    AudioView view = audio_view_of(&job->inputs[0]);
+    resample_view_into(&view, job->ratio, &job->output, begin, end);
+}
+
+typedef struct {
+    const AudioView* view;
+    uint32_t block_frames;
+    AudioLevel* levels;
+} AnalyzeTask;
+
+// 逐块计算 RMS 与峰值 (所有声道合并统计)
+static void analyze_task(void* ctx, uint32_t begin, uint32_t end) {
+    const AnalyzeTask* task = (const AnalyzeTask*)ctx;
+    const AudioView* view = task->view;
+    for (uint32_t b = begin; b < end; b++) {
+        uint32_t start = b * task->block_frames;
+        uint32_t n = view->length - start < task->block_frames ? view->length - start : task->block_frames;
+        double sum = 0.0;
+        float peak = 0.0f;
+        for (uint16_t ch = 0; ch < view->num_channels; ch++) {
+            if (audio_format_of(view->layout) != AUDIO_SAMPLE_F32) {
+                // 紧凑格式: 按小块展开后统计
+                float block[PIPELINE_BLOCK_FRAMES];
+                for (uint32_t at = 0; at < n; at += PIPELINE_BLOCK_FRAMES) {
+                    uint32_t m = n - at < PIPELINE_BLOCK_FRAMES ? n - at : PIPELINE_BLOCK_FRAMES;
+                    audio_view_read(view, ch, start + at, m, block);
+                    for (uint32_t i = 0; i < m; i++) {
+                        sum += (double)block[i] * block[i];
+                        peak = fmaxf(peak, fabsf(block[i]));
+                    }
+                }
+                continue;
+            }
+            const float* src = audio_view_channel(view, ch) + (size_t)start * view->frame_stride;
+            for (uint32_t i = 0; i < n; i++) {
+                float x = src[(size_t)i * view->frame_stride];
+                sum += (double)x * x;
+                peak = fmaxf(peak, fabsf(x));
+            }
+        }
+        size_t count = (size_t)n * view->num_channels;
+        task->levels[b].rms = count ? (float)sqrt(sum / count) : 0.0f;
+        task->levels[b].peak = peak;
+    }
+}
+
+// 单个声道的交叉淡化区域 (连续访问, 可向量化)
+static inline void cross_fade_channel(float* __restrict dst, const float* __restrict src1,
+                                      const float* __restrict src2, uint32_t fade_length) {
+    for (uint32_t i = 0; i < fade_length; i++) {
+        float fade_out = (float)i / fade_length;
+        float fade_in = 1.0f - fade_out;
+        dst[i] = src1[i] * fade_out + src2[i] * fade_in;
+    }
+}
+
+// 立体声: 两个声道在同一循环中共用增益
+static inline void cross_fade_stereo(float* __restrict dst_l, float* __restrict dst_r,
+                                     const float* __restrict src1_l, const float* __restrict src1_r,
+                                     const float* __restrict src2_l, const float* __restrict src2_r,
+                                     uint32_t fade_length) {
+    for (uint32_t i = 0; i < fade_length; i++) {
+        float fade_out = (float)i / fade_length;
+        float fade_in = 1.0f - fade_out;
+        dst_l[i] = src1_l[i] * fade_out + src2_l[i] * fade_in;
+        dst_r[i] = src1_r[i] * fade_out + src2_r[i] * fade_in;
+    }
+}
+
+template <uint16_t CHANNELS>
+static void cross_fade_kernel(const AudioBuffer* buffer1, const AudioBuffer* buffer2, uint32_t fade_length,
+                              uint32_t total_length, float* output) {
+    const uint16_t channels = channel_count<CHANNELS>(buffer1->num_channels);
+    const uint32_t head = buffer1->length - fade_length;
+
+    for (uint16_t ch = 0; ch < channels; ch++) {
+        float* dst = output + (size_t)ch * total_length;
+        const float* src1 = buffer1->data + (size_t)ch * buffer1->length;
+        const float* src2 = buffer2->data + (size_t)ch * buffer2->length;
+
+        // buffer1 的非淡出部分 / buffer2 的非淡入部分
+        memcpy(dst, src1, head * sizeof(float));
+        memcpy(dst + buffer1->length, src2 + fade_length, (buffer2->length - fade_length) * sizeof(float));
+        if (CHANNELS != 2) cross_fade_channel(dst + head, src1 + head, src2, fade_length);
+    }
+
+    // 交叉淡化区域
+    if (CHANNELS == 2) {
+        cross_fade_stereo(output + head, output + total_length + head,
+                          buffer1->data + head, buffer1->data + buffer1->length + head,
+                          buffer2->data, buffer2->data + buffer2->length, fade_length);
+    }
+}
+
+// 交错布局的交叉淡化: 首尾整块复制, 过渡区逐帧处理所有声道
+template <uint16_t CHANNELS>
+static void cross_fade_interleaved_kernel(const AudioBuffer* buffer1, const AudioBuffer* buffer2,
+                                          uint32_t fade_length, uint32_t total_length, float* output) {
+    (void)total_length;
+    const uint16_t channels = channel_count<CHANNELS>(buffer1->num_channels);
+    const size_t head = (size_t)(buffer1->length - fade_length) * channels;
+    const size_t fade = (size_t)fade_length * channels;
+    const float* __restrict src1 = buffer1->data + head;
+    const float* __restrict src2 = buffer2->data;
+    float* __restrict dst = output + head;
+
+    memcpy(output, buffer1->data, head * sizeof(float));
+    for (uint32_t i = 0; i < fade_length; i++) {
+        float fade_out = (float)i / fade_length;
+        float fade_in = 1.0f - fade_out;
+        for (uint16_t ch = 0; ch < channels; ch++) {
+            size_t k = (size_t)i * channels + ch;
+            dst[k] = src1[k] * fade_out + src2[k] * fade_in;
+        }
+    }
+    memcpy(dst + fade, src2 + fade, ((size_t)buffer2->length * channels - fade) * sizeof(float));
+}
+
+// 两个输入布局不同时的交叉淡化: 按视图读取, 按 out 的布局写入
+static void cross_fade_views(const AudioView* view1, const AudioView* view2, uint32_t fade_length,
+                             const AudioView* out) {
+    const uint32_t head = view1->length - fade_length;
+    AudioView part = *view1;
+    part.length = head;
+    copy_view(&part, view_write_ptr(out, 0), out->channel_stride, out->frame_stride);
+    part = *view2;
+    part.offset += fade_length;
+    part.length = view2->length - fade_length;
+    copy_view(&part, view_write_ptr(out, 0) + (size_t)view1->length * out->frame_stride,
+              out->channel_stride, out->frame_stride);
+
+    for (uint16_t ch = 0; ch < view1->num_channels; ch++) {
+        const float* src1 = audio_view_channel(view1, ch) + (size_t)head * view1->frame_stride;
+        const float* src2 = audio_view_channel(view2, ch);
+        float* dst = view_write_ptr(out, ch) + (size_t)head * out->frame_stride;
+        for (uint32_t i = 0; i < fade_length; i++) {
+            float fade_out = (float)i / fade_length;
+            float fade_in = 1.0f - fade_out;
+            dst[(size_t)i * out->frame_stride] = src1[(size_t)i * view1->frame_stride] * fade_out +
+                                                 src2[(size_t)i * view2->frame_stride] * fade_in;
+        }
+    }
+}
+
+// 参考音频预处理 (wasm_prepare_reference) 用: 10 ms 一帧计算能量, 裁剪静音时前后各保留 2 帧
+#define REFERENCE_FRAMES_PER_SECOND 100
+#define REFERENCE_PAD_FRAMES 2
+
+typedef struct {
+    uint32_t start;
+    uint32_t length;
+} SampleRange;
+
+// 降采样前的抗混叠低通 (线性插值本身不限制带宽, 48k -> 22.05k 时 11 ~ 24 kHz 的成分会折叠回可听频段):
+// Blackman 窗 sinc, 截止频率为目标采样率的 0.42 (过渡带落在目标 Nyquist 以下), 每侧 16 个过零点
+#define REFERENCE_LOWPASS_CUTOFF 0.42
+#define REFERENCE_LOWPASS_ZEROS 16
+#define REFERENCE_LOWPASS_MAX_HALF 512
+
+typedef struct {
+    const float* src;
+    uint32_t length;
+    const float* taps;      // 2 * half + 1 个, 和为 1
+    uint32_t half;
+    float* dst;
+} LowpassTask;
+
+// FIR 卷积第 [begin, end) 个样本, 两端以外按 0 处理
+static void lowpass_task(void* ctx, uint32_t begin, uint32_t end) {
+    const LowpassTask* task = (const LowpassTask*)ctx;
+    const uint32_t half = task->half;
+    for (uint32_t i = begin; i < end; i++) {
+        uint32_t lo = i < half ? half - i : 0;
+        uint32_t hi = task->length - 1 - i < half ? half + (task->length - 1 - i) : 2 * half;
+        const float* src = task->src + (i + lo - half);
+        float sum = 0.0f;
+        for (uint32_t k = lo; k <= hi; k++) sum += task->taps[k] * src[k - lo];
+        task->dst[i] = sum;
+    }
+}
+
+// 对 ratio < 1 的重采样先做低通, 结果写入 dst (与 src 等长); 失败返回 false
+static bool lowpass_for_resample(const float* src, uint32_t length, double ratio, float* dst) {
+    const double cutoff = REFERENCE_LOWPASS_CUTOFF * ratio;     // 相对源采样率
+    uint32_t half = (uint32_t)ceil(REFERENCE_LOWPASS_ZEROS / (2.0 * cutoff));
+    if (half > REFERENCE_LOWPASS_MAX_HALF) half = REFERENCE_LOWPASS_MAX_HALF;
+
+    float* taps = (float*)malloc((2 * (size_t)half + 1) * sizeof(float));
+    if (!taps) return false;
+    double sum = 0.0;
+    for (uint32_t k = 0; k <= 2 * half; k++) {
+        double n = (double)k - half;
+        double x = 2.0 * M_PI * cutoff * n;
+        double sinc = n == 0 ? 1.0 : sin(x) / x;
+        double window = 0.42 + 0.5 * cos(M_PI * n / half) + 0.08 * cos(2.0 * M_PI * n / half);
+        taps[k] = (float)(sinc * window);
+        sum += taps[k];
+    }
+    for (uint32_t k = 0; k <= 2 * half; k++) taps[k] = (float)(taps[k] / sum);
+
+    LowpassTask task = {src, length, taps, half, dst};
+    task_pool_run(length, parallel_grain(length, PARALLEL_MIN_SAMPLES), lowpass_task, &task);
+    free(taps);
+    return true;
+}
+
+// 下混为单声道 (各声道平均), 任一布局 / 样本格式按块读取
+static void downmix_mono(const AudioView* view, float* mono) {
+    float block[PIPELINE_BLOCK_FRAMES];
+    const float scale = 1.0f / view->num_channels;
+    for (uint32_t offset = 0; offset < view->length; offset += PIPELINE_BLOCK_FRAMES) {
+        uint32_t n = view->length - offset < PIPELINE_BLOCK_FRAMES ? view->length - offset : PIPELINE_BLOCK_FRAMES;
+        float* dst = mono + offset;
+        audio_view_read(view, 0, offset, n, dst);
+        for (uint16_t ch = 1; ch < view->num_channels; ch++) {
+            audio_view_read(view, ch, offset, n, block);
+            for (uint32_t i = 0; i < n; i++) dst[i] += block[i];
+        }
+        if (view->num_channels > 1) {
+            for (uint32_t i = 0; i < n; i++) dst[i] *= scale;
+        }
+    }
+}
+
+// 选出参考音频的有效范围: 按帧 RMS 裁掉首尾静音 (低于最响帧 silence_db), 仍超过 max_seconds 时
+// 取有声帧 RMS 之和最大的 max_seconds 窗口 (滑动窗口, 一遍扫描); 全部静音时从头截取
+static SampleRange select_reference_range(const float* x, uint32_t length, uint32_t sample_rate,
+                                          float max_seconds, float silence_db) {
+    const uint32_t frame = sample_rate / REFERENCE_FRAMES_PER_SECOND ? sample_rate / REFERENCE_FRAMES_PER_SECOND : 1;
+    const uint32_t frames = (length + frame - 1) / frame;
+    uint32_t window = max_seconds > 0 ? (uint32_t)(max_seconds * REFERENCE_FRAMES_PER_SECOND) : frames;
+    if (window == 0) window = 1;
+    SampleRange range = {0, length};
+
+    float* rms = (float*)malloc((size_t)frames * sizeof(float) + 1);
+    if (!rms) return range;
+
+    float peak = 0.0f;
+    for (uint32_t f = 0; f < frames; f++) {
+        uint32_t begin = f * frame;
+        uint32_t n = length - begin < frame ? length - begin : frame;
+        double sum = 0.0;
+        for (uint32_t i = 0; i < n; i++) sum += (double)x[begin + i] * x[begin + i];
+        rms[f] = (float)sqrt(sum / n);
+        if (rms[f] > peak) peak = rms[f];
+    }
+
+    const float threshold = peak * powf(10.0f, silence_db / 20.0f);
+    uint32_t first = 0, last = frames;
+    for (uint32_t f = 0; f < frames; f++) {
+        if (rms[f] > 0.0f && rms[f] >= threshold) {
+            if (last == frames) first = f;
+            last = f;
+        }
+    }
+
+    if (last == frames) {
+        // 全部静音
+        first = 0;
+        last = frames - 1;
+    } else {
+        first = first > REFERENCE_PAD_FRAMES ? first - REFERENCE_PAD_FRAMES : 0;
+        last = last + REFERENCE_PAD_FRAMES < frames ? last + REFERENCE_PAD_FRAMES : frames - 1;
+    }
+
+    uint32_t best = first;
+    const uint32_t span = last - first + 1;
+    if (window < span) {
+        // 滑动窗口: 只累计有声帧的 RMS, 静音段不会因为底噪被选中
+        double sum = 0.0, best_sum = -1.0;
+        for (uint32_t f = first; f <= last; f++) {
+            sum += rms[f] >= threshold ? rms[f] : 0.0f;
+            if (f >= first + window) {
+                uint32_t out = f - window;
+                sum -= rms[out] >= threshold ? rms[out] : 0.0f;
+            }
+            if (f + 1 >= first + window && sum > best_sum) {
+                best_sum = sum;
+                best = f + 1 - window;
+            }
+        }
+    } else {
+        window = span;
+    }
+    free(rms);
+
+    range.start = best * frame;
+    uint32_t end = (best + window) * frame;
+    range.length = (end < length ? end : length) - range.start;
+    return range;
+}
+
+extern "C" {
+
+// 音频重采样 (简单的线性插值)
+// 输入: 源buffer (任一样本格式), 目标采样率
+// 输出: 重采样后的数据 (布局与源相同, float32)
+WASM_EXPORT uint32_t wasm_resample_audio(
+    AudioBuffer* source,
+    uint32_t target_sample_rate,
+    AudioBuffer* output
+) {
+    CALL_SCOPE(FUNC_RESAMPLE_AUDIO);
+
+    if (source->sample_rate == target_sample_rate) {
+        // 采样率相同，直接复制
+        return source->length;
+    }
+
+    // 紧凑格式先展开 (插值需要随机访问相邻样本)
+    WidenedBuffer widened(source);
+    if (!widened.ok()) return 0;
+    uint32_t source_bytes = source->length * source->num_channels * buffer_sample_bytes(source);
+    source = &widened.buffer;
+
+    double ratio = (double)target_sample_rate / source->sample_rate;
+    uint32_t target_length = (uint32_t)(source->length * ratio);
+    uint32_t buffer_size = target_length * source->num_channels * sizeof(float);
+
+    if (!ensure_buffer_capacity(buffer_size)) return 0;
+
+    output->data = (float*)g_memory_buffer.buffer;
+    output->length = target_length;
+    output->num_channels = source->num_channels;
+    output->layout = source->layout;
+    output->sample_rate = target_sample_rate;
+
+    // 线性插值重采样
+    AudioView view = audio_view_of(source);
+    resample_parallel(&view, ratio, output);
+
+    g_memory_buffer.size = buffer_size;
+    CALL_IO(source->length, target_length, source_bytes, buffer_size);
+    return target_length;
+}
+
+// 分步重采样 - 与 wasm_resample_audio 相同的线性插值和输出长度 (布局与源相同)
+// 输入: 源 buffer 描述符 (data 忽略, 必须为 float32: 插值随机访问相邻样本, 紧凑格式由 JS 展开后写入), 目标采样率
+// 输出: 任务指针, 参数无效或内存不足时返回 NULL
+WASM_EXPORT AudioJob* wasm_job_resample_begin(const AudioBuffer* source, uint32_t target_sample_rate) {
+    if (audio_format_of(source->layout) != AUDIO_SAMPLE_F32 || source->sample_rate == 0 || target_sample_rate == 0) {
+        return NULL;
+    }
+
+    double ratio = (double)target_sample_rate / source->sample_rate;
+    AudioBuffer output = *source;
+    output.length = (uint32_t)(source->length * ratio);
+    output.sample_rate = target_sample_rate;
+
+    AudioJob* job = audio_job_create(resample_job_step, source, 1, &output);
+    if (job) job->ratio = ratio;
+    return job;
+}
+
+// 音音量调整
+// 输入: buffer, 音量倍数 (逐样本处理, 与布局无关; 紧凑格式原地处理, 格式不变)
+WASM_EXPORT void wasm_adjust_volume(AudioBuffer* buffer, float volume) {
+    CALL_SCOPE(FUNC_ADJUST_VOLUME);
+
+    uint32_t total_samples = buffer->length * buffer->num_channels;
+    uint16_t format = audio_format_of(buffer->layout);
+
+    if (format == AUDIO_SAMPLE_S16) {
+        int16_t* data = (int16_t*)buffer->data;
+        for (uint32_t i = 0; i < total_samples; i++) {
+            data[i] = audio_float_to_s16(audio_s16_to_float(data[i]) * volume);
+        }
+    } else if (format == AUDIO_SAMPLE_F16) {
+        uint16_t* data = (uint16_t*)buffer->data;
+        for (uint32_t i = 0; i < total_samples; i++) {
+            float x = audio_f16_to_float(data[i]) * volume;
+            data[i] = audio_float_to_f16(fmaxf(-1.0f, fminf(1.0f, x)));
+        }
+    } else {
+        for (uint32_t i = 0; i < total_samples; i++) {
+            buffer->data[i] = fmaxf(-1.0f, fminf(1.0f, buffer->data[i] * volume));
+        }
+    }
+
+    uint32_t bytes = total_samples * audio_sample_bytes(format);
+    CALL_IO(buffer->length, buffer->length, bytes, bytes);
+}
+
+// 音频交叉淡入淡出
+// 输入: buffer1, buffer2, 淡入淡出点数 (两者布局 / 样本格式可以不同, 输出布局与 buffer1 相同, float32)
+WASM_EXPORT uint32_t wasm_cross_fade(
+    AudioBuffer* buffer1,
+    AudioBuffer* buffer2,
+    uint32_t fade_length,
+    AudioBuffer* output
+) {
+    CALL_SCOPE(FUNC_CROSS_FADE);
+
+    uint32_t input_bytes = buffer1->length * buffer1->num_channels * buffer_sample_bytes(buffer1) +
+                           buffer2->length * buffer2->num_channels * buffer_sample_bytes(buffer2);
+    WidenedBuffer widened1(buffer1);
+    WidenedBuffer widened2(buffer2);
+    if (!widened1.ok() || !widened2.ok()) return 0;
+    buffer1 = &widened1.buffer;
+    buffer2 = &widened2.buffer;
+
+    uint32_t total_length = buffer1->length + buffer2->length - fade_length;
+    uint16_t num_channels = buffer1->num_channels;
+    uint32_t buffer_size = total_length * num_channels * sizeof(float);
+
+    if (!ensure_buffer_capacity(buffer_size)) return 0;
+
+    output->data = (float*)g_memory_buffer.buffer;
+    output->length = total_length;
+    output->num_channels = num_channels;
+    output->layout = buffer1->layout;
+    output->sample_rate = buffer1->sample_rate;
+
+    // 复制 buffer1 的非淡出部分, 交叉淡入淡出, 复制 buffer2 的非淡入部分
+    uint16_t layout1 = effective_layout(buffer1);
+    uint16_t layout2 = effective_layout(buffer2);
+    if (layout1 == AUDIO_LAYOUT_PLANAR && layout2 == AUDIO_LAYOUT_PLANAR) {
+        DISPATCH_CHANNELS(num_channels, cross_fade_kernel, buffer1, buffer2, fade_length, total_length, output->data);
+    } else if (layout1 == AUDIO_LAYOUT_INTERLEAVED && layout2 == AUDIO_LAYOUT_INTERLEAVED) {
+        DISPATCH_CHANNELS(num_channels, cross_fade_interleaved_kernel, buffer1, buffer2, fade_length, total_length,
+                          output->data);
+    } else {
+        AudioView view1 = audio_view_of(buffer1);
+        AudioView view2 = audio_view_of(buffer2);
+        AudioView out = audio_view_of(output);
+        cross_fade_views(&view1, &view2, fade_length, &out);
+    }
+
+    g_memory_buffer.size = buffer_size;
+    CALL_IO(buffer1->length + buffer2->length, total_length, input_bytes, buffer_size);
+    return total_length;
+}
+
+// 按视图重采样 (与 wasm_resample_audio 相同的线性插值, 直接读取源数据)
+// 采样率相同时等价于物化
+WASM_EXPORT uint32_t wasm_resample_view(AudioView* view, uint32_t target_sample_rate, AudioBuffer* output) {
+    if (view->sample_rate == target_sample_rate) {
+        return wasm_view_materialize(view, output);
+    }
+
+    CALL_SCOPE(FUNC_RESAMPLE_VIEW);
+
+    // 紧凑格式时只展开视图覆盖的帧; 副本不在 g_memory_buffer 中, 输出不受源位置限制
+    uint32_t source_bytes = view->length * view->num_channels * audio_sample_bytes(audio_format_of(view->layout));
+    WidenedView widened(view);
+    if (!widened.ok()) return 0;
+    view = &widened.view;
+
+    double ratio = (double)target_sample_rate / view->sample_rate;
+    uint32_t target_length = (uint32_t)(view->length * ratio);
+    uint32_t buffer_size = target_length * view->num_channels * sizeof(float);
+
+    if (!prepare_output_for_view(view, buffer_size)) return 0;
+
+    output->data = (float*)g_memory_buffer.buffer;
+    output->length = target_length;
+    output->num_channels = view->num_channels;
+    output->layout = audio_layout_of(view->layout);
+    output->sample_rate = target_sample_rate;
+
+    resample_parallel(view, ratio, output);
+
+    g_memory_buffer.size = buffer_size;
+    CALL_IO(view->length, target_length, source_bytes, buffer_size);
+    return target_length;
+}
+
+// 融合流水线 (见 audio_pipeline.h): 一遍完成多个处理步骤, 不产生中间缓冲区
+// 输入可以是任一布局 / 样本格式的 AudioBuffer (按块展开读取), 声道数最多 PIPELINE_MAX_CHANNELS
+
+// 增益 -> 限幅 -> 16 位 WAV (代替 wasm_adjust_volume + wasm_audio_buffer_to_wav 两遍处理)
+// 输出: WAV数据 (存储在g_memory_buffer中)
+WASM_EXPORT uint32_t wasm_gain_to_wav(AudioBuffer* source, float gain) {
+    CALL_SCOPE(FUNC_GAIN_TO_WAV);
+    using namespace audio_pipeline;
+
+    uint32_t total;
+    if (!run_to_wav(source, Gain(gain) | Limit(), &total)) return 0;
+
+    CALL_IO(source->length, source->length, source->length * source->num_channels * buffer_sample_bytes(source), total);
+    return total;
+}
+
+// 增益 -> 高通 -> 限幅 -> 16 位 WAV
+// highpass_hz: 高通截止频率 (去除直流 / 低频噪声)
+WASM_EXPORT uint32_t wasm_process_to_wav(AudioBuffer* source, float gain, float highpass_hz) {
+    CALL_SCOPE(FUNC_PROCESS_TO_WAV);
+    using namespace audio_pipeline;
+
+    uint32_t total;
+    Biquad highpass = Biquad::highpass(highpass_hz, source->sample_rate);
+    if (!run_to_wav(source, Gain(gain) | highpass | Limit(), &total)) return 0;
+
+    CALL_IO(source->length, source->length, source->length * source->num_channels * buffer_sample_bytes(source), total);
+    return total;
+}
+
+// 增益 -> 高通 -> 限幅, 输出 float
+// 输出: 处理后的数据 (存储在g_memory_buffer中, 布局与源相同, float32), 返回采样点数
+WASM_EXPORT uint32_t wasm_process_audio(
+    AudioBuffer* source,
+    float gain,
+    float highpass_hz,
+    AudioBuffer* output
+) {
+    CALL_SCOPE(FUNC_PROCESS_AUDIO);
+    using namespace audio_pipeline;
+
+    if (source->num_channels > PIPELINE_MAX_CHANNELS) return 0;
+
+    uint32_t buffer_size = source->length * source->num_channels * sizeof(float);
+    if (!ensure_buffer_capacity(buffer_size)) return 0;
+
+    output->data = (float*)g_memory_buffer.buffer;
+    output->length = source->length;
+    output->num_channels = source->num_channels;
+    output->layout = audio_layout_of(source->layout);
+    output->sample_rate = source->sample_rate;
+
+    Biquad highpass = Biquad::highpass(highpass_hz, source->sample_rate);
+    auto chain = Gain(gain) | highpass | Limit() | FloatSink(output->data, output->layout);
+    pipeline_run(chain, source);
+
+    g_memory_buffer.size = buffer_size;
+    CALL_IO(source->length, source->length, source->length * source->num_channels * buffer_sample_bytes(source),
+            buffer_size);
+    return source->length;
+}
+
+// 电平分析 - 每 block_frames 帧计算一次 RMS 和峰值 (所有声道合并), 用于响度包络 / 静音检测
+// 输入: 任一布局 / 样本格式的buffer, 块长度 (帧)
+// 输出: AudioLevel 数组 (存储在g_memory_buffer中), 返回块数
+WASM_EXPORT uint32_t wasm_analyze_audio(AudioBuffer* source, uint32_t block_frames) {
+    CALL_SCOPE(FUNC_ANALYZE_AUDIO);
+
+    if (block_frames == 0) return 0;
+    uint32_t num_blocks = (source->length + block_frames - 1) / block_frames;
+    uint32_t buffer_size = num_blocks * sizeof(AudioLevel);
+
+    AudioView view = audio_view_of(source);
+    if (!prepare_output_for_view(&view, buffer_size)) return 0;
+
+    AnalyzeTask task = {&view, block_frames, (AudioLevel*)g_memory_buffer.buffer};
+    uint32_t block_samples = block_frames * source->num_channels;
+    uint32_t min_blocks = block_samples ? PARALLEL_MIN_SAMPLES / block_samples : 1;
+    task_pool_run(num_blocks, parallel_grain(num_blocks, min_blocks), analyze_task, &task);
+
+    g_memory_buffer.size = buffer_size;
+    CALL_IO(source->length, num_blocks, source->length * source->num_channels * buffer_sample_bytes(source),
+            buffer_size);
+    return num_blocks;
+}
+
+// 参考音频预处理 - 下混为单声道 -> 重采样到 target_sample_rate (降采样时先低通) -> 裁剪首尾静音 -> 截取有声帧 RMS 之和最大的 max_seconds
+// 输入: 任一布局 / 样本格式的buffer, 目标采样率, 最长时长 (秒, <= 0 不截取), 静音阈值 (相对最响帧的 dB, 如 -40)
+// 输出: 单声道 float32 数据 (存储在g_memory_buffer中), 返回采样点数
+WASM_EXPORT uint32_t wasm_prepare_reference(
+    AudioBuffer* source,
+    uint32_t target_sample_rate,
+    float max_seconds,
+    float silence_db,
+    AudioBuffer* output
+) {
+    CALL_SCOPE(FUNC_PREPARE_REFERENCE);
+
+    if (source->length == 0 || source->num_channels == 0 || target_sample_rate == 0) return 0;
+
+    // 源数据可能就在 g_memory_buffer 中 (解码结果), 先下混到临时缓冲区
+    AudioView view = audio_view_of(source);
+    uint32_t length = source->length;
+    float* mono = (float*)malloc((size_t)length * sizeof(float));
+    if (!mono) return 0;
+    downmix_mono(&view, mono);
+
+    if (source->sample_rate != target_sample_rate) {
+        double ratio = (double)target_sample_rate / source->sample_rate;
+        uint32_t target_length = (uint32_t)(length * ratio);
+        float* resampled = (float*)malloc((size_t)target_length * sizeof(float) + 1);
+        if (!resampled) {
+            free(mono);
+            return 0;
+        }
+        if (ratio < 1.0) {
+            // 降采样: 先滤掉目标 Nyquist 以上的成分, 避免混叠
+            float* filtered = (float*)malloc((size_t)length * sizeof(float));
+            if (!filtered || !lowpass_for_resample(mono, length, ratio, filtered)) {
+                free(filtered);
+                free(resampled);
+                free(mono);
+                return 0;
+            }
+            free(mono);
+            mono = filtered;
+        }
+        AudioBuffer in = {mono, length, 1, AUDIO_LAYOUT_PLANAR, source->sample_rate};
+        AudioBuffer out = {resampled, target_length, 1, AUDIO_LAYOUT_PLANAR, target_sample_rate};
+        AudioView in_view = audio_view_of(&in);
+        resample_parallel(&in_view, ratio, &out);
+        free(mono);
+        mono = resampled;
+        length = target_length;
+    }
+
+    SampleRange range = {0, 0};
+    if (length > 0) range = select_reference_range(mono, length, target_sample_rate, max_seconds, silence_db);
+    uint32_t buffer_size = range.length * sizeof(float);
+    if (range.length == 0 || !ensure_buffer_capacity(buffer_size)) {
+        free(mono);
+        return 0;
+    }
+
+    memcpy(g_memory_buffer.buffer, mono + range.start, buffer_size);
+    free(mono);
+
+    output->data = (float*)g_memory_buffer.buffer;
+    output->length = range.length;
+    output->num_channels = 1;
+    output->layout = AUDIO_LAYOUT_PLANAR;
+    output->sample_rate = target_sample_rate;
+
+    g_memory_buffer.size = buffer_size;
+    CALL_IO(source->length, range.length, source->length * source->num_channels * buffer_sample_bytes(source),
+            buffer_size);
+    return range.length;
+}
+
+} // extern "C"
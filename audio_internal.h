@@ -0,0 +1,286 @@
+// 音频处理 WASM 模块 - 各源文件共用的内部声明 (不导出给 JS)
+// audio_processor.cpp 为核心, audio_dsp.cpp / audio_speech.cpp 为功能模块 (构建配置见 audio_processor.cpp 开头)
+
+#ifndef AUDIO_INTERNAL_H
+#define AUDIO_INTERNAL_H
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "audio_processor.h"
+#include "audio_samples.h"
+#include "task_pool.h"
+
+#ifndef __EMSCRIPTEN__
+#include <time.h>
+#endif
+
+// 性能追踪开关: 每个 wasm_* 调用记录一条耗时事件 (编译时 -DAUDIO_TRACE=0 关闭)
+#ifndef AUDIO_TRACE
+#define AUDIO_TRACE 1
+#endif
+
+// 统计计数开关: 调用次数 / 帧数 / 字节数 / 扩容次数 / 耗时 (编译时 -DAUDIO_STATS=1 开启)
+// 关闭时不产生任何代码和数据, wasm_get_stats 返回 NULL
+#ifndef AUDIO_STATS
+#define AUDIO_STATS 0
+#endif
+
+// 导出的 DSP 函数编号 (与 JS 侧 perf_trace.js 中的 WASM_FUNC_NAMES 顺序一致)
+enum AudioFunc {
+    FUNC_AUDIO_BUFFER_TO_WAV = 0,
+    FUNC_WAV_TO_AUDIO_BUFFER,
+    FUNC_SLICE_AUDIO,
+    FUNC_MERGE_AUDIO_BUFFERS,
+    FUNC_RESAMPLE_AUDIO,
+    FUNC_ADJUST_VOLUME,
+    FUNC_CROSS_FADE,
+    FUNC_GENERATE_SPEECH,
+    FUNC_GAIN_TO_WAV,
+    FUNC_PROCESS_TO_WAV,
+    FUNC_PROCESS_AUDIO,
+    FUNC_VIEW_TO_WAV,
+    FUNC_VIEW_MATERIALIZE,
+    FUNC_RESAMPLE_VIEW,
+    FUNC_ANALYZE_AUDIO,
+    FUNC_ENCODE_SEGMENTS,
+    FUNC_SLICE_SEGMENTS,
+    FUNC_CONVERT_SAMPLES,
+    FUNC_PREPARE_REFERENCE,
+    FUNC_JOB_STEP,
+    FUNC_COUNT
+};
+
+// 当前时间 (毫秒)
+static inline double audio_now_ms() {
+#ifdef __EMSCRIPTEN__
+    return emscripten_get_now();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+#endif
+}
+
+#if AUDIO_TRACE
+typedef struct {
+    uint32_t func_id;       // AudioFunc
+    uint32_t frames;        // 处理的采样点数
+    double start_ms;        // 开始时间 (与 performance.now() 同一时钟)
+    double end_ms;          // 结束时间
+} TraceEvent;
+
+#define TRACE_RING_SIZE 1024
+
+extern TraceEvent g_trace_events[TRACE_RING_SIZE];
+extern uint32_t g_trace_count;
+#endif
+
+#if AUDIO_STATS
+// 单个导出函数的统计 (frames/bytes 用 double 存储, JS 侧可直接读取, 2^53 内精确)
+typedef struct {
+    uint32_t calls;         // 调用次数
+    uint32_t grow_events;   // 缓冲区扩容次数
+    double input_frames;    // 输入采样点数累计
+    double output_frames;   // 输出采样点数累计
+    double bytes_in;        // 读取字节数累计
+    double bytes_out;       // 写入字节数累计
+    double total_ms;        // 累计耗时
+} __attribute__((packed)) FuncStats;
+
+// 统计快照 (wasm_get_stats 返回该结构体指针)
+typedef struct {
+    uint32_t version;       // 结构体版本, 布局变化时递增
+    uint32_t func_count;    // funcs 数组长度
+    uint32_t grow_events;   // 全部扩容次数
+    uint32_t peak_capacity; // g_memory_buffer 峰值容量
+    FuncStats funcs[FUNC_COUNT];
+} __attribute__((packed)) AudioStats;
+
+extern AudioStats g_stats;
+extern int32_t g_stats_current;
+#endif
+
+#if AUDIO_TRACE || AUDIO_STATS
+// 作用域计时: 构造时记录开始, 析构时写入追踪事件 / 累计统计
+struct CallScope {
+    uint32_t func_id;
+    uint32_t in_frames;
+    double start_ms;
+
+    CallScope(uint32_t id) : func_id(id), in_frames(0), start_ms(audio_now_ms()) {
+#if AUDIO_STATS
+        g_stats.funcs[id].calls++;
+        g_stats_current = (int32_t)id;
+#endif
+    }
+
+    // 记录本次调用的输入/输出量
+    void io(uint32_t input_frames, uint32_t output_frames, uint32_t bytes_in, uint32_t bytes_out) {
+        in_frames = input_frames;
+#if AUDIO_STATS
+        FuncStats* st = &g_stats.funcs[func_id];
+        st->input_frames += input_frames;
+        st->output_frames += output_frames;
+        st->bytes_in += bytes_in;
+        st->bytes_out += bytes_out;
+#else
+        (void)output_frames; (void)bytes_in; (void)bytes_out;
+#endif
+    }
+
+    ~CallScope() {
+        double end_ms = audio_now_ms();
+#if AUDIO_TRACE
+        TraceEvent* ev = &g_trace_events[g_trace_count % TRACE_RING_SIZE];
+        ev->func_id = func_id;
+        ev->frames = in_frames;
+        ev->start_ms = start_ms;
+        ev->end_ms = end_ms;
+        g_trace_count++;
+#endif
+#if AUDIO_STATS
+        g_stats.funcs[func_id].total_ms += end_ms - start_ms;
+        g_stats_current = -1;
+#endif
+    }
+};
+#define CALL_SCOPE(id) CallScope call_scope_(id)
+#define CALL_IO(in_frames, out_frames, bytes_in, bytes_out) \
+    call_scope_.io(in_frames, out_frames, bytes_in, bytes_out)
+#else
+#define CALL_SCOPE(id) ((void)0)
+#define CALL_IO(in_frames, out_frames, bytes_in, bytes_out) ((void)0)
+#endif
+
+// ---- 核心 (audio_processor.cpp) 中实现, 各功能模块共用 ----
+
+// 确保 g_memory_buffer 至少有 size 字节, 不够时 realloc; 返回 0 表示分配失败
+int ensure_buffer_capacity(uint32_t size);
+
+// 填充 PCM WAV 文件头
+void write_wav_header(WAVHeader* header, uint16_t num_channels, uint32_t sample_rate,
+                      uint16_t bits_per_sample, uint32_t data_size);
+
+// 准备向 g_memory_buffer 写入 output_size 字节的输出 (视图数据位于 g_memory_buffer 中时不覆盖、不 realloc)
+// 返回 0 表示无法安全写入
+int prepare_output_for_view(const AudioView* view, uint32_t output_size);
+
+// 把 src 的全部帧复制到 dst 指向的区域 (dst 为目标声道 0 第 0 帧, 步长含义同 AudioView)
+// 目标与 src 的样本格式相同, 按样本原样复制
+void copy_view(const AudioView* src, void* dst, uint32_t dst_channel_stride, uint32_t dst_frame_stride);
+
+// 连续的 count 个样本从 from 格式转换为 to 格式 (两者相同时直接复制)
+void convert_samples(const void* src, uint16_t from, void* dst, uint16_t to, size_t count);
+
+// 紧凑格式的输入在处理前展开为 float32 (malloc 的临时副本, 布局不变), float32 输入直接使用原数据
+// 用于需要随机访问样本的内核 (重采样 / 交叉淡化); 按块顺序读取的内核用 audio_view_read, 不需要副本
+struct WidenedBuffer {
+    AudioBuffer buffer;
+    float* owned;
+
+    explicit WidenedBuffer(const AudioBuffer* source) : buffer(*source), owned(NULL) {
+        uint16_t format = audio_format_of(source->layout);
+        if (format == AUDIO_SAMPLE_F32) return;
+        size_t count = (size_t)source->length * source->num_channels;
+        owned = (float*)malloc(count * sizeof(float) + 1);
+        if (!owned) return;
+        convert_samples(source->data, format, owned, AUDIO_SAMPLE_F32, count);
+        buffer.data = owned;
+        buffer.layout = audio_layout_of(source->layout);
+    }
+
+    ~WidenedBuffer() { free(owned); }
+
+    // 展开失败 (内存不足) 时返回 0
+    int ok() const { return audio_format_of(buffer.layout) == AUDIO_SAMPLE_F32; }
+};
+
+// 视图的 float32 副本 (紧凑格式时只复制视图覆盖的帧, 平面布局)
+struct WidenedView {
+    AudioView view;
+    float* owned;
+
+    explicit WidenedView(const AudioView* source) : view(*source), owned(NULL) {
+        if (audio_format_of(source->layout) == AUDIO_SAMPLE_F32) return;
+        owned = (float*)malloc((size_t)source->length * source->num_channels * sizeof(float) + 1);
+        if (!owned) return;
+        for (uint16_t ch = 0; ch < source->num_channels; ch++) {
+            audio_view_read(source, ch, 0, source->length, owned + (size_t)ch * source->length);
+        }
+        view.base = owned;
+        view.offset = 0;
+        view.layout = AUDIO_LAYOUT_PLANAR;
+        view.channel_stride = source->length;
+        view.frame_stride = 1;
+    }
+
+    ~WidenedView() { free(owned); }
+
+    int ok() const { return audio_format_of(view.layout) == AUDIO_SAMPLE_F32; }
+};
+
+// 分步任务 (wasm_job_*): 长操作拆成多步, 每步处理一批输出帧后返回, JS 在两步之间让出主线程
+// 输入和输出都在任务自己 malloc 的内存中, 不使用 g_memory_buffer, 两步之间可以调用其他导出函数
+typedef void (*AudioJobStep)(AudioJob* job, uint32_t begin, uint32_t end);
+
+struct AudioJob {
+    AudioJobStep step;          // 计算输出的第 [begin, end) 帧 (按顺序调用, 不会跳过)
+    uint32_t position;          // 已完成的输出帧数
+    uint32_t num_inputs;
+    AudioBuffer* inputs;        // 输入描述符, data 指向 input_data 中 (由 JS 写入)
+    uint8_t* input_data;
+    AudioBuffer output;         // data 为任务自己的内存
+    double ratio;               // 重采样: 目标 / 源采样率
+    uint32_t cursor;            // 合并: 当前输入段
+    uint32_t cursor_start;      // 合并: 当前输入段的第 0 帧在输出中的位置
+};
+
+// 创建分步任务: inputs / output 只取长度、声道、布局和采样率 (data 忽略), 为两者分配内存
+// 分配失败返回 NULL
+AudioJob* audio_job_create(AudioJobStep step, const AudioBuffer* inputs, uint32_t num_inputs,
+                           const AudioBuffer* output);
+
+// 单声道时两种布局相同, 统一视为平面布局 (不含样本格式)
+static inline uint16_t effective_layout(const AudioBuffer* buffer) {
+    return buffer->num_channels > 1 && audio_layout_of(buffer->layout) == AUDIO_LAYOUT_INTERLEAVED
+               ? AUDIO_LAYOUT_INTERLEAVED
+               : AUDIO_LAYOUT_PLANAR;
+}
+
+// 每个样本的字节数
+static inline uint32_t buffer_sample_bytes(const AudioBuffer* buffer) {
+    return audio_sample_bytes(audio_format_of(buffer->layout));
+}
+
+// 输出缓冲区 (g_memory_buffer 中, 可写) 的视图
+static inline float* view_write_ptr(const AudioView* view, uint16_t ch) {
+    return (float*)audio_view_channel(view, ch);
+}
+
+// 按声道数特化的内核: CHANNELS 为 1 / 2 时声道循环在编译期展开, 为 0 时使用运行时声道数 (通用回退)
+// 每个声道的内层循环都是连续访问, 编译器可以向量化
+#define DISPATCH_CHANNELS(num_channels, kernel, ...) \
+    switch (num_channels) { \
+        case 1: kernel<1>(__VA_ARGS__); break; \
+        case 2: kernel<2>(__VA_ARGS__); break; \
+        default: kernel<0>(__VA_ARGS__); break; \
+    }
+
+template <uint16_t CHANNELS>
+static inline uint16_t channel_count(uint16_t runtime_channels) {
+    return CHANNELS ? CHANNELS : runtime_channels;
+}
+
+// 并行处理 (task_pool.h): 按样本数切块, 小输入直接在调用线程上处理, 避免调度开销超过收益
+// 各块互不重叠且结果与切分方式无关, 多线程输出与单线程逐位一致
+#define PARALLEL_MIN_SAMPLES 65536
+
+// 每块的工作项数: 至少 min_items, 并切成线程数的 4 倍左右, 让先完成的线程有块可窃取
+static inline uint32_t parallel_grain(uint32_t count, uint32_t min_items) {
+    uint32_t grain = count / (task_pool_threads() * 4);
+    return grain > min_items ? grain : (min_items ? min_items : 1);
+}
+
+#endif // AUDIO_INTERNAL_H
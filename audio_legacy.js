@@ -0,0 +1,163 @@
+/**
+ * 音频处理 JavaScript 实现 (从页面中提取的 Legacy 版本)
+ * 浏览器中挂到 window，Node 中通过 module.exports 导出，供 bench/bench_node.js 与 WASM 对比
+ *
+ * 输入均为 AudioBuffer 兼容对象: { numberOfChannels, length, sampleRate, getChannelData(ch) }
+ */
+(function(root) {
+    /**
+     * AudioBuffer 编码为 16 位 PCM WAV (最多保留 2 个声道)
+     * @param {AudioBuffer} audioBuffer - 音频缓冲区
+     * @returns {ArrayBuffer} WAV 文件数据
+     */
+    function encodeWavLegacy(audioBuffer) {
+        const numberOfChannels = Math.min(2, audioBuffer.numberOfChannels);
+        const sampleRate = audioBuffer.sampleRate;
+
+        // 获取所有通道数据
+        const channels = [];
+        for (let ch = 0; ch < numberOfChannels; ch++) {
+            channels.push(audioBuffer.getChannelData(ch));
+        }
+
+        // 计算总样本数
+        const length = audioBuffer.length;
+        const audioData = new Float32Array(length * numberOfChannels);
+
+        // 交错通道数据
+        let offset = 0;
+        for (let i = 0; i < length; i++) {
+            for (let ch = 0; ch < numberOfChannels; ch++) {
+                audioData[offset++] = channels[ch][i];
+            }
+        }
+
+        // 转换为 PCM
+        const pcmData = new Int16Array(audioData.length);
+        for (let i = 0; i < audioData.length; i++) {
+            const s = Math.max(-1, Math.min(1, audioData[i]));
+            pcmData[i] = s < 0 ? s * 0x8000 : s * 0x7FFF;
+        }
+
+        // 写 WAV 头
+        const wavBuffer = new ArrayBuffer(44 + pcmData.length * 2);
+        const view = new DataView(wavBuffer);
+
+        const bitDepth = 16;
+        const bytesPerSample = bitDepth / 8;
+        const blockAlign = numberOfChannels * bytesPerSample;
+        const byteRate = sampleRate * blockAlign;
+        const subChunk2Size = pcmData.length * 2;
+
+        // RIFF 头
+        const writeString = (offset, string) => {
+            for (let i = 0; i < string.length; i++) {
+                view.setUint8(offset + i, string.charCodeAt(i));
+            }
+        };
+
+        writeString(0, 'RIFF');
+        view.setUint32(4, 36 + subChunk2Size, true);
+        writeString(8, 'WAVE');
+
+        // fmt 子块
+        writeString(12, 'fmt ');
+        view.setUint32(16, 16, true);
+        view.setUint16(20, 1, true);
+        view.setUint16(22, numberOfChannels, true);
+        view.setUint32(24, sampleRate, true);
+        view.setUint32(28, byteRate, true);
+        view.setUint16(32, blockAlign, true);
+        view.setUint16(34, bitDepth, true);
+
+        // data 子块
+        writeString(36, 'data');
+        view.setUint32(40, subChunk2Size, true);
+
+        // 写入 PCM 数据
+        const pcmView = new Int16Array(wavBuffer, 44);
+        pcmView.set(pcmData);
+
+        return wavBuffer;
+    }
+
+    /**
+     * AudioBuffer 转 WAV Blob (Legacy 版本)
+     */
+    function audioBufferToWavLegacy(audioBuffer) {
+        return new Blob([encodeWavLegacy(audioBuffer)], { type: 'audio/wav' });
+    }
+
+    /**
+     * 逐样本复制 [startSample, startSample + target.length) 到 target (Legacy 切分使用)
+     * @param {AudioBuffer} source - 源缓冲区
+     * @param {AudioBuffer} target - 目标缓冲区 (声道数与源相同)
+     * @param {number} startSample - 起始采样点
+     */
+    function copySegmentLegacy(source, target, startSample) {
+        for (let channel = 0; channel < source.numberOfChannels; channel++) {
+            const channelData = source.getChannelData(channel);
+            const segmentData = target.getChannelData(channel);
+            for (let j = 0; j < segmentData.length; j++) {
+                segmentData[j] = channelData[startSample + j];
+            }
+        }
+    }
+
+    /**
+     * 用 TypedArray.set 复制片段 (WASM 包装器中的 JS 切分使用)
+     */
+    function copySegmentTyped(source, target, startSample) {
+        for (let ch = 0; ch < source.numberOfChannels; ch++) {
+            const sourceData = source.getChannelData(ch);
+            target.getChannelData(ch).set(sourceData.subarray(startSample, startSample + target.length));
+        }
+    }
+
+    /**
+     * 逐样本拼接多个片段到 target (Legacy 合并使用)
+     * @param {AudioBuffer[]} segments - 片段数组
+     * @param {AudioBuffer} target - 目标缓冲区，长度为所有片段之和
+     */
+    function concatSegmentsLegacy(segments, target) {
+        let offset = 0;
+        for (const segment of segments) {
+            for (let channel = 0; channel < segment.numberOfChannels; channel++) {
+                const mergedData = target.getChannelData(channel);
+                const segmentData = segment.getChannelData(channel);
+                for (let i = 0; i < segmentData.length; i++) {
+                    mergedData[offset + i] = segmentData[i];
+                }
+            }
+            offset += segment.length;
+        }
+    }
+
+    /**
+     * 用 TypedArray.set 拼接片段 (WASM 包装器中的 JS 合并使用)
+     */
+    function concatSegmentsTyped(segments, target) {
+        let offset = 0;
+        for (const segment of segments) {
+            for (let ch = 0; ch < segment.numberOfChannels; ch++) {
+                target.getChannelData(ch).set(segment.getChannelData(ch), offset);
+            }
+            offset += segment.length;
+        }
+    }
+
+    const api = {
+        encodeWavLegacy,
+        audioBufferToWavLegacy,
+        copySegmentLegacy,
+        copySegmentTyped,
+        concatSegmentsLegacy,
+        concatSegmentsTyped
+    };
+
+    if (typeof module !== 'undefined' && module.exports) {
+        module.exports = api;
+    } else {
+        Object.assign(root, api);
+    }
+})(typeof window !== 'undefined' ? window : globalThis);
@@ -0,0 +1,220 @@
+// 音频客观质量指标实现
+// 全部在 double 精度下累计, 输入为单声道连续数据 (平面布局的多声道可按声道分别调用或整体传入)
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "audio_metrics.h"
+
+static const double kEnergyFloor = 1e-20;
+
+static inline double clamp_db(double db) {
+    if (db > METRIC_MAX_DB) return METRIC_MAX_DB;
+    if (db < -METRIC_MAX_DB) return -METRIC_MAX_DB;
+    return db;
+}
+
+static inline double ratio_db(double signal, double noise) {
+    if (noise <= kEnergyFloor) return signal <= kEnergyFloor ? 0.0 : METRIC_MAX_DB;
+    if (signal <= kEnergyFloor) return -METRIC_MAX_DB;
+    return clamp_db(10.0 * log10(signal / noise));
+}
+
+extern "C" {
+
+double metric_snr_db(const float* ref, const float* test, size_t n) {
+    double signal = 0.0, noise = 0.0;
+    for (size_t i = 0; i < n; i++) {
+        double e = (double)test[i] - ref[i];
+        signal += (double)ref[i] * ref[i];
+        noise += e * e;
+    }
+    // 两者都为静音时视为完全一致
+    if (noise <= kEnergyFloor) return METRIC_MAX_DB;
+    return ratio_db(signal, noise);
+}
+
+double metric_segmental_snr_db(const float* ref, const float* test, size_t n, uint32_t frame_length) {
+    if (frame_length == 0) return metric_snr_db(ref, test, n);
+
+    double sum = 0.0;
+    size_t frames = 0;
+    for (size_t start = 0; start + frame_length <= n; start += frame_length) {
+        double signal = 0.0, noise = 0.0;
+        for (size_t i = start; i < start + frame_length; i++) {
+            double e = (double)test[i] - ref[i];
+            signal += (double)ref[i] * ref[i];
+            noise += e * e;
+        }
+        // 跳过静音帧 (约 -70 dBFS 以下)
+        if (signal < 1e-7 * frame_length) continue;
+
+        double db = noise <= kEnergyFloor ? 35.0 : 10.0 * log10(signal / noise);
+        if (db > 35.0) db = 35.0;
+        if (db < -10.0) db = -10.0;
+        sum += db;
+        frames++;
+    }
+    return frames ? sum / frames : 35.0;
+}
+
+double metric_max_abs_error(const float* ref, const float* test, size_t n) {
+    double max_err = 0.0;
+    for (size_t i = 0; i < n; i++) {
+        double e = fabs((double)test[i] - ref[i]);
+        if (e > max_err) max_err = e;
+    }
+    return max_err;
+}
+
+// 原地基 2 复数 FFT (re/im 长度为 size, size 为 2 的幂)
+static void fft_radix2(double* re, double* im, uint32_t size) {
+    for (uint32_t i = 1, j = 0; i < size; i++) {
+        uint32_t bit = size >> 1;
+        for (; j & bit; bit >>= 1) j ^= bit;
+        j ^= bit;
+        if (i < j) {
+            double t = re[i]; re[i] = re[j]; re[j] = t;
+            t = im[i]; im[i] = im[j]; im[j] = t;
+        }
+    }
+    for (uint32_t len = 2; len <= size; len <<= 1) {
+        double angle = -2.0 * M_PI / len;
+        double w_re = cos(angle), w_im = sin(angle);
+        for (uint32_t i = 0; i < size; i += len) {
+            double cur_re = 1.0, cur_im = 0.0;
+            for (uint32_t k = 0; k < len / 2; k++) {
+                uint32_t a = i + k, b = i + k + len / 2;
+                double t_re = re[b] * cur_re - im[b] * cur_im;
+                double t_im = re[b] * cur_im + im[b] * cur_re;
+                re[b] = re[a] - t_re;
+                im[b] = im[a] - t_im;
+                re[a] += t_re;
+                im[a] += t_im;
+                double next_re = cur_re * w_re - cur_im * w_im;
+                cur_im = cur_re * w_im + cur_im * w_re;
+                cur_re = next_re;
+            }
+        }
+    }
+}
+
+// 加窗后计算功率谱 (前 size/2+1 个频点), 返回帧能量
+static double power_spectrum(const float* x, const double* window, uint32_t size,
+                             double* re, double* im, double* power) {
+    double energy = 0.0;
+    for (uint32_t i = 0; i < size; i++) {
+        re[i] = x[i] * window[i];
+        im[i] = 0.0;
+        energy += re[i] * re[i];
+    }
+    fft_radix2(re, im, size);
+    for (uint32_t k = 0; k <= size / 2; k++) {
+        power[k] = re[k] * re[k] + im[k] * im[k];
+    }
+    return energy;
+}
+
+double metric_spectral_distance_db(const float* ref, const float* test, size_t n,
+                                   uint32_t fft_size, uint32_t max_frames) {
+    if (fft_size < 2 || (fft_size & (fft_size - 1)) != 0 || n < fft_size) return 0.0;
+
+    size_t total_frames = n / fft_size;
+    size_t step = 1;
+    if (max_frames > 0 && total_frames > max_frames) step = total_frames / max_frames;
+
+    double* window = (double*)malloc(fft_size * sizeof(double));
+    double* re = (double*)malloc(fft_size * sizeof(double));
+    double* im = (double*)malloc(fft_size * sizeof(double));
+    double* p_ref = (double*)malloc((fft_size / 2 + 1) * sizeof(double));
+    double* p_test = (double*)malloc((fft_size / 2 + 1) * sizeof(double));
+    for (uint32_t i = 0; i < fft_size; i++) {
+        window[i] = 0.5 - 0.5 * cos(2.0 * M_PI * i / fft_size);
+    }
+
+    // 静音帧门限 (约 -100 dBFS); 帧内谱底取最大频点以下 60 dB, 避免低能量频点的微小误差主导距离
+    const double silence = 1e-10 * fft_size;
+    double sum = 0.0;
+    size_t frames = 0;
+    for (size_t f = 0; f < total_frames; f += step) {
+        const float* a = ref + f * fft_size;
+        const float* b = test + f * fft_size;
+        double e_ref = power_spectrum(a, window, fft_size, re, im, p_ref);
+        double e_test = power_spectrum(b, window, fft_size, re, im, p_test);
+        if (e_ref < silence && e_test < silence) continue;
+
+        double floor = 0.0;
+        for (uint32_t k = 0; k <= fft_size / 2; k++) {
+            if (p_ref[k] > floor) floor = p_ref[k];
+            if (p_test[k] > floor) floor = p_test[k];
+        }
+        floor *= 1e-6;
+
+        double acc = 0.0;
+        for (uint32_t k = 0; k <= fft_size / 2; k++) {
+            double d = 10.0 * log10((p_ref[k] + floor) / (p_test[k] + floor));
+            acc += d * d;
+        }
+        sum += sqrt(acc / (fft_size / 2 + 1));
+        frames++;
+    }
+
+    free(window);
+    free(re);
+    free(im);
+    free(p_ref);
+    free(p_test);
+    return frames ? sum / frames : 0.0;
+}
+
+// [start, end) 内二阶差分的平均能量
+static double diff2_energy(const float* x, size_t start, size_t end) {
+    if (start < 2) start = 2;
+    if (end <= start) return 0.0;
+    double sum = 0.0;
+    for (size_t i = start; i < end; i++) {
+        double d = (double)x[i] - 2.0 * x[i - 1] + x[i - 2];
+        sum += d * d;
+    }
+    return sum / (end - start);
+}
+
+double metric_seam_click_db(const float* signal, size_t n, const uint32_t* seams, uint32_t num_seams,
+                            uint32_t sample_rate) {
+    size_t inner = sample_rate / 1000;          // ±1ms
+    size_t outer = sample_rate / 50;            // ±20ms
+    if (inner == 0) inner = 1;
+
+    double worst = -METRIC_MAX_DB;
+    for (uint32_t s = 0; s < num_seams; s++) {
+        size_t seam = seams[s];
+        if (seam >= n) continue;
+
+        size_t in_start = seam > inner ? seam - inner : 0;
+        size_t in_end = seam + inner < n ? seam + inner : n;
+        size_t out_start = seam > outer ? seam - outer : 0;
+        size_t out_end = seam + outer < n ? seam + outer : n;
+
+        double click = diff2_energy(signal, in_start, in_end);
+        // 邻域能量不含接缝窗口本身
+        double before = diff2_energy(signal, out_start, in_start) * (in_start - out_start);
+        double after = diff2_energy(signal, in_end, out_end) * (out_end - in_end);
+        size_t count = (in_start - out_start) + (out_end - in_end);
+        double baseline = count ? (before + after) / count : 0.0;
+
+        double db = ratio_db(click, baseline);
+        if (db > worst) worst = db;
+    }
+    return num_seams ? worst : 0.0;
+}
+
+void metric_compare(const float* ref, const float* test, size_t n, uint32_t sample_rate,
+                    AudioQuality* out) {
+    out->snr_db = metric_snr_db(ref, test, n);
+    out->seg_snr_db = metric_segmental_snr_db(ref, test, n, sample_rate / 50);
+    out->max_abs_err = metric_max_abs_error(ref, test, n);
+    out->spectral_db = metric_spectral_distance_db(ref, test, n, 512, 256);
+}
+
+} // extern "C"
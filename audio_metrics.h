@@ -0,0 +1,46 @@
+// 音频客观质量指标 - 用于验证优化实现与标量参考实现的输出在容差内
+// SNR / 分段 SNR / 最大绝对误差 / 对数谱距离 / 接缝咔嗒能量
+
+#ifndef AUDIO_METRICS_H
+#define AUDIO_METRICS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// dB 指标的上限: 完全一致时 SNR 为无穷大, 统一截断到该值便于输出 JSON
+#define METRIC_MAX_DB 200.0
+
+// 一组对比指标
+typedef struct {
+    double snr_db;          // 信噪比 (参考信号能量 / 误差能量)
+    double seg_snr_db;      // 分段信噪比 (20ms 帧, 每帧截断到 [-10, 35] dB, 跳过静音帧)
+    double max_abs_err;     // 最大绝对误差
+    double spectral_db;     // 对数谱距离 (Hann 窗 512 点 FFT, 帧均值)
+} AudioQuality;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+double metric_snr_db(const float* ref, const float* test, size_t n);
+double metric_segmental_snr_db(const float* ref, const float* test, size_t n, uint32_t frame_length);
+double metric_max_abs_error(const float* ref, const float* test, size_t n);
+
+// 每帧只比较最大频点以下 60 dB 的动态范围; 最多分析 max_frames 帧 (在信号中均匀抽取), 长输入时限制耗时
+double metric_spectral_distance_db(const float* ref, const float* test, size_t n,
+                                   uint32_t fft_size, uint32_t max_frames);
+
+// 接缝咔嗒能量: 接缝 ±1ms 内二阶差分能量相对 ±20ms 邻域的 dB 值, 返回所有接缝中的最大值
+// 数值随信号内容波动 (语音中约 -40 ~ +5 dB), 应与参考实现在同一接缝上的值比较; 不连续会使其升高 10 dB 以上
+double metric_seam_click_db(const float* signal, size_t n, const uint32_t* seams, uint32_t num_seams,
+                            uint32_t sample_rate);
+
+// 计算 AudioQuality 中的全部指标
+void metric_compare(const float* ref, const float* test, size_t n, uint32_t sample_rate,
+                    AudioQuality* out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // AUDIO_METRICS_H
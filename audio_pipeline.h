@@ -0,0 +1,205 @@
+// 融合处理流水线 - 编译期组合多个处理级, 按块单遍处理
+//
+// 分开调用 wasm_adjust_volume / 滤波 / wasm_audio_buffer_to_wav 时, 每一步都完整读写一遍缓冲区;
+// 流水线把各级串成一个类型 (表达式模板), 每次取 PIPELINE_BLOCK_FRAMES 帧放在栈上的小块里,
+// 依次经过所有级再写出, 中间结果始终留在 L1 缓存中, 整条链只读一次输入、写一次输出.
+//
+//   using namespace audio_pipeline;
+//   auto chain = Gain(0.8f) | Biquad::highpass(80.0f, sample_rate) | Limit() | Pcm16Sink(out);
+//   pipeline_run(chain, &source);
+//
+// 每一级提供:
+//   void reset();                                        // 清零内部状态 (无状态的级为空函数)
+//   void process(float* x, uint32_t n, const PipelineBlock& block);   // 原地处理一块
+// 有状态的级按声道分别保存状态 (最多 PIPELINE_MAX_CHANNELS 个声道).
+
+#ifndef AUDIO_PIPELINE_H
+#define AUDIO_PIPELINE_H
+
+#include <math.h>
+#include <string.h>
+
+#include <type_traits>
+
+#include "audio_processor.h"
+#include "audio_samples.h"
+
+#define PIPELINE_BLOCK_FRAMES 512   // 2KB, 远小于 L1
+#define PIPELINE_MAX_CHANNELS 8
+
+namespace audio_pipeline {
+
+// 当前块的位置
+struct PipelineBlock {
+    uint16_t channel;
+    uint16_t num_channels;
+    uint32_t offset;        // 块起点在整段中的帧号
+    uint32_t length;        // 整段帧数
+};
+
+// 所有处理级的基类, 仅用于限定 operator| 的适用范围
+struct Stage {
+    void reset() {}
+};
+
+template <typename T>
+struct is_stage : std::is_base_of<Stage, T> {};
+
+// 两级串联 (左侧先执行)
+template <typename First, typename Second>
+struct Chain : Stage {
+    First first;
+    Second second;
+
+    Chain(const First& a, const Second& b) : first(a), second(b) {}
+
+    void reset() {
+        first.reset();
+        second.reset();
+    }
+
+    inline void process(float* x, uint32_t n, const PipelineBlock& block) {
+        first.process(x, n, block);
+        second.process(x, n, block);
+    }
+};
+
+template <typename A, typename B>
+inline typename std::enable_if<is_stage<A>::value && is_stage<B>::value, Chain<A, B> >::type
+operator|(const A& a, const B& b) {
+    return Chain<A, B>(a, b);
+}
+
+// 增益 (无状态)
+struct Gain : Stage {
+    float gain;
+
+    explicit Gain(float g) : gain(g) {}
+
+    inline void process(float* x, uint32_t n, const PipelineBlock&) {
+        for (uint32_t i = 0; i < n; i++) x[i] *= gain;
+    }
+};
+
+// 硬限幅到 [-ceiling, ceiling] (无状态, 与 wasm_adjust_volume 的钳位一致)
+struct Limit : Stage {
+    float ceiling;
+
+    explicit Limit(float c = 1.0f) : ceiling(c) {}
+
+    inline void process(float* x, uint32_t n, const PipelineBlock&) {
+        for (uint32_t i = 0; i < n; i++) x[i] = fmaxf(-ceiling, fminf(ceiling, x[i]));
+    }
+};
+
+// 二阶 IIR 滤波器 (RBJ 公式, 转置直接 II 型), 每个声道一组状态
+struct Biquad : Stage {
+    float b0, b1, b2, a1, a2;
+    float z1[PIPELINE_MAX_CHANNELS];
+    float z2[PIPELINE_MAX_CHANNELS];
+
+    Biquad(double nb0, double nb1, double nb2, double a0, double na1, double na2)
+        : b0((float)(nb0 / a0)), b1((float)(nb1 / a0)), b2((float)(nb2 / a0)),
+          a1((float)(na1 / a0)), a2((float)(na2 / a0)) {
+        reset();
+    }
+
+    // 高通 (Q = 0.7071, 巴特沃斯), 用于去除直流和低频噪声
+    static Biquad highpass(float cutoff_hz, uint32_t sample_rate) {
+        double w0 = 2.0 * M_PI * cutoff_hz / sample_rate;
+        double cw = cos(w0);
+        double alpha = sin(w0) / (2.0 * 0.70710678118654752);
+        return Biquad((1 + cw) / 2, -(1 + cw), (1 + cw) / 2, 1 + alpha, -2 * cw, 1 - alpha);
+    }
+
+    // 低通 (Q = 0.7071)
+    static Biquad lowpass(float cutoff_hz, uint32_t sample_rate) {
+        double w0 = 2.0 * M_PI * cutoff_hz / sample_rate;
+        double cw = cos(w0);
+        double alpha = sin(w0) / (2.0 * 0.70710678118654752);
+        return Biquad((1 - cw) / 2, 1 - cw, (1 - cw) / 2, 1 + alpha, -2 * cw, 1 - alpha);
+    }
+
+    void reset() {
+        memset(z1, 0, sizeof(z1));
+        memset(z2, 0, sizeof(z2));
+    }
+
+    inline void process(float* x, uint32_t n, const PipelineBlock& block) {
+        float s1 = z1[block.channel], s2 = z2[block.channel];
+        for (uint32_t i = 0; i < n; i++) {
+            float in = x[i];
+            float out = b0 * in + s1;
+            s1 = b1 * in - a1 * out + s2;
+            s2 = b2 * in - a2 * out;
+            x[i] = out;
+        }
+        z1[block.channel] = s1;
+        z2[block.channel] = s2;
+    }
+};
+
+// 输出: 16 位 PCM, 交错布局 (WAV 数据区)
+// 量化方式与 wasm_audio_buffer_to_wav 一致; 输入需已限幅到 [-1, 1]
+struct Pcm16Sink : Stage {
+    int16_t* output;
+
+    explicit Pcm16Sink(int16_t* out) : output(out) {}
+
+    inline void process(float* x, uint32_t n, const PipelineBlock& block) {
+        int16_t* dst = output + (size_t)block.offset * block.num_channels + block.channel;
+        for (uint32_t i = 0; i < n; i++) {
+            float sample = x[i];
+            dst[(size_t)i * block.num_channels] = (int16_t)(sample < 0 ? sample * 0x8000 : sample * 0x7FFF);
+        }
+    }
+};
+
+// 输出: float, 平面或交错布局
+struct FloatSink : Stage {
+    float* output;
+    uint16_t layout;
+
+    explicit FloatSink(float* out, uint16_t out_layout = AUDIO_LAYOUT_PLANAR) : output(out), layout(out_layout) {}
+
+    inline void process(float* x, uint32_t n, const PipelineBlock& block) {
+        if (layout == AUDIO_LAYOUT_INTERLEAVED && block.num_channels > 1) {
+            float* dst = output + (size_t)block.offset * block.num_channels + block.channel;
+            for (uint32_t i = 0; i < n; i++) dst[(size_t)i * block.num_channels] = x[i];
+        } else {
+            memcpy(output + (size_t)block.channel * block.length + block.offset, x, n * sizeof(float));
+        }
+    }
+};
+
+// 对 source (平面或交错布局, 任一样本格式) 运行整条流水线
+// 按块推进, 每块内依次处理各声道, 交错输入的读取 / 交错输出的写入位置都保持局部连续
+// 紧凑格式 (int16 / float16) 在读入块时展开, 不需要整段的 float 副本
+// 返回 0 表示声道数超出 PIPELINE_MAX_CHANNELS
+template <typename Pipeline>
+inline int pipeline_run(Pipeline& pipeline, const AudioBuffer* source) {
+    if (source->num_channels > PIPELINE_MAX_CHANNELS) return 0;
+
+    const AudioView view = audio_view_of(source);
+    float block[PIPELINE_BLOCK_FRAMES];
+    PipelineBlock pos;
+    pos.num_channels = source->num_channels;
+    pos.length = source->length;
+
+    pipeline.reset();
+    for (uint32_t offset = 0; offset < source->length; offset += PIPELINE_BLOCK_FRAMES) {
+        uint32_t n = source->length - offset < PIPELINE_BLOCK_FRAMES ? source->length - offset
+                                                                     : PIPELINE_BLOCK_FRAMES;
+        pos.offset = offset;
+        for (uint16_t ch = 0; ch < source->num_channels; ch++) {
+            pos.channel = ch;
+            audio_view_read(&view, ch, offset, n, block);
+            pipeline.process(block, n, pos);
+        }
+    }
+    return 1;
+}
+
+} // namespace audio_pipeline
+
+#endif // AUDIO_PIPELINE_H
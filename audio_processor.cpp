@@ -1,53 +1,447 @@
 // 音频处理 WASM 模块 - C/C++ 源码
 // 用于优化 ivc.html 中的流式音频处理
+//
+// 本文件为核心: 内存管理 / WAV 编解码 / 切分 / 合并 / 视图 / 批量导出 / 分步任务 / 追踪与统计.
+// 其余导出按功能放在单独的源文件中, 可以构建为完整模块, 也可以构建为小的核心模块加按需加载的功能模块
+// (每个功能模块是独立的实例, 自带一份核心代码; JS 侧每次调用本来就要把数据拷入 WASM 内存, 不需要共享内存):
+//   完整:  emcc -O3 audio_processor.cpp audio_dsp.cpp audio_speech.cpp speech_synth.cpp task_pool.cpp -sALLOW_MEMORY_GROWTH -sMODULARIZE -sEXPORT_NAME=AudioProcessorWASM -o audio_processor.js
+//   核心:  emcc -O3 audio_processor.cpp task_pool.cpp -sALLOW_MEMORY_GROWTH -sMODULARIZE -sEXPORT_NAME=AudioCoreWASM -o audio_core.js
+//   DSP:   emcc -O3 audio_processor.cpp audio_dsp.cpp task_pool.cpp -sALLOW_MEMORY_GROWTH -sMODULARIZE -sEXPORT_NAME=AudioDspWASM -o audio_dsp.js
+//   语音:  emcc -O3 audio_processor.cpp audio_speech.cpp speech_synth.cpp task_pool.cpp -sALLOW_MEMORY_GROWTH -sMODULARIZE -sEXPORT_NAME=AudioSpeechWASM -o audio_speech.js
+// 功能模块的加载见 wasm_audio.js 中的 WASM_FEATURES, 各配置的体积 / 就绪耗时见 bench/bench_node.js --startup
 
-#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
 
-// WAV文件头结构
+#include "audio_internal.h"
+
+// 全局内存缓冲区
+MemoryBuffer g_memory_buffer = {NULL, 0, 0};
+
+#if AUDIO_TRACE
+// 环形缓冲区, 满了以后覆盖最旧的事件
+TraceEvent g_trace_events[TRACE_RING_SIZE];
+uint32_t g_trace_count = 0;
+#endif
+
+#if AUDIO_STATS
+// 8 字节对齐, JS 侧按 HEAPF64 读取 double 字段
+AudioStats g_stats __attribute__((aligned(8))) = {1, FUNC_COUNT, 0, 0, {}};
+int32_t g_stats_current = -1;   // 正在执行的导出函数, 用于归属扩容事件
+#endif
+
+// 确保 g_memory_buffer 至少有 size 字节, 不够时 realloc
+// 返回 0 表示分配失败
+int ensure_buffer_capacity(uint32_t size) {
+    if (size <= g_memory_buffer.capacity) return 1;
+
+    uint8_t* new_buffer = (uint8_t*)realloc(g_memory_buffer.buffer, size);
+    if (!new_buffer) return 0;
+    g_memory_buffer.buffer = new_buffer;
+    g_memory_buffer.capacity = size;
+
+#if AUDIO_STATS
+    g_stats.grow_events++;
+    if (size > g_stats.peak_capacity) g_stats.peak_capacity = size;
+    if (g_stats_current >= 0) g_stats.funcs[g_stats_current].grow_events++;
+#endif
+    return 1;
+}
+
+// 填充 PCM WAV 文件头
+void write_wav_header(WAVHeader* header, uint16_t num_channels, uint32_t sample_rate,
+                      uint16_t bits_per_sample, uint32_t data_size) {
+    uint16_t block_align = num_channels * (bits_per_sample / 8);
+
+    memcpy(header->riff, "RIFF", 4);
+    header->file_size = 36 + data_size;
+    memcpy(header->wave, "WAVE", 4);
+    memcpy(header->fmt, "fmt ", 4);
+    header->fmt_size = 16;
+    header->audio_format = 1; // PCM
+    header->num_channels = num_channels;
+    header->sample_rate = sample_rate;
+    header->byte_rate = sample_rate * block_align;
+    header->block_align = block_align;
+    header->bits_per_sample = bits_per_sample;
+    memcpy(header->data, "data", 4);
+    header->data_size = data_size;
+}
+
+// 准备向 g_memory_buffer 写入 output_size 字节的输出
+// 视图数据本身位于 g_memory_buffer 中时, 输出不能覆盖它, 也不能触发 realloc (会使视图指针失效)
+// 返回 0 表示无法安全写入
+int prepare_output_for_view(const AudioView* view, uint32_t output_size) {
+    const uint8_t* data = (const uint8_t*)audio_view_channel(view, 0);
+    const uint8_t* buffer = g_memory_buffer.buffer;
+    if (buffer && data >= buffer && data < buffer + g_memory_buffer.capacity) {
+        return output_size <= g_memory_buffer.capacity && data >= buffer + output_size;
+    }
+    return ensure_buffer_capacity(output_size);
+}
+
+// 逐样本搬运 (布局不同), T 为与样本等宽的类型
+template <typename T>
+static void copy_view_samples(const AudioView* src, T* dst, uint32_t dst_channel_stride, uint32_t dst_frame_stride) {
+    for (uint16_t ch = 0; ch < src->num_channels; ch++) {
+        const T* s = (const T*)audio_view_channel(src, ch);
+        T* d = dst + (size_t)ch * dst_channel_stride;
+        for (uint32_t i = 0; i < src->length; i++) {
+            d[(size_t)i * dst_frame_stride] = s[(size_t)i * src->frame_stride];
+        }
+    }
+}
+
+// 把 src 的全部帧复制到 dst 指向的区域 (dst 为目标声道 0 第 0 帧, 步长含义同 AudioView)
+// 两侧都按帧连续时逐声道 memcpy, 都是紧密交错时整块 memcpy, 否则逐样本搬运 (布局不同)
+void copy_view(const AudioView* src, void* dst, uint32_t dst_channel_stride, uint32_t dst_frame_stride) {
+    const uint16_t channels = src->num_channels;
+    const size_t bytes = audio_sample_bytes(audio_format_of(src->layout));
+    uint8_t* out = (uint8_t*)dst;
+    if (src->frame_stride == 1 && dst_frame_stride == 1) {
+        for (uint16_t ch = 0; ch < channels; ch++) {
+            memcpy(out + (size_t)ch * dst_channel_stride * bytes, audio_view_channel(src, ch), src->length * bytes);
+        }
+        return;
+    }
+    if (src->channel_stride == 1 && dst_channel_stride == 1 &&
+        src->frame_stride == channels && dst_frame_stride == channels) {
+        memcpy(out, audio_view_channel(src, 0), (size_t)src->length * channels * bytes);
+        return;
+    }
+    if (bytes == sizeof(float)) {
+        copy_view_samples(src, (uint32_t*)dst, dst_channel_stride, dst_frame_stride);
+    } else {
+        copy_view_samples(src, (uint16_t*)dst, dst_channel_stride, dst_frame_stride);
+    }
+}
+
+// 连续样本的格式转换; 两种紧凑格式之间经栈上的 float 小块中转
+#define CONVERT_BLOCK_SAMPLES 512
+
+void convert_samples(const void* src, uint16_t from, void* dst, uint16_t to, size_t count) {
+    if (from == to) {
+        memcpy(dst, src, count * audio_sample_bytes(from));
+    } else if (from == AUDIO_SAMPLE_F32) {
+        audio_narrow((const float*)src, (uint32_t)count, to, dst, 1);
+    } else if (to == AUDIO_SAMPLE_F32) {
+        audio_widen(src, from, 1, (uint32_t)count, (float*)dst);
+    } else {
+        float block[CONVERT_BLOCK_SAMPLES];
+        for (size_t i = 0; i < count; i += CONVERT_BLOCK_SAMPLES) {
+            uint32_t n = (uint32_t)(count - i < CONVERT_BLOCK_SAMPLES ? count - i : CONVERT_BLOCK_SAMPLES);
+            audio_widen((const uint16_t*)src + i, from, 1, n, block);
+            audio_narrow(block, n, to, (uint16_t*)dst + i, 1);
+        }
+    }
+}
+
+// float -> 16 / 24 位 PCM (输入输出都是连续的交错数据)
+static void encode_pcm(const float* input, size_t count, uint16_t bits_per_sample, uint8_t* data_ptr) {
+    if (bits_per_sample == 16) {
+        int16_t* int_data = (int16_t*)data_ptr;
+        for (size_t i = 0; i < count; i++) {
+            // 将浮点 (-1.0 到 1.0) 转换为 16位整数
+            float sample = input[i];
+            sample = fmaxf(-1.0f, fminf(1.0f, sample));
+            int_data[i] = (int16_t)(sample < 0 ? sample * 0x8000 : sample * 0x7FFF);
+        }
+    } else if (bits_per_sample == 24) {
+        uint8_t* byte_data = data_ptr;
+        for (size_t i = 0; i < count; i++) {
+            float sample = input[i];
+            sample = fmaxf(-1.0f, fminf(1.0f, sample));
+            int32_t int_sample = (int32_t)(sample < 0 ? sample * 0x800000 : sample * 0x7FFFFF);
+
+            // 小端序存储24位
+            byte_data[i * 3] = int_sample & 0xFF;
+            byte_data[i * 3 + 1] = (int_sample >> 8) & 0xFF;
+            byte_data[i * 3 + 2] = (int_sample >> 16) & 0xFF;
+        }
+    }
+}
+
+// 视图逐声道编码为交错 PCM; FS 为编译期帧步长 (平面布局为 1), 为 0 时使用 view->frame_stride
+template <uint32_t FS>
+static void encode_view_channels(const AudioView* view, uint16_t bits_per_sample, uint8_t* data_ptr) {
+    const uint16_t num_channels = view->num_channels;
+    const uint32_t fs = FS ? FS : view->frame_stride;
+    for (uint16_t ch = 0; ch < num_channels; ch++) {
+        const float* src = audio_view_channel(view, ch);
+        if (bits_per_sample == 16) {
+            int16_t* dst = (int16_t*)data_ptr + ch;
+            for (uint32_t i = 0; i < view->length; i++) {
+                float sample = fmaxf(-1.0f, fminf(1.0f, src[(size_t)i * fs]));
+                dst[(size_t)i * num_channels] = (int16_t)(sample < 0 ? sample * 0x8000 : sample * 0x7FFF);
+            }
+        } else if (bits_per_sample == 24) {
+            uint8_t* dst = data_ptr + ch * 3;
+            for (uint32_t i = 0; i < view->length; i++) {
+                float sample = fmaxf(-1.0f, fminf(1.0f, src[(size_t)i * fs]));
+                int32_t int_sample = (int32_t)(sample < 0 ? sample * 0x800000 : sample * 0x7FFFFF);
+                uint8_t* out = dst + (size_t)i * num_channels * 3;
+                out[0] = int_sample & 0xFF;
+                out[1] = (int_sample >> 8) & 0xFF;
+                out[2] = (int_sample >> 16) & 0xFF;
+            }
+        }
+    }
+}
+
+// 紧凑格式的视图逐声道编码: 按块展开为 float 后量化 (int16 -> 16 位不经过这里, 见 encode_view_data)
+static void encode_view_compact(const AudioView* view, uint16_t bits_per_sample, uint8_t* data_ptr) {
+    const uint16_t num_channels = view->num_channels;
+    float block[CONVERT_BLOCK_SAMPLES];
+    for (uint16_t ch = 0; ch < num_channels; ch++) {
+        for (uint32_t offset = 0; offset < view->length; offset += CONVERT_BLOCK_SAMPLES) {
+            uint32_t n = view->length - offset < CONVERT_BLOCK_SAMPLES ? view->length - offset : CONVERT_BLOCK_SAMPLES;
+            audio_view_read(view, ch, offset, n, block);
+            if (bits_per_sample == 16) {
+                int16_t* dst = (int16_t*)data_ptr + (size_t)offset * num_channels + ch;
+                for (uint32_t i = 0; i < n; i++) {
+                    dst[(size_t)i * num_channels] = audio_float_to_s16(block[i]);
+                }
+            } else if (bits_per_sample == 24) {
+                uint8_t* dst = data_ptr + ((size_t)offset * num_channels + ch) * 3;
+                for (uint32_t i = 0; i < n; i++) {
+                    float sample = fmaxf(-1.0f, fminf(1.0f, block[i]));
+                    int32_t int_sample = (int32_t)(sample < 0 ? sample * 0x800000 : sample * 0x7FFFFF);
+                    uint8_t* out = dst + (size_t)i * num_channels * 3;
+                    out[0] = int_sample & 0xFF;
+                    out[1] = (int_sample >> 8) & 0xFF;
+                    out[2] = (int_sample >> 16) & 0xFF;
+                }
+            }
+        }
+    }
+}
+
+template <uint16_t CHANNELS>
+static void slice_kernel(const AudioBuffer* source, uint32_t start_sample, uint32_t slice_length, float* output) {
+    const uint16_t channels = channel_count<CHANNELS>(source->num_channels);
+    for (uint16_t ch = 0; ch < channels; ch++) {
+        memcpy(output + (size_t)ch * slice_length,
+               source->data + (size_t)ch * source->length + start_sample,
+               slice_length * sizeof(float));
+    }
+}
+
+template <uint16_t CHANNELS>
+static void merge_kernel(const AudioBuffer* buffers, uint32_t num_buffers, uint32_t total_length, float* output) {
+    const uint16_t channels = channel_count<CHANNELS>(buffers[0].num_channels);
+    uint32_t offset = 0;
+    for (uint32_t i = 0; i < num_buffers; i++) {
+        for (uint16_t ch = 0; ch < channels; ch++) {
+            memcpy(output + (size_t)ch * total_length + offset,
+                   buffers[i].data + (size_t)ch * buffers[i].length,
+                   buffers[i].length * sizeof(float));
+        }
+        offset += buffers[i].length;
+    }
+}
+
 typedef struct {
-    char riff[4];           // "RIFF"
-    uint32_t file_size;     // 文件大小 - 8
-    char wave[4];           // "WAVE"
-    char fmt[4];            // "fmt "
-    uint32_t fmt_size;      // fmt chunk 大小
-    uint16_t audio_format;  // 音频格式 (1 = PCM)
-    uint16_t num_channels;  // 声道数
-    uint32_t sample_rate;   // 采样率
-    uint32_t byte_rate;     // 字节率
-    uint16_t block_align;   // 块对齐
-    uint16_t bits_per_sample; // 位深
-    char data[4];           // "data"
-    uint32_t data_size;     // 数据大小
-} __attribute__((packed)) WAVHeader;
-
-// 音频缓冲区信息
+    const float* input;
+    uint16_t bits_per_sample;
+    uint8_t* data_ptr;
+} EncodeTask;
+
+static void encode_pcm_task(void* ctx, uint32_t begin, uint32_t end) {
+    const EncodeTask* task = (const EncodeTask*)ctx;
+    encode_pcm(task->input + begin, end - begin, task->bits_per_sample,
+               task->data_ptr + (size_t)begin * (task->bits_per_sample / 8));
+}
+
+// 连续交错数据编码, 按样本切块
+static void encode_pcm_parallel(const float* input, uint32_t count, uint16_t bits_per_sample, uint8_t* data_ptr) {
+    EncodeTask task = {input, bits_per_sample, data_ptr};
+    task_pool_run(count, parallel_grain(count, PARALLEL_MIN_SAMPLES), encode_pcm_task, &task);
+}
+
 typedef struct {
-    float* data;            // 浮点音频数据
-    uint32_t length;        // 采样点数
-    uint16_t num_channels;  // 声道数
-    uint32_t sample_rate;   // 采样率
-} AudioBuffer;
+    const uint8_t* src;
+    uint16_t from;
+    uint8_t* dst;
+    uint16_t to;
+} ConvertTask;
+
+static void convert_task(void* ctx, uint32_t begin, uint32_t end) {
+    const ConvertTask* task = (const ConvertTask*)ctx;
+    convert_samples(task->src + (size_t)begin * audio_sample_bytes(task->from), task->from,
+                    task->dst + (size_t)begin * audio_sample_bytes(task->to), task->to, end - begin);
+}
 
-// 简单的内存管理器
 typedef struct {
-    uint8_t* buffer;
-    uint32_t size;
-    uint32_t capacity;
-} MemoryBuffer;
+    const AudioView* view;
+    uint16_t bits_per_sample;
+    uint8_t* data_ptr;
+} ViewEncodeTask;
+
+// 视图按帧切块编码: 每块是原视图的子视图, 写入 WAV 数据区的对应位置
+static void encode_view_task(void* ctx, uint32_t begin, uint32_t end) {
+    const ViewEncodeTask* task = (const ViewEncodeTask*)ctx;
+    AudioView part = *task->view;
+    part.offset += begin;
+    part.length = end - begin;
+    uint8_t* out = task->data_ptr + (size_t)begin * part.num_channels * (task->bits_per_sample / 8);
+    if (audio_format_of(part.layout) != AUDIO_SAMPLE_F32) {
+        encode_view_compact(&part, task->bits_per_sample, out);
+    } else if (part.frame_stride == 1) {
+        encode_view_channels<1>(&part, task->bits_per_sample, out);
+    } else {
+        encode_view_channels<0>(&part, task->bits_per_sample, out);
+    }
+}
 
-// 全局内存缓冲区
-MemoryBuffer g_memory_buffer = {NULL, 0, 0};
+typedef struct {
+    const AudioBuffer* buffers;
+    const uint32_t* offsets;    // 各段在输出中的起始帧
+    AudioView out;
+} MergeTask;
+
+// 按段切块合并: 每段复制到输出中自己的位置
+static void merge_task(void* ctx, uint32_t begin, uint32_t end) {
+    const MergeTask* task = (const MergeTask*)ctx;
+    for (uint32_t i = begin; i < end; i++) {
+        AudioView src = audio_view_of(&task->buffers[i]);
+        AudioView out = task->out;
+        out.offset = task->offsets[i];
+        copy_view(&src, view_write_ptr(&out, 0), out.channel_stride, out.frame_stride);
+    }
+}
+
+// 视图编码为交错 PCM 写入 data_ptr (WAV 数据区)
+static void encode_view_data(const AudioView* view, uint16_t bits_per_sample, uint8_t* data_ptr) {
+    const uint16_t num_channels = view->num_channels;
+    const uint16_t format = audio_format_of(view->layout);
+    if (format == AUDIO_SAMPLE_S16 && bits_per_sample == 16) {
+        // int16 与 16 位 PCM 的量化相同: 只需交错复制, 结果与先展开为 float 再编码逐位一致
+        copy_view(view, data_ptr, 1, num_channels);
+    } else if (format == AUDIO_SAMPLE_F32 && view->frame_stride == num_channels &&
+               (num_channels == 1 || view->channel_stride == 1)) {
+        // 紧密交错 (或单声道): 与 WAV 数据区顺序相同, 直接连续编码
+        encode_pcm_parallel(audio_view_channel(view, 0), view->length * num_channels, bits_per_sample, data_ptr);
+    } else {
+        ViewEncodeTask task = {view, bits_per_sample, data_ptr};
+        uint32_t min_frames = PARALLEL_MIN_SAMPLES / (num_channels ? num_channels : 1);
+        task_pool_run(view->length, parallel_grain(view->length, min_frames), encode_view_task, &task);
+    }
+}
+
+// 批量处理: 先按片段计划排好每个输出的位置 (results), 再逐段 (多线程时按段并行) 写入
+// 片段起点 / 长度的截断方式与 wasm_slice_view 相同
+static inline AudioView segment_view(const AudioView* source, const AudioSegment* segment) {
+    AudioView view = *source;
+    view.offset = segment->start < source->length ? segment->start : source->length;
+    view.length = segment->length < source->length - view.offset ? segment->length : source->length - view.offset;
+    return view;
+}
+
+// 片段数不少于线程数时按段并行; 否则整批在调用线程上顺序处理, 让每段内部的编码 / 复制按块并行
+static inline uint32_t segment_grain(uint32_t num_segments) {
+    return num_segments >= task_pool_threads() ? 1 : num_segments;
+}
 
-// 导出函数声明
+typedef struct {
+    const AudioView* source;
+    const AudioSegment* segments;
+    const SegmentResult* results;
+    uint16_t bits_per_sample;
+} BatchEncodeTask;
+
+static void encode_segments_task(void* ctx, uint32_t begin, uint32_t end) {
+    const BatchEncodeTask* task = (const BatchEncodeTask*)ctx;
+    for (uint32_t i = begin; i < end; i++) {
+        AudioView view = segment_view(task->source, &task->segments[i]);
+        uint8_t* wav = g_memory_buffer.buffer + task->results[i].offset;
+        write_wav_header((WAVHeader*)wav, view.num_channels, view.sample_rate, task->bits_per_sample,
+                         task->results[i].size - 44);
+        encode_view_data(&view, task->bits_per_sample, wav + 44);
+    }
+}
+
+typedef struct {
+    const AudioView* source;
+    const AudioSegment* segments;
+    const SegmentResult* results;
+} BatchSliceTask;
+
+static void slice_segments_task(void* ctx, uint32_t begin, uint32_t end) {
+    const BatchSliceTask* task = (const BatchSliceTask*)ctx;
+    for (uint32_t i = begin; i < end; i++) {
+        AudioView view = segment_view(task->source, &task->segments[i]);
+        uint8_t* dst = g_memory_buffer.buffer + task->results[i].offset;
+        // 输出布局与源相同: 平面 (声道间隔为片段长度) 或紧密交错
+        if (audio_layout_of(view.layout) == AUDIO_LAYOUT_INTERLEAVED) {
+            copy_view(&view, dst, 1, view.num_channels);
+        } else {
+            copy_view(&view, dst, view.length, 1);
+        }
+    }
+}
+
+// 分步任务每次计算的输出帧数: 每块之后检查一次时间, 块小到能及时停下, 又大到计时开销可以忽略
+#define JOB_CHUNK_FRAMES 16384
+
+AudioJob* audio_job_create(AudioJobStep step, const AudioBuffer* inputs, uint32_t num_inputs,
+                           const AudioBuffer* output) {
+    AudioJob* job = (AudioJob*)calloc(1, sizeof(AudioJob));
+    if (!job) return NULL;
+    job->step = step;
+    job->num_inputs = num_inputs;
+    job->output = *output;
+
+    size_t input_bytes = 0;
+    for (uint32_t i = 0; i < num_inputs; i++) {
+        input_bytes += (size_t)inputs[i].length * inputs[i].num_channels * buffer_sample_bytes(&inputs[i]);
+    }
+    job->inputs = (AudioBuffer*)malloc(num_inputs * sizeof(AudioBuffer) + 1);
+    job->input_data = (uint8_t*)malloc(input_bytes + 1);
+    job->output.data = (float*)malloc((size_t)output->length * output->num_channels * buffer_sample_bytes(output) + 1);
+    if (!job->inputs || !job->input_data || !job->output.data) {
+        wasm_job_free(job);
+        return NULL;
+    }
+
+    // 各输入依次存放在 input_data 中
+    size_t offset = 0;
+    for (uint32_t i = 0; i < num_inputs; i++) {
+        job->inputs[i] = inputs[i];
+        job->inputs[i].data = (float*)(job->input_data + offset);
+        offset += (size_t)inputs[i].length * inputs[i].num_channels * buffer_sample_bytes(&inputs[i]);
+    }
+    return job;
+}
+
+// 分步合并: 输出的 [begin, end) 帧可能跨越多个输入段, 逐段复制与之重叠的部分
+static void merge_job_step(AudioJob* job, uint32_t begin, uint32_t end) {
+    AudioView out = audio_view_of(&job->output);
+    while (begin < end) {
+        const AudioBuffer* input = &job->inputs[job->cursor];
+        uint32_t start = begin - job->cursor_start;     // 段内起始帧
+        uint32_t n = input->length - start;
+        if (n > end - begin) n = end - begin;
+
+        AudioView src = audio_view_of(input);
+        src.offset = start;
+        src.length = n;
+        out.offset = begin;
+        copy_view(&src, view_write_ptr(&out, 0), out.channel_stride, out.frame_stride);
+
+        begin += n;
+        if (start + n == input->length) {
+            job->cursor_start += input->length;
+            job->cursor++;
+        }
+    }
+}
 
 // 内存管理
 extern "C" {
 
 // 初始化内存缓冲区
-uint32_t wasm_init_memory(uint32_t size) {
+WASM_EXPORT uint32_t wasm_init_memory(uint32_t size) {
     if (g_memory_buffer.buffer) {
         free(g_memory_buffer.buffer);
     }
@@ -60,12 +454,12 @@ uint32_t wasm_init_memory(uint32_t size) {
 }
 
 // 获取内存缓冲区指针
-uint8_t* wasm_get_memory_buffer() {
+WASM_EXPORT uint8_t* wasm_get_memory_buffer() {
     return g_memory_buffer.buffer;
 }
 
 // 清理内存
-void wasm_cleanup() {
+WASM_EXPORT void wasm_cleanup() {
     if (g_memory_buffer.buffer) {
         free(g_memory_buffer.buffer);
         g_memory_buffer.buffer = NULL;
@@ -77,81 +471,45 @@ void wasm_cleanup() {
 // AudioBuffer转WAV
 // 输入: float数组, 长度, 声道数, 采样率, 位深
 // 输出: WAV数据 (存储在g_memory_buffer中)
-uint32_t wasm_audio_buffer_to_wav(
+WASM_EXPORT uint32_t wasm_audio_buffer_to_wav(
     float* audio_data,
     uint32_t length,
     uint16_t num_channels,
     uint32_t sample_rate,
     uint16_t bits_per_sample
 ) {
+    CALL_SCOPE(FUNC_AUDIO_BUFFER_TO_WAV);
+
     uint16_t bytes_per_sample = bits_per_sample / 8;
     uint16_t block_align = num_channels * bytes_per_sample;
     uint32_t data_size = length * block_align;
     uint32_t total_size = 44 + data_size;
 
-    // 检查缓冲区是否足够
-    if (total_size > g_memory_buffer.capacity) {
-        // 重新分配
-        uint8_t* new_buffer = (uint8_t*)realloc(g_memory_buffer.buffer, total_size);
-        if (!new_buffer) return 0;
-        g_memory_buffer.buffer = new_buffer;
-        g_memory_buffer.capacity = total_size;
-    }
-
-    WAVHeader* header = (WAVHeader*)g_memory_buffer.buffer;
+    if (!ensure_buffer_capacity(total_size)) return 0;
 
     // 填充WAV文件头
-    memcpy(header->riff, "RIFF", 4);
-    header->file_size = total_size - 8;
-    memcpy(header->wave, "WAVE", 4);
-    memcpy(header->fmt, "fmt ", 4);
-    header->fmt_size = 16;
-    header->audio_format = 1; // PCM
-    header->num_channels = num_channels;
-    header->sample_rate = sample_rate;
-    header->byte_rate = sample_rate * block_align;
-    header->block_align = block_align;
-    header->bits_per_sample = bits_per_sample;
-    memcpy(header->data, "data", 4);
-    header->data_size = data_size;
+    write_wav_header((WAVHeader*)g_memory_buffer.buffer, num_channels, sample_rate, bits_per_sample, data_size);
 
     // 编码音频数据
     uint8_t* data_ptr = g_memory_buffer.buffer + 44;
 
-    if (bits_per_sample == 16) {
-        int16_t* int_data = (int16_t*)data_ptr;
-        for (uint32_t i = 0; i < length * num_channels; i++) {
-            // 将浮点 (-1.0 到 1.0) 转换为 16位整数
-            float sample = audio_data[i];
-            sample = fmaxf(-1.0f, fminf(1.0f, sample));
-            int_data[i] = (int16_t)(sample < 0 ? sample * 0x8000 : sample * 0x7FFF);
-        }
-    } else if (bits_per_sample == 24) {
-        uint8_t* byte_data = data_ptr;
-        for (uint32_t i = 0; i < length * num_channels; i++) {
-            float sample = audio_data[i];
-            sample = fmaxf(-1.0f, fminf(1.0f, sample));
-            int32_t int_sample = (int32_t)(sample < 0 ? sample * 0x800000 : sample * 0x7FFFFF);
-
-            // 小端序存储24位
-            byte_data[i * 3] = int_sample & 0xFF;
-            byte_data[i * 3 + 1] = (int_sample >> 8) & 0xFF;
-            byte_data[i * 3 + 2] = (int_sample >> 16) & 0xFF;
-        }
-    }
+    encode_pcm_parallel(audio_data, length * num_channels, bits_per_sample, data_ptr);
 
     g_memory_buffer.size = total_size;
+    CALL_IO(length, length, length * num_channels * sizeof(float), total_size);
     return total_size;
 }
 
 // WAV转AudioBuffer
 // 输入: WAV数据指针, 大小
 // 输出: 音频参数和采样数
-uint32_t wasm_wav_to_audio_buffer(
+WASM_EXPORT uint32_t wasm_wav_to_audio_buffer(
     uint8_t* wav_data,
     uint32_t wav_size,
     AudioBuffer* output
 ) {
+    CALL_SCOPE(FUNC_WAV_TO_AUDIO_BUFFER);
+
     if (wav_size < 44) return 0;
 
     WAVHeader* header = (WAVHeader*)wav_data;
@@ -168,21 +526,22 @@ uint32_t wasm_wav_to_audio_buffer(
     uint32_t sample_rate = header->sample_rate;
     uint16_t bytes_per_sample = bits_per_sample / 8;
 
+    // 只解码 16 / 24 位整数 PCM, 其他编码返回 0 (不输出未初始化的数据)
+    if (header->audio_format != 1 || (bits_per_sample != 16 && bits_per_sample != 24) || num_channels == 0) {
+        return 0;
+    }
+
     // 计算采样点数
     uint32_t num_samples = header->data_size / (num_channels * bytes_per_sample);
 
     // 分配内存
     uint32_t buffer_size = num_samples * num_channels * sizeof(float);
-    if (buffer_size > g_memory_buffer.capacity) {
-        uint8_t* new_buffer = (uint8_t*)realloc(g_memory_buffer.buffer, buffer_size);
-        if (!new_buffer) return 0;
-        g_memory_buffer.buffer = new_buffer;
-        g_memory_buffer.capacity = buffer_size;
-    }
+    if (!ensure_buffer_capacity(buffer_size)) return 0;
 
     output->data = (float*)g_memory_buffer.buffer;
     output->length = num_samples;
     output->num_channels = num_channels;
+    output->layout = AUDIO_LAYOUT_INTERLEAVED;  // 与 WAV 数据区相同, 不做解交错
     output->sample_rate = sample_rate;
 
     // 解码音频数据
@@ -204,217 +563,398 @@ uint32_t wasm_wav_to_audio_buffer(
     }
 
     g_memory_buffer.size = buffer_size;
+    CALL_IO(num_samples, num_samples, wav_size, buffer_size);
     return num_samples;
 }
 
+// 样本格式转换 - float32 压缩为 int16 / float16 存放, 或展开回 float32 (布局不变)
+// 输入: 源buffer (任一格式), 目标格式 AUDIO_SAMPLE_*
+// 输出: 转换后的数据 (存储在g_memory_buffer中), 返回采样点数
+WASM_EXPORT uint32_t wasm_convert_samples(AudioBuffer* source, uint16_t format, AudioBuffer* output) {
+    CALL_SCOPE(FUNC_CONVERT_SAMPLES);
+
+    if (format > AUDIO_SAMPLE_F16) return 0;
+
+    uint16_t from = audio_format_of(source->layout);
+    uint32_t count = source->length * source->num_channels;
+    uint32_t buffer_size = count * audio_sample_bytes(format);
+    AudioView view = audio_view_of(source);
+    if (!prepare_output_for_view(&view, buffer_size)) return 0;
+
+    output->data = (float*)g_memory_buffer.buffer;
+    output->length = source->length;
+    output->num_channels = source->num_channels;
+    output->layout = audio_make_layout(source->layout, format);
+    output->sample_rate = source->sample_rate;
+
+    ConvertTask task = {(const uint8_t*)source->data, from, g_memory_buffer.buffer, format};
+    task_pool_run(count, parallel_grain(count, PARALLEL_MIN_SAMPLES), convert_task, &task);
+
+    g_memory_buffer.size = buffer_size;
+    CALL_IO(source->length, source->length, count * audio_sample_bytes(from), buffer_size);
+    return source->length;
+}
+
 // 音频切片 - 从AudioBuffer中提取片段
 // 输入: 源buffer, 起始采样, 长度
-// 输出: 切片后的数据 (存储在g_memory_buffer中)
-uint32_t wasm_slice_audio(
+// 输出: 切片后的数据 (存储在g_memory_buffer中, 布局与源相同)
+WASM_EXPORT uint32_t wasm_slice_audio(
     AudioBuffer* source,
     uint32_t start_sample,
     uint32_t slice_length
 ) {
+    CALL_SCOPE(FUNC_SLICE_AUDIO);
+
     if (start_sample + slice_length > source->length) {
         slice_length = source->length - start_sample;
     }
 
-    uint32_t buffer_size = slice_length * source->num_channels * sizeof(float);
+    uint32_t sample_bytes = buffer_sample_bytes(source);
+    uint32_t buffer_size = slice_length * source->num_channels * sample_bytes;
 
-    if (buffer_size > g_memory_buffer.capacity) {
-        uint8_t* new_buffer = (uint8_t*)realloc(g_memory_buffer.buffer, buffer_size);
-        if (!new_buffer) return 0;
-        g_memory_buffer.buffer = new_buffer;
-        g_memory_buffer.capacity = buffer_size;
-    }
+    if (!ensure_buffer_capacity(buffer_size)) return 0;
 
     float* slice_data = (float*)g_memory_buffer.buffer;
 
-    // 复制音频数据
-    for (uint16_t ch = 0; ch < source->num_channels; ch++) {
-        memcpy(slice_data + ch * slice_length,
-               source->data + ch * source->length + start_sample,
-               slice_length * sizeof(float));
+    // 复制音频数据 (交错布局的片段本身是连续的一块)
+    if (effective_layout(source) == AUDIO_LAYOUT_INTERLEAVED) {
+        memcpy(slice_data, (const uint8_t*)source->data + (size_t)start_sample * source->num_channels * sample_bytes,
+               buffer_size);
+    } else if (sample_bytes == sizeof(float)) {
+        DISPATCH_CHANNELS(source->num_channels, slice_kernel, source, start_sample, slice_length, slice_data);
+    } else {
+        // 紧凑格式的平面数据: 按视图逐声道复制
+        AudioView view = audio_view_of(source);
+        view.offset = start_sample;
+        view.length = slice_length;
+        copy_view(&view, slice_data, slice_length, 1);
     }
 
     g_memory_buffer.size = buffer_size;
+    CALL_IO(slice_length, slice_length, buffer_size, buffer_size);
     return slice_length;
 }
 
 // 音频合并 - 合并多个AudioBuffer
-// 输入: buffer数组, 数量, 输出buffer
-// 输出: 合并后的采样点数
-uint32_t wasm_merge_audio_buffers(
+// 输入: buffer数组, 数量, 输出buffer (布局与第一个buffer相同, 各buffer的布局可以不同, 样本格式必须相同)
+// 输出: 合并后的采样点数 (紧凑格式的输入合并后仍为紧凑格式)
+WASM_EXPORT uint32_t wasm_merge_audio_buffers(
     AudioBuffer* buffers,
     uint32_t num_buffers,
     AudioBuffer* output
 ) {
+    CALL_SCOPE(FUNC_MERGE_AUDIO_BUFFERS);
+
     if (num_buffers == 0) return 0;
 
     uint16_t num_channels = buffers[0].num_channels;
     uint32_t sample_rate = buffers[0].sample_rate;
+    uint16_t format = audio_format_of(buffers[0].layout);
     uint32_t total_length = 0;
+    int all_planar = 1;
 
     // 计算总长度
     for (uint32_t i = 0; i < num_buffers; i++) {
         if (buffers[i].num_channels != num_channels ||
-            buffers[i].sample_rate != sample_rate) {
+            buffers[i].sample_rate != sample_rate ||
+            audio_format_of(buffers[i].layout) != format) {
             return 0; // 格式不匹配
         }
         total_length += buffers[i].length;
+        if (effective_layout(&buffers[i]) != AUDIO_LAYOUT_PLANAR) all_planar = 0;
     }
 
-    uint32_t buffer_size = total_length * num_channels * sizeof(float);
+    uint32_t buffer_size = total_length * num_channels * audio_sample_bytes(format);
 
-    if (buffer_size > g_memory_buffer.capacity) {
-        uint8_t* new_buffer = (uint8_t*)realloc(g_memory_buffer.buffer, buffer_size);
-        if (!new_buffer) return 0;
-        g_memory_buffer.buffer = new_buffer;
-        g_memory_buffer.capacity = buffer_size;
-    }
+    if (!ensure_buffer_capacity(buffer_size)) return 0;
 
     output->data = (float*)g_memory_buffer.buffer;
     output->length = total_length;
     output->num_channels = num_channels;
+    output->layout = buffers[0].layout;
     output->sample_rate = sample_rate;
 
     // 合并音频数据
-    uint32_t offset = 0;
-    for (uint32_t i = 0; i < num_buffers; i++) {
-        for (uint16_t ch = 0; ch < num_channels; ch++) {
-            memcpy(output->data + ch * total_length + offset,
-                   buffers[i].data + ch * buffers[i].length,
-                   buffers[i].length * sizeof(float));
+    uint32_t* offsets = NULL;
+    if (task_pool_threads() > 1 && num_buffers > 1 && total_length * num_channels >= PARALLEL_MIN_SAMPLES) {
+        offsets = (uint32_t*)malloc(num_buffers * sizeof(uint32_t));
+    }
+    if (offsets) {
+        // 多线程: 先算出各段的输出位置, 各段并行复制
+        uint32_t offset = 0;
+        for (uint32_t i = 0; i < num_buffers; i++) {
+            offsets[i] = offset;
+            offset += buffers[i].length;
+        }
+        MergeTask task = {buffers, offsets, audio_view_of(output)};
+        task_pool_run(num_buffers, 1, merge_task, &task);
+        free(offsets);
+    } else if (all_planar && format == AUDIO_SAMPLE_F32) {
+        DISPATCH_CHANNELS(num_channels, merge_kernel, buffers, num_buffers, total_length, output->data);
+    } else {
+        // 按视图逐段复制, 布局相同的段整块复制, 不同的段在复制时转换
+        AudioView out = audio_view_of(output);
+        for (uint32_t i = 0; i < num_buffers; i++) {
+            AudioView src = audio_view_of(&buffers[i]);
+            copy_view(&src, view_write_ptr(&out, 0), out.channel_stride, out.frame_stride);
+            out.offset += buffers[i].length;
         }
-        offset += buffers[i].length;
     }
 
     g_memory_buffer.size = buffer_size;
+    CALL_IO(total_length, total_length, buffer_size, buffer_size);
     return total_length;
 }
 
-// 音频重采样 (简单的线性插值)
-// 输入: 源buffer, 目标采样率
-// 输出: 重采样后的数据
-uint32_t wasm_resample_audio(
+// 切片视图 - 不复制数据, 只填写描述符 (O(1))
+// 输入: 源buffer, 起始采样, 长度
+// 输出: view 指向源数据中的片段, 返回视图帧数
+WASM_EXPORT uint32_t wasm_slice_view(
     AudioBuffer* source,
-    uint32_t target_sample_rate,
-    AudioBuffer* output
+    uint32_t start_sample,
+    uint32_t slice_length,
+    AudioView* view
 ) {
-    if (source->sample_rate == target_sample_rate) {
-        // 采样率相同，直接复制
-        return source->length;
+    if (start_sample > source->length) start_sample = source->length;
+    if (start_sample + slice_length > source->length) {
+        slice_length = source->length - start_sample;
     }
 
-    double ratio = (double)target_sample_rate / source->sample_rate;
-    uint32_t target_length = (uint32_t)(source->length * ratio);
-    uint32_t buffer_size = target_length * source->num_channels * sizeof(float);
+    *view = audio_view_of(source);
+    view->offset = start_sample;
+    view->length = slice_length;
+    return slice_length;
+}
 
-    if (buffer_size > g_memory_buffer.capacity) {
-        uint8_t* new_buffer = (uint8_t*)realloc(g_memory_buffer.buffer, buffer_size);
-        if (!new_buffer) return 0;
-        g_memory_buffer.buffer = new_buffer;
-        g_memory_buffer.capacity = buffer_size;
-    }
+// 视图直接编码为 WAV (按视图步长读取, 交错写出), 省去切片复制和 JS 侧的交错
+// 输入: 视图, 位深 (16 / 24)
+// 输出: WAV数据 (存储在g_memory_buffer中)
+WASM_EXPORT uint32_t wasm_view_to_wav(AudioView* view, uint16_t bits_per_sample) {
+    CALL_SCOPE(FUNC_VIEW_TO_WAV);
+
+    uint16_t num_channels = view->num_channels;
+    uint16_t bytes_per_sample = bits_per_sample / 8;
+    uint32_t data_size = view->length * num_channels * bytes_per_sample;
+    uint32_t total_size = 44 + data_size;
+
+    if (!prepare_output_for_view(view, total_size)) return 0;
+
+    write_wav_header((WAVHeader*)g_memory_buffer.buffer, num_channels, view->sample_rate, bits_per_sample, data_size);
+    uint8_t* data_ptr = g_memory_buffer.buffer + 44;
+
+    encode_view_data(view, bits_per_sample, data_ptr);
+
+    g_memory_buffer.size = total_size;
+    CALL_IO(view->length, view->length,
+            view->length * num_channels * audio_sample_bytes(audio_format_of(view->layout)), total_size);
+    return total_size;
+}
+
+// 物化视图: 复制为连续数据, 布局与视图的源数据相同 (只在下游需要自有缓冲区时调用)
+// 输出: 数据存储在g_memory_buffer中, 返回采样点数
+WASM_EXPORT uint32_t wasm_view_materialize(AudioView* view, AudioBuffer* output) {
+    CALL_SCOPE(FUNC_VIEW_MATERIALIZE);
+
+    uint32_t buffer_size = view->length * view->num_channels * audio_sample_bytes(audio_format_of(view->layout));
+    if (!prepare_output_for_view(view, buffer_size)) return 0;
 
     output->data = (float*)g_memory_buffer.buffer;
-    output->length = target_length;
-    output->num_channels = source->num_channels;
-    output->sample_rate = target_sample_rate;
-
-    // 线性插值重采样
-    for (uint16_t ch = 0; ch < source->num_channels; ch++) {
-        float* src = source->data + ch * source->length;
-        float* dst = output->data + ch * target_length;
-
-        for (uint32_t i = 0; i < target_length; i++) {
-            double src_pos = i / ratio;
-            uint32_t src_idx = (uint32_t)src_pos;
-            double frac = src_pos - src_idx;
-
-            if (src_idx >= source->length - 1) {
-                dst[i] = src[source->length - 1];
-            } else {
-                dst[i] = (float)(src[src_idx] * (1 - frac) + src[src_idx + 1] * frac);
-            }
-        }
-    }
+    output->length = view->length;
+    output->num_channels = view->num_channels;
+    output->layout = view->layout;
+    output->sample_rate = view->sample_rate;
+
+    AudioView out = audio_view_of(output);
+    copy_view(view, output->data, out.channel_stride, out.frame_stride);
 
     g_memory_buffer.size = buffer_size;
-    return target_length;
+    CALL_IO(view->length, view->length, buffer_size, buffer_size);
+    return view->length;
 }
 
-// 音音量调整
-// 输入: buffer, 音量倍数
-void wasm_adjust_volume(AudioBuffer* buffer, float volume) {
-    uint32_t total_samples = buffer->length * buffer->num_channels;
-
-    for (uint32_t i = 0; i < total_samples; i++) {
-        buffer->data[i] = fmaxf(-1.0f, fminf(1.0f, buffer->data[i] * volume));
+// 批量切分编码 - 一次调用处理整个任务的全部片段, 省去逐段往返 JS 的开销
+// 输入: 源buffer (任一布局), 片段数组, 片段数, 位深 (16 / 24)
+// 输出: 各片段的 WAV 依次存放在g_memory_buffer中 (每个起点按 4 字节对齐), results[i] 给出位置和大小;
+//       返回输出区总字节数. segments / results 不能位于输出区内 (JS 侧放在源数据之后)
+WASM_EXPORT uint32_t wasm_encode_segments(
+    AudioBuffer* source,
+    const AudioSegment* segments,
+    uint32_t num_segments,
+    uint16_t bits_per_sample,
+    SegmentResult* results
+) {
+    CALL_SCOPE(FUNC_ENCODE_SEGMENTS);
+
+    if (bits_per_sample != 16 && bits_per_sample != 24) return 0;
+
+    AudioView view = audio_view_of(source);
+    uint32_t block_align = source->num_channels * (bits_per_sample / 8);
+    uint32_t total_size = 0;
+    uint32_t total_frames = 0;
+    for (uint32_t i = 0; i < num_segments; i++) {
+        AudioView part = segment_view(&view, &segments[i]);
+        results[i].offset = total_size;
+        results[i].size = 44 + part.length * block_align;
+        results[i].frames = part.length;
+        total_size += (results[i].size + 3) & ~3u;
+        total_frames += part.length;
     }
+
+    if (!prepare_output_for_view(&view, total_size)) return 0;
+
+    BatchEncodeTask task = {&view, segments, results, bits_per_sample};
+    task_pool_run(num_segments, segment_grain(num_segments), encode_segments_task, &task);
+
+    g_memory_buffer.size = total_size;
+    CALL_IO(total_frames, total_frames, total_frames * source->num_channels * buffer_sample_bytes(source), total_size);
+    return total_size;
 }
 
-// 音频交叉淡入淡出
-// 输入: buffer1, buffer2, 淡入淡出点数
-uint32_t wasm_cross_fade(
-    AudioBuffer* buffer1,
-    AudioBuffer* buffer2,
-    uint32_t fade_length,
-    AudioBuffer* output
+// 批量切片 - 各片段复制为独立的连续数据 (布局和样本格式与源相同)
+// 输出: 片段数据依次存放在g_memory_buffer中 (每个起点按 16 字节对齐), results[i] 给出字节偏移 / 字节数 / 帧数;
+//       返回输出区总字节数
+WASM_EXPORT uint32_t wasm_slice_segments(
+    AudioBuffer* source,
+    const AudioSegment* segments,
+    uint32_t num_segments,
+    SegmentResult* results
 ) {
-    uint32_t total_length = buffer1->length + buffer2->length - fade_length;
-    uint16_t num_channels = buffer1->num_channels;
-    uint32_t buffer_size = total_length * num_channels * sizeof(float);
-
-    if (buffer_size > g_memory_buffer.capacity) {
-        uint8_t* new_buffer = (uint8_t*)realloc(g_memory_buffer.buffer, buffer_size);
-        if (!new_buffer) return 0;
-        g_memory_buffer.buffer = new_buffer;
-        g_memory_buffer.capacity = buffer_size;
+    CALL_SCOPE(FUNC_SLICE_SEGMENTS);
+
+    AudioView view = audio_view_of(source);
+    uint32_t frame_bytes = source->num_channels * buffer_sample_bytes(source);
+    uint32_t total_size = 0;
+    uint32_t total_frames = 0;
+    for (uint32_t i = 0; i < num_segments; i++) {
+        AudioView part = segment_view(&view, &segments[i]);
+        results[i].offset = total_size;
+        results[i].size = part.length * frame_bytes;
+        results[i].frames = part.length;
+        total_size += (results[i].size + 15) & ~15u;
+        total_frames += part.length;
     }
 
-    output->data = (float*)g_memory_buffer.buffer;
-    output->length = total_length;
-    output->num_channels = num_channels;
-    output->sample_rate = buffer1->sample_rate;
+    if (!prepare_output_for_view(&view, total_size)) return 0;
 
-    // 复制buffer1的非淡出部分
-    uint32_t offset = 0;
-    for (uint16_t ch = 0; ch < num_channels; ch++) {
-        memcpy(output->data + ch * total_length,
-               buffer1->data + ch * buffer1->length,
-               (buffer1->length - fade_length) * sizeof(float));
-    }
+    BatchSliceTask task = {&view, segments, results};
+    task_pool_run(num_segments, segment_grain(num_segments), slice_segments_task, &task);
 
-    // 交叉淡入淡出
-    for (uint32_t i = 0; i < fade_length; i++) {
-        float fade_out = (float)i / fade_length;
-        float fade_in = 1.0f - fade_out;
+    g_memory_buffer.size = total_size;
+    CALL_IO(total_frames, total_frames, total_frames * frame_bytes, total_size);
+    return total_size;
+}
 
-        for (uint16_t ch = 0; ch < num_channels; ch++) {
-            float* dst = output->data + ch * total_length + (buffer1->length - fade_length) + i;
-            float* src1 = buffer1->data + ch * buffer1->length + (buffer1->length - fade_length) + i;
-            float* src2 = buffer2->data + ch * buffer2->length + i;
+// 分步合并 - 与 wasm_merge_audio_buffers 相同的校验和输出 (布局与第一个buffer相同, 保持样本格式)
+// 输入: buffer 描述符数组 (data 忽略, 数据由 JS 写入 wasm_job_input 返回的位置), 数量
+// 输出: 任务指针, 格式不匹配或内存不足时返回 NULL
+WASM_EXPORT AudioJob* wasm_job_merge_begin(const AudioBuffer* buffers, uint32_t num_buffers) {
+    if (num_buffers == 0) return NULL;
 
-            dst[0] = src1[0] * fade_out + src2[0] * fade_in;
+    AudioBuffer output = buffers[0];
+    output.length = 0;
+    for (uint32_t i = 0; i < num_buffers; i++) {
+        if (buffers[i].num_channels != output.num_channels ||
+            buffers[i].sample_rate != output.sample_rate ||
+            audio_format_of(buffers[i].layout) != audio_format_of(output.layout)) {
+            return NULL; // 格式不匹配
         }
+        output.length += buffers[i].length;
     }
+    return audio_job_create(merge_job_step, buffers, num_buffers, &output);
+}
 
-    // 复制buffer2的非淡入部分
-    offset = buffer1->length - fade_length + fade_length;
-    for (uint16_t ch = 0; ch < num_channels; ch++) {
-        memcpy(output->data + ch * total_length + offset,
-               buffer2->data + ch * buffer2->length + fade_length,
-               (buffer2->length - fade_length) * sizeof(float));
+// 第 index 个输入的描述符 (data 指向任务内存, JS 按描述的布局和格式写入)
+WASM_EXPORT AudioBuffer* wasm_job_input(AudioJob* job, uint32_t index) {
+    return index < job->num_inputs ? &job->inputs[index] : NULL;
+}
+
+// 执行一步: 处理至多 max_frames 个输出帧 (0 为不限), 用时达到 max_ms 毫秒 (0 为不限) 后在下一块之前返回
+// 输出: 剩余的输出帧数, 0 表示完成
+WASM_EXPORT uint32_t wasm_job_step(AudioJob* job, uint32_t max_frames, float max_ms) {
+    CALL_SCOPE(FUNC_JOB_STEP);
+
+    const uint32_t total = job->output.length;
+    const uint32_t start = job->position;
+    uint32_t limit = total;
+    if (max_frames && max_frames < total - start) limit = start + max_frames;
+
+    const double deadline = max_ms > 0 ? audio_now_ms() + max_ms : 0;
+    while (job->position < limit) {
+        uint32_t end = limit - job->position > JOB_CHUNK_FRAMES ? job->position + JOB_CHUNK_FRAMES : limit;
+        job->step(job, job->position, end);
+        job->position = end;
+        if (deadline > 0 && audio_now_ms() >= deadline) break;
     }
 
-    g_memory_buffer.size = buffer_size;
-    return total_length;
+    uint32_t frames = job->position - start;
+    uint32_t bytes = frames * job->output.num_channels * buffer_sample_bytes(&job->output);
+    CALL_IO(frames, frames, bytes, bytes);
+    (void)bytes;
+    return total - job->position;
+}
+
+// 任务输出 (wasm_job_step 返回 0 之后完整; data 在 wasm_job_free 之前有效)
+WASM_EXPORT AudioBuffer* wasm_job_output(AudioJob* job) {
+    return &job->output;
+}
+
+// 释放任务 (完成或中途放弃)
+WASM_EXPORT void wasm_job_free(AudioJob* job) {
+    if (!job) return;
+    free(job->inputs);
+    free(job->input_data);
+    free(job->output.data);
+    free(job);
+}
+
+// 线程数 (含调用线程) - 多线程构建 (AUDIO_THREADS=1) 中合并 / 编码 / 重采样 / 电平分析按段或按块并行
+// 单线程构建恒为 1; 返回实际生效的线程数
+WASM_EXPORT uint32_t wasm_set_threads(uint32_t threads) {
+    return task_pool_set_threads(threads);
+}
+
+WASM_EXPORT uint32_t wasm_get_threads() {
+    return task_pool_threads();
 }
 
 // 获取当前缓冲区大小
-uint32_t wasm_get_buffer_size() {
+WASM_EXPORT uint32_t wasm_get_buffer_size() {
     return g_memory_buffer.size;
 }
 
+#if AUDIO_TRACE
+// 追踪事件缓冲区指针 (TraceEvent 数组, 长度 TRACE_RING_SIZE)
+WASM_EXPORT TraceEvent* wasm_trace_get_events() {
+    return g_trace_events;
+}
+
+// 累计记录的事件数 (超过 TRACE_RING_SIZE 时旧事件已被覆盖)
+WASM_EXPORT uint32_t wasm_trace_get_count() {
+    return g_trace_count;
+}
+
+// 清空追踪事件
+WASM_EXPORT void wasm_trace_clear() {
+    g_trace_count = 0;
+}
+#endif
+
+// 获取统计快照 (AudioStats 结构体指针), 未开启 AUDIO_STATS 时返回 NULL
+WASM_EXPORT void* wasm_get_stats() {
+#if AUDIO_STATS
+    return &g_stats;
+#else
+    return NULL;
+#endif
+}
+
+// 清零统计计数
+WASM_EXPORT void wasm_reset_stats() {
+#if AUDIO_STATS
+    memset(g_stats.funcs, 0, sizeof(g_stats.funcs));
+    g_stats.grow_events = 0;
+    g_stats.peak_capacity = g_memory_buffer.capacity;
+#endif
+}
+
 } // extern "C"
@@ -0,0 +1,222 @@
+// 音频处理 WASM 模块 - 公共类型与导出函数声明
+// audio_processor.cpp (核心) / audio_dsp.cpp / audio_speech.cpp (功能模块) 及本地基准测试 (bench/) 共用
+
+#ifndef AUDIO_PROCESSOR_H
+#define AUDIO_PROCESSOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __EMSCRIPTEN__
+#include <emscripten.h>
+#define WASM_EXPORT EMSCRIPTEN_KEEPALIVE
+#else
+#define WASM_EXPORT
+#endif
+
+// WAV文件头结构
+typedef struct {
+    char riff[4];           // "RIFF"
+    uint32_t file_size;     // 文件大小 - 8
+    char wave[4];           // "WAVE"
+    char fmt[4];            // "fmt "
+    uint32_t fmt_size;      // fmt chunk 大小
+    uint16_t audio_format;  // 音频格式 (1 = PCM)
+    uint16_t num_channels;  // 声道数
+    uint32_t sample_rate;   // 采样率
+    uint32_t byte_rate;     // 字节率
+    uint16_t block_align;   // 块对齐
+    uint16_t bits_per_sample; // 位深
+    char data[4];           // "data"
+    uint32_t data_size;     // 数据大小
+} __attribute__((packed)) WAVHeader;
+
+// 数据布局
+// 平面: 各声道数据依次存放, 第 ch 个声道第 i 帧为 data[ch * length + i] (Web Audio 的 getChannelData 即此布局)
+// 交错: 各帧的所有声道相邻存放, 第 ch 个声道第 i 帧为 data[i * num_channels + ch] (WAV 数据区即此布局)
+#define AUDIO_LAYOUT_PLANAR 0
+#define AUDIO_LAYOUT_INTERLEAVED 1
+
+// 样本格式 - 存放在 layout 的高 8 位 (低 8 位为布局), 只写布局的旧调用方即为 float32
+// 紧凑格式 (int16 / float16) 用于长时间驻留的片段 (等待合并 / 播放), 内存占用减半;
+// 各内核直接读取紧凑格式, 只在处理时逐块展开为 float (见 audio_samples.h)
+#define AUDIO_SAMPLE_F32 0          // float32
+#define AUDIO_SAMPLE_S16 1          // int16, 量化方式与 16 位 WAV 相同 (负数 * 0x8000, 正数 * 0x7FFF)
+#define AUDIO_SAMPLE_F16 2          // IEEE 754 半精度 (11 位有效位, 小幅度信号比 int16 精确)
+#define AUDIO_LAYOUT_MASK 0xFF
+#define AUDIO_FORMAT_SHIFT 8
+
+static inline uint16_t audio_layout_of(uint16_t layout) {
+    return layout & AUDIO_LAYOUT_MASK;
+}
+
+static inline uint16_t audio_format_of(uint16_t layout) {
+    return layout >> AUDIO_FORMAT_SHIFT;
+}
+
+static inline uint16_t audio_make_layout(uint16_t layout, uint16_t format) {
+    return (uint16_t)((layout & AUDIO_LAYOUT_MASK) | (format << AUDIO_FORMAT_SHIFT));
+}
+
+// 每个样本的字节数
+static inline uint32_t audio_sample_bytes(uint16_t format) {
+    return format == AUDIO_SAMPLE_F32 ? 4 : 2;
+}
+
+// 音频缓冲区信息
+// layout 占用 num_channels 之后原有的填充位置, wasm32 下结构体仍为 16 字节
+typedef struct {
+    float* data;            // 音频数据 (紧凑格式时按 int16 / float16 存放)
+    uint32_t length;        // 采样点数
+    uint16_t num_channels;  // 声道数
+    uint16_t layout;        // AUDIO_LAYOUT_PLANAR / AUDIO_LAYOUT_INTERLEAVED, 高 8 位为样本格式
+    uint32_t sample_rate;   // 采样率
+} AudioBuffer;
+
+// 音频视图 - 引用已有数据中的一段, 不持有也不复制数据
+// 第 ch 个声道第 i 帧: base[ch * channel_stride + (offset + i) * frame_stride]
+// 平面布局: channel_stride = 源长度, frame_stride = 1; 交错布局: channel_stride = 1, frame_stride = 声道数
+typedef struct {
+    const float* base;      // 源数据起点 (声道 0 第 0 帧)
+    uint32_t offset;        // 视图起始帧
+    uint32_t length;        // 视图帧数
+    uint16_t num_channels;  // 声道数
+    uint16_t layout;        // 源数据布局 (高 8 位为样本格式)
+    uint32_t sample_rate;   // 采样率
+    uint32_t channel_stride; // 相邻声道的间隔 (样本个数)
+    uint32_t frame_stride;  // 相邻帧的间隔 (样本个数)
+} AudioView;
+
+// 整个 AudioBuffer 的视图 (单声道时两种布局相同, 统一按帧连续处理)
+static inline AudioView audio_view_of(const AudioBuffer* buffer) {
+    AudioView view;
+    int interleaved = audio_layout_of(buffer->layout) == AUDIO_LAYOUT_INTERLEAVED && buffer->num_channels > 1;
+    view.base = buffer->data;
+    view.offset = 0;
+    view.length = buffer->length;
+    view.num_channels = buffer->num_channels;
+    view.layout = audio_make_layout(interleaved ? AUDIO_LAYOUT_INTERLEAVED : AUDIO_LAYOUT_PLANAR,
+                                    audio_format_of(buffer->layout));
+    view.sample_rate = buffer->sample_rate;
+    view.channel_stride = interleaved ? 1 : buffer->length;
+    view.frame_stride = interleaved ? buffer->num_channels : 1;
+    return view;
+}
+
+// 视图中第 ch 个声道第 0 帧的位置, 后续帧间隔 frame_stride
+// 按样本格式计算字节位置; 紧凑格式时返回的指针只表示地址, 需按 int16 / float16 读取
+static inline const float* audio_view_channel(const AudioView* view, uint16_t ch) {
+    size_t index = (size_t)ch * view->channel_stride + (size_t)view->offset * view->frame_stride;
+    return (const float*)((const uint8_t*)view->base + index * audio_sample_bytes(audio_format_of(view->layout)));
+}
+
+// 批量处理的片段 (帧)
+typedef struct {
+    uint32_t start;         // 起始帧
+    uint32_t length;        // 帧数 (超出源数据的部分被截断)
+} AudioSegment;
+
+// 批量处理中一个片段的输出位置
+typedef struct {
+    uint32_t offset;        // 相对 g_memory_buffer 起点的字节偏移
+    uint32_t size;          // 字节数
+    uint32_t frames;        // 截断后的帧数
+} SegmentResult;
+
+// 电平分析结果 (wasm_analyze_audio 每块一项, 线性幅度)
+typedef struct {
+    float rms;              // 均方根
+    float peak;             // 峰值绝对值
+} AudioLevel;
+
+// 分步任务 (wasm_job_*), 结构体定义见 audio_internal.h, JS 只持有指针
+typedef struct AudioJob AudioJob;
+
+// 简单的内存管理器
+typedef struct {
+    uint8_t* buffer;
+    uint32_t size;
+    uint32_t capacity;
+} MemoryBuffer;
+
+extern MemoryBuffer g_memory_buffer;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 内存管理
+uint32_t wasm_init_memory(uint32_t size);
+uint8_t* wasm_get_memory_buffer();
+void wasm_cleanup();
+uint32_t wasm_get_buffer_size();
+
+// 格式转换 (wasm_audio_buffer_to_wav 输入为交错数据; wasm_wav_to_audio_buffer 输出交错布局)
+uint32_t wasm_audio_buffer_to_wav(float* audio_data, uint32_t length, uint16_t num_channels,
+                                  uint32_t sample_rate, uint16_t bits_per_sample);
+uint32_t wasm_wav_to_audio_buffer(uint8_t* wav_data, uint32_t wav_size, AudioBuffer* output);
+
+// 切片 / 合并 / 重采样 / 音量 / 交叉淡化
+// 输入可以是任一布局 (由 layout 区分), 输出与 (第一个) 输入布局相同
+// 切片 / 合并 / 音量保持紧凑格式; 重采样 / 交叉淡化读取任一格式, 输出 float32
+uint32_t wasm_slice_audio(AudioBuffer* source, uint32_t start_sample, uint32_t slice_length);
+uint32_t wasm_merge_audio_buffers(AudioBuffer* buffers, uint32_t num_buffers, AudioBuffer* output);
+uint32_t wasm_resample_audio(AudioBuffer* source, uint32_t target_sample_rate, AudioBuffer* output);
+void wasm_adjust_volume(AudioBuffer* buffer, float volume);
+uint32_t wasm_cross_fade(AudioBuffer* buffer1, AudioBuffer* buffer2, uint32_t fade_length,
+                         AudioBuffer* output);
+
+// 样本格式转换 (float32 / int16 / float16 互转, 布局不变), 输出存储在g_memory_buffer中
+uint32_t wasm_convert_samples(AudioBuffer* source, uint16_t format, AudioBuffer* output);
+
+// 类语音测试信号
+uint32_t wasm_generate_speech(uint32_t frames, uint32_t sample_rate, uint16_t num_channels,
+                              uint32_t seed, float peak);
+
+// 切片视图: wasm_slice_view 只填写描述符, 下游函数直接读取源数据, 需要连续数据时再物化
+uint32_t wasm_slice_view(AudioBuffer* source, uint32_t start_sample, uint32_t slice_length, AudioView* view);
+uint32_t wasm_view_to_wav(AudioView* view, uint16_t bits_per_sample);
+uint32_t wasm_view_materialize(AudioView* view, AudioBuffer* output);
+uint32_t wasm_resample_view(AudioView* view, uint32_t target_sample_rate, AudioBuffer* output);
+
+// 批量处理: 一次调用处理全部片段, 输出依次存放在 g_memory_buffer 中, 位置写入 results
+uint32_t wasm_encode_segments(AudioBuffer* source, const AudioSegment* segments, uint32_t num_segments,
+                              uint16_t bits_per_sample, SegmentResult* results);
+uint32_t wasm_slice_segments(AudioBuffer* source, const AudioSegment* segments, uint32_t num_segments,
+                             SegmentResult* results);
+
+// 融合流水线 (增益 -> [高通] -> 限幅 -> 输出, 单遍处理)
+uint32_t wasm_gain_to_wav(AudioBuffer* source, float gain);
+uint32_t wasm_process_to_wav(AudioBuffer* source, float gain, float highpass_hz);
+uint32_t wasm_process_audio(AudioBuffer* source, float gain, float highpass_hz, AudioBuffer* output);
+
+// 电平分析 (按块 RMS / 峰值)
+uint32_t wasm_analyze_audio(AudioBuffer* source, uint32_t block_frames);
+
+// 参考音频预处理 (单声道 / 重采样 / 裁剪静音 / 截取有声帧 RMS 之和最大的窗口)
+uint32_t wasm_prepare_reference(AudioBuffer* source, uint32_t target_sample_rate, float max_seconds,
+                                float silence_db, AudioBuffer* output);
+
+// 分步执行 (长输入不阻塞主线程): begin 创建任务并分配内存, JS 通过 wasm_job_input 写入输入,
+// 反复调用 wasm_job_step (每次处理至多 max_frames 帧或 max_ms 毫秒, 返回剩余帧数) 直到返回 0,
+// 从 wasm_job_output 读出结果后 wasm_job_free; 结果与对应的一次性调用逐位一致
+AudioJob* wasm_job_merge_begin(const AudioBuffer* buffers, uint32_t num_buffers);
+AudioJob* wasm_job_resample_begin(const AudioBuffer* source, uint32_t target_sample_rate);
+AudioBuffer* wasm_job_input(AudioJob* job, uint32_t index);
+uint32_t wasm_job_step(AudioJob* job, uint32_t max_frames, float max_ms);
+AudioBuffer* wasm_job_output(AudioJob* job);
+void wasm_job_free(AudioJob* job);
+
+// 线程数 (多线程构建 AUDIO_THREADS=1 时有效, 见 task_pool.h)
+uint32_t wasm_set_threads(uint32_t threads);
+uint32_t wasm_get_threads();
+
+// 统计计数 (AUDIO_STATS=1 时有效)
+void* wasm_get_stats();
+void wasm_reset_stats();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // AUDIO_PROCESSOR_H
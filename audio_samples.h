@@ -0,0 +1,108 @@
+// 样本格式转换 - float32 与紧凑格式 (int16 / float16, 见 audio_processor.h 中的 AUDIO_SAMPLE_*) 互转
+//
+// 紧凑格式只用于存放; 内核需要 float 时按块展开 (audio_view_read 读入栈上的小块), 不复制整段数据.
+// 连续读写 (步长为 1) 的循环没有分支依赖, 编译器可以向量化 (wasm SIMD / SSE).
+
+#ifndef AUDIO_SAMPLES_H
+#define AUDIO_SAMPLES_H
+
+#include <math.h>
+#include <string.h>
+
+#include "audio_processor.h"
+
+// int16 <-> float, 与 16 位 WAV 编解码相同
+static inline float audio_s16_to_float(int16_t v) {
+    return (float)v / (v < 0 ? 0x8000 : 0x7FFF);
+}
+
+static inline int16_t audio_float_to_s16(float x) {
+    x = fmaxf(-1.0f, fminf(1.0f, x));
+    return (int16_t)(x < 0 ? x * 0x8000 : x * 0x7FFF);
+}
+
+// float16 -> float (精确)
+static inline float audio_f16_to_float(uint16_t h) {
+    uint32_t sign = (uint32_t)(h & 0x8000) << 16;
+    uint32_t exp = (h >> 10) & 0x1F;
+    uint32_t mant = h & 0x3FF;
+    uint32_t bits;
+    if (exp == 0) {
+        // 零 / 非规格化数: mant * 2^-24
+        float f = (float)mant * (1.0f / 16777216.0f);
+        return sign ? -f : f;
+    } else if (exp == 31) {
+        bits = sign | 0x7F800000 | (mant << 13);    // Inf / NaN
+    } else {
+        bits = sign | ((exp + 112) << 23) | (mant << 13);
+    }
+    float f;
+    memcpy(&f, &bits, sizeof(f));
+    return f;
+}
+
+// float -> float16 (就近舍入到偶数, 超出范围为 Inf)
+static inline uint16_t audio_float_to_f16(float f) {
+    uint32_t bits;
+    memcpy(&bits, &f, sizeof(bits));
+    uint16_t sign = (uint16_t)((bits >> 16) & 0x8000);
+    uint32_t abs_bits = bits & 0x7FFFFFFF;
+    if (abs_bits >= 0x7F800000) {
+        return sign | 0x7C00 | (abs_bits > 0x7F800000 ? 0x200 : 0);
+    }
+    if (abs_bits >= 0x477FF000) {
+        return sign | 0x7C00;   // >= 65520
+    }
+    if (abs_bits < 0x38800000) {
+        // 小于 2^-14: 非规格化数, 乘 2^24 后舍入 (乘 2 的幂是精确的)
+        float a;
+        memcpy(&a, &abs_bits, sizeof(a));
+        return sign | (uint16_t)lrintf(a * 16777216.0f);
+    }
+    uint32_t h = (abs_bits - 0x38000000) >> 13;   // 指数偏置 127 -> 15
+    uint32_t rest = abs_bits & 0x1FFF;
+    if (rest > 0x1000 || (rest == 0x1000 && (h & 1))) h++;
+    return sign | (uint16_t)h;
+}
+
+// 从 src 读取 n 个样本 (间隔 stride 个样本) 展开为连续的 float
+static inline void audio_widen(const void* src, uint16_t format, size_t stride, uint32_t n, float* dst) {
+    if (format == AUDIO_SAMPLE_S16) {
+        const int16_t* s = (const int16_t*)src;
+        for (uint32_t i = 0; i < n; i++) dst[i] = audio_s16_to_float(s[(size_t)i * stride]);
+    } else if (format == AUDIO_SAMPLE_F16) {
+        const uint16_t* s = (const uint16_t*)src;
+        for (uint32_t i = 0; i < n; i++) dst[i] = audio_f16_to_float(s[(size_t)i * stride]);
+    } else if (stride == 1) {
+        memcpy(dst, src, n * sizeof(float));
+    } else {
+        const float* s = (const float*)src;
+        for (uint32_t i = 0; i < n; i++) dst[i] = s[(size_t)i * stride];
+    }
+}
+
+// 连续的 n 个 float 压缩写入 dst (间隔 stride 个样本)
+static inline void audio_narrow(const float* src, uint32_t n, uint16_t format, void* dst, size_t stride) {
+    if (format == AUDIO_SAMPLE_S16) {
+        int16_t* d = (int16_t*)dst;
+        for (uint32_t i = 0; i < n; i++) d[(size_t)i * stride] = audio_float_to_s16(src[i]);
+    } else if (format == AUDIO_SAMPLE_F16) {
+        uint16_t* d = (uint16_t*)dst;
+        for (uint32_t i = 0; i < n; i++) d[(size_t)i * stride] = audio_float_to_f16(src[i]);
+    } else if (stride == 1) {
+        memcpy(dst, src, n * sizeof(float));
+    } else {
+        float* d = (float*)dst;
+        for (uint32_t i = 0; i < n; i++) d[(size_t)i * stride] = src[i];
+    }
+}
+
+// 读取视图第 ch 个声道从 start 帧开始的 n 帧, 展开为 float
+static inline void audio_view_read(const AudioView* view, uint16_t ch, uint32_t start, uint32_t n, float* dst) {
+    const uint16_t format = audio_format_of(view->layout);
+    const uint8_t* src = (const uint8_t*)audio_view_channel(view, ch) +
+                         (size_t)start * view->frame_stride * audio_sample_bytes(format);
+    audio_widen(src, format, view->frame_stride, n, dst);
+}
+
+#endif // AUDIO_SAMPLES_H
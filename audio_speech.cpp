@@ -0,0 +1,34 @@
+// 音频处理 WASM 模块 - 测试信号功能模块 (基准测试 / 校准用, 页面的正常流程不需要)
+
+#include "audio_internal.h"
+#include "speech_synth.h"
+
+extern "C" {
+
+// 生成类语音测试信号 (见 speech_synth.h)
+// 输入: 采样点数, 采样率, 声道数, 随机种子, 峰值幅度
+// 输出: 平面布局的浮点数据 (存储在g_memory_buffer中)
+WASM_EXPORT uint32_t wasm_generate_speech(
+    uint32_t frames,
+    uint32_t sample_rate,
+    uint16_t num_channels,
+    uint32_t seed,
+    float peak
+) {
+    CALL_SCOPE(FUNC_GENERATE_SPEECH);
+
+    if (num_channels == 0 || num_channels > SPEECH_SYNTH_MAX_CHANNELS) return 0;
+
+    uint32_t buffer_size = frames * num_channels * sizeof(float);
+
+    if (!ensure_buffer_capacity(buffer_size)) return 0;
+
+    SpeechSynthParams params = {sample_rate, num_channels, seed, peak};
+    speech_synth_generate(&params, (float*)g_memory_buffer.buffer, frames);
+
+    g_memory_buffer.size = buffer_size;
+    CALL_IO(0, frames, 0, buffer_size);
+    return frames;
+}
+
+} // extern "C"
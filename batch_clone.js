@@ -0,0 +1,88 @@
+/**
+ * 多音色批量克隆 - 同一段 TTS 音频克隆成 K 个音色
+ * TTS / 解码 / 切分 / WAV 编码 / base64 只做一次 (与音色数无关), K × N 个克隆请求由一个调度器按同一并发上限执行.
+ * 请求按片段优先排列 (片段 0 的全部音色, 然后片段 1 ...): 各音色进度大致同步, 输入片段对所有音色都结束后即可释放.
+ * 每个音色有自己的结果数组和合并步骤: 一个音色的片段全部结束就开始合并, 不等待其他音色.
+ * 浏览器中挂到 window，Node 中通过 module.exports 导出
+ */
+(function(root) {
+    /**
+     * 执行批量克隆
+     * @param {Object} job
+     * @param {Array<Object>} job.segments - 切分好的片段 (所有音色共用)
+     * @param {Array<Object>} job.voices - 音色列表 (内容由调用方决定, 原样传给回调)
+     * @param {number} job.concurrency - 同时进行的请求数上限 (所有音色合计)
+     * @param {Function} job.clone - async (voice, segment, voiceIndex) => 克隆结果
+     * @param {Function} [job.onSegment] - (voice, segment, error, voiceIndex) 每个请求结束时调用, 成功时 error 为 null
+     * @param {Function} [job.release] - (segment) 片段对所有音色都已结束, 输入数据可以释放
+     * @param {Function} [job.onVoiceDone] - async (voice, results, voiceIndex) 某个音色的全部片段结束时调用 (合并),
+     *                                       返回值存为该音色的 output; 不阻塞其他请求
+     * @returns {Promise<Array<{voice, results, succeeded, failed, output, error}>>}
+     *          results[i] 为片段 i 的结果 (失败时为 undefined); onVoiceDone 抛出的错误记在 error 中
+     */
+    async function runBatchClone(job) {
+        const { segments, voices, clone, onSegment, release, onVoiceDone } = job;
+        const numVoices = voices.length;
+        const numSegments = segments.length;
+        const total = numVoices * numSegments;
+
+        const tracks = voices.map(voice => ({
+            voice,
+            results: new Array(numSegments),
+            remaining: numSegments,
+            succeeded: 0,
+            failed: 0,
+            output: null,
+            error: null
+        }));
+        const segmentRemaining = new Array(numSegments).fill(numVoices);
+        const merges = [];
+
+        const finishVoice = (track, v) => {
+            if (!onVoiceDone) return;
+            merges.push(Promise.resolve()
+                .then(() => onVoiceDone(track.voice, track.results, v))
+                .then(output => { track.output = output; }, error => { track.error = error; }));
+        };
+
+        const runTask = async t => {
+            const s = Math.floor(t / numVoices);
+            const v = t % numVoices;
+            const track = tracks[v];
+            const segment = segments[s];
+            try {
+                track.results[s] = await clone(track.voice, segment, v);
+                track.succeeded++;
+                if (onSegment) onSegment(track.voice, segment, null, v);
+            } catch (error) {
+                track.failed++;
+                if (onSegment) onSegment(track.voice, segment, error, v);
+            }
+            if (--segmentRemaining[s] === 0 && release) release(segment);
+            if (--track.remaining === 0) finishVoice(track, v);
+        };
+
+        // 受控并发: 一个请求结束立即开始下一个 (不按批次等待)
+        let next = 0;
+        const workers = [];
+        const limit = Math.max(1, Math.min(job.concurrency || 1, total));
+        for (let w = 0; w < limit; w++) {
+            workers.push((async () => {
+                while (next < total) {
+                    await runTask(next++);
+                }
+            })());
+        }
+        await Promise.all(workers);
+        await Promise.all(merges);
+        return tracks;
+    }
+
+    const api = { runBatchClone };
+
+    if (typeof module !== 'undefined' && module.exports) {
+        module.exports = api;
+    } else {
+        Object.assign(root, api);
+    }
+})(typeof window !== 'undefined' ? window : globalThis);
@@ -0,0 +1,1244 @@
+// 音频处理模块本地基准测试 - 覆盖全部导出的 DSP 函数
+// 在宿主机上编译 audio_processor.cpp, 输入为 speech_synth 生成的类语音信号 (固定种子),
+// 输出 Google Benchmark 风格的 JSON
+//
+// 每个用例在计时之外额外运行一次, 与 bench/reference_kernels.cpp 中冻结的标量参考实现对比
+// (audio_metrics.h), 质量指标与吞吐量一起写入 JSON; 超出 kThresholds 容差时退出码为 2
+// multipass_* 与对应的融合版本 (audio_pipeline.h) 处理链相同, 用于比较多遍处理与单遍处理的带宽
+// */threads:N 用例在多线程构建中以 N 个线程运行可并行的函数 (合并 / 编码 / 重采样 / 电平分析), 报告扩展性
+// *_interleaved 用例以交错布局输入 (AudioBuffer.layout) 调用同一函数, 输出解交错后同样与参考实现对比
+// *_s16 / *_f16 用例以紧凑样本格式 (int16 / float16) 输入, 读取的字节数为 float 的一半
+// *_sliced 用例通过分步接口 (wasm_job_*) 执行, 每步 kJobStepMs 毫秒; 与一次性版本一样只计算处理时间
+//   (创建任务和把输入写入任务内存不计时), JSON 中的 step_overhead_pct 为相对一次性版本多用的时间
+//
+// 编译:
+//   g++ -O2 -std=c++11 -I. bench/bench_audio.cpp bench/reference_kernels.cpp audio_processor.cpp audio_dsp.cpp audio_speech.cpp audio_metrics.cpp speech_synth.cpp task_pool.cpp -o bench/bench_audio
+// 多线程构建 (threads:N 用例才会超过 1 个线程):
+//   g++ -O2 -std=c++11 -pthread -DAUDIO_THREADS=1 -I. bench/bench_audio.cpp bench/reference_kernels.cpp audio_processor.cpp audio_dsp.cpp audio_speech.cpp audio_metrics.cpp speech_synth.cpp task_pool.cpp -o bench/bench_audio_mt
+// 运行:
+//   ./bench/bench_audio                          # 全部组合, JSON 输出到 stdout
+//   ./bench/bench_audio --filter=to_wav          # 只跑名称包含 to_wav 的用例
+//   ./bench/bench_audio --max_duration=60        # 跳过超过 60 秒的输入
+//   ./bench/bench_audio --max_duration=7200      # 包含 2 小时输入 (默认最长 1 小时)
+//   ./bench/bench_audio --min_time=0.5 --out=bench_output.txt
+//   ./bench/bench_audio --quality_max_duration=0   # 不做质量对比 (默认只对比 600 秒及以下的输入)
+//   ./bench/bench_audio_mt --threads=1,2,4,8       # 扩展性用例的线程数 (默认 1,2,4,8; 超过构建支持的线程数时跳过)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#include <string>
+#include <vector>
+
+#include "audio_processor.h"
+#include "audio_metrics.h"
+#include "audio_pipeline.h"
+#include "speech_synth.h"
+#include "task_pool.h"
+#include "reference_kernels.h"
+
+// 基准测试参数
+static const uint32_t kDurations[] = {1, 10, 60, 600, 3600, 7200};    // 秒
+static const uint32_t kSignalSeed = 1;
+static const float kSignalPeak = 1.2f;      // 最响的语句略超过 1.0, 覆盖削波分支
+static const uint32_t kSampleRates[] = {16000, 22050, 24000, 48000};
+static const uint16_t kChannels[] = {1, 2};
+static const float kPipelineGain = 0.9f;
+static const float kPipelineHighpass = 80.0f;  // Hz
+static const float kJobStepMs = 8.0f;          // 分步用例每步的时间预算 (约半个 60Hz 帧)
+
+// 各函数相对参考实现的容差
+// 只做数据搬运的函数要求逐位一致; 浮点运算允许改变运算顺序带来的舍入误差
+struct QualityThreshold {
+    const char* func;
+    double max_abs_err;         // 最大绝对误差上限
+    double min_snr_db;          // SNR 下限
+    double max_spectral_db;     // 对数谱距离上限
+    double max_click_rise_db;   // 接缝咔嗒能量相对参考实现的最大增量 (只对有接缝的函数)
+};
+
+static const QualityThreshold kThresholds[] = {
+    {"audio_buffer_to_wav", 1.0 / 32768, 60.0, 0.5, 0.0},   // 舍入方式不同时最多差 1 LSB
+    {"wav_to_audio_buffer", 1e-6, 120.0, 0.01, 0.0},
+    {"slice_audio", 0.0, METRIC_MAX_DB, 0.0, 0.0},
+    {"merge_audio_buffers", 0.0, METRIC_MAX_DB, 0.0, 0.0},
+    {"resample_audio", 1e-3, 60.0, 1.0, 0.0},
+    {"merge_audio_buffers_sliced", 0.0, METRIC_MAX_DB, 0.0, 0.0},
+    {"resample_audio_sliced", 1e-3, 60.0, 1.0, 0.0},
+    {"adjust_volume", 1e-6, 120.0, 0.01, 0.0},
+    {"analyze_audio", 1e-6, 120.0, 0.01, 0.0},
+    {"prepare_reference", 1e-6, 120.0, 0.01, 0.0},
+    {"cross_fade", 1e-6, 100.0, 0.01, 1.0},
+    {"cross_fade_region", 1e-6, 100.0, 0.01, 1.0},
+    {"split_encode_copy", 0.0, METRIC_MAX_DB, 0.0, 0.0},
+    {"split_encode_view", 0.0, METRIC_MAX_DB, 0.0, 0.0},
+    {"split_encode_batch", 0.0, METRIC_MAX_DB, 0.0, 0.0},
+    {"multipass_gain_to_wav", 0.0, METRIC_MAX_DB, 0.0, 0.0},
+    {"gain_to_wav", 0.0, METRIC_MAX_DB, 0.0, 0.0},
+    {"multipass_process_to_wav", 1.0 / 32768, 60.0, 0.5, 0.0},
+    {"process_to_wav", 1.0 / 32768, 60.0, 0.5, 0.0},
+    // 交错布局输入, 与平面布局的参考实现对比 (容差与平面版本相同)
+    {"slice_audio_interleaved", 0.0, METRIC_MAX_DB, 0.0, 0.0},
+    {"merge_audio_buffers_interleaved", 0.0, METRIC_MAX_DB, 0.0, 0.0},
+    {"resample_audio_interleaved", 1e-3, 60.0, 1.0, 0.0},
+    {"cross_fade_interleaved", 1e-6, 100.0, 0.01, 1.0},
+    {"cross_fade_mixed", 1e-6, 100.0, 0.01, 1.0},
+    {"split_encode_interleaved", 0.0, METRIC_MAX_DB, 0.0, 0.0},
+    {"process_to_wav_interleaved", 1.0 / 32768, 60.0, 0.5, 0.0},
+    // 紧凑格式: int16 与 16 位 PCM 往返逐位一致; float16 有 11 位有效位, 不削波
+    {"convert_samples_s16", 0.0, METRIC_MAX_DB, 0.0, 0.0},
+    {"convert_samples_f16", 1e-3, 60.0, 0.5, 0.0},
+    {"merge_audio_buffers_s16", 0.0, METRIC_MAX_DB, 0.0, 0.0},
+    {"split_encode_s16", 0.0, METRIC_MAX_DB, 0.0, 0.0},
+    {"process_to_wav_s16", 1.0 / 32768, 60.0, 0.5, 0.0},
+};
+
+struct BenchOptions {
+    std::string filter;
+    uint32_t max_duration;
+    double min_time;        // 每个用例最少运行时间 (秒)
+    const char* out_path;
+    uint32_t quality_max_duration;  // 超过该时长的输入不做质量对比 (参考输出需要额外内存)
+    std::vector<uint32_t> threads;  // 扩展性用例的线程数
+};
+
+struct BenchCase {
+    uint32_t duration;
+    uint32_t sample_rate;
+    uint16_t channels;
+    uint32_t frames;
+    uint32_t threads;       // 扩展性用例的线程数 (0 表示普通用例)
+};
+
+// 单个用例的计时结果
+struct BenchResult {
+    std::string name;
+    uint64_t iterations;
+    double real_time_ms;    // 每次迭代耗时
+    double frames_per_second;
+    double bytes_per_second;
+
+    // 与参考实现的对比 (has_quality 为 false 时未对比)
+    bool has_quality;
+    bool quality_pass;
+    AudioQuality quality;
+    bool has_seams;
+    double seam_click_db;       // 优化实现输出的接缝咔嗒能量
+    double ref_seam_click_db;   // 参考实现输出的接缝咔嗒能量
+
+    // 分步用例: 同一输入的一次性版本耗时 (has_baseline 为 false 时没有)
+    bool has_baseline;
+    double baseline_ms;
+};
+
+static double now_seconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// 反复执行 fn 直到累计时间超过 min_time, 返回每次迭代的平均耗时 (秒)
+template <typename Fn>
+static double run_timed(Fn fn, double min_time, uint64_t* iterations) {
+    uint64_t iters = 1;
+    for (;;) {
+        double start = now_seconds();
+        for (uint64_t i = 0; i < iters; i++) fn();
+        double elapsed = now_seconds() - start;
+        if (elapsed >= min_time || iters >= (1ull << 30)) {
+            *iterations = iters;
+            return elapsed / iters;
+        }
+        // 按已测速度估算下一轮迭代次数, 至少翻倍
+        double scale = elapsed > 0 ? min_time * 1.4 / elapsed : 10.0;
+        uint64_t next = (uint64_t)(iters * scale);
+        iters = next > iters * 2 ? next : iters * 2;
+    }
+}
+
+// 同 run_timed, 但每次迭代前先执行 setup, 只计 fn 的耗时
+template <typename Setup, typename Fn>
+static double run_timed_setup(Setup setup, Fn fn, double min_time, uint64_t* iterations) {
+    uint64_t iters = 1;
+    for (;;) {
+        double elapsed = 0;
+        for (uint64_t i = 0; i < iters; i++) {
+            setup();
+            double start = now_seconds();
+            fn();
+            elapsed += now_seconds() - start;
+        }
+        if (elapsed >= min_time || iters >= (1ull << 30)) {
+            *iterations = iters;
+            return elapsed / iters;
+        }
+        double scale = elapsed > 0 ? min_time * 1.4 / elapsed : 10.0;
+        uint64_t next = (uint64_t)(iters * scale);
+        iters = next > iters * 2 ? next : iters * 2;
+    }
+}
+
+static std::string case_name(const char* func, const BenchCase& c) {
+    char buf[128];
+    int len = snprintf(buf, sizeof(buf), "%s/%us/%uHz/%uch", func, c.duration, c.sample_rate, c.channels);
+    if (c.threads) snprintf(buf + len, sizeof(buf) - len, "/threads:%u", c.threads);
+    return buf;
+}
+
+static void print_result(FILE* out, const BenchResult& r, bool last) {
+    fprintf(out,
+            "    {\n"
+            "      \"name\": \"%s\",\n"
+            "      \"iterations\": %llu,\n"
+            "      \"real_time\": %.6f,\n"
+            "      \"time_unit\": \"ms\",\n"
+            "      \"frames_per_second\": %.1f,\n"
+            "      \"bytes_per_second\": %.1f",
+            r.name.c_str(), (unsigned long long)r.iterations, r.real_time_ms,
+            r.frames_per_second, r.bytes_per_second);
+    if (r.has_quality) {
+        fprintf(out,
+                ",\n"
+                "      \"snr_db\": %.2f,\n"
+                "      \"seg_snr_db\": %.2f,\n"
+                "      \"max_abs_err\": %.9g,\n"
+                "      \"spectral_db\": %.4f",
+                r.quality.snr_db, r.quality.seg_snr_db, r.quality.max_abs_err, r.quality.spectral_db);
+        if (r.has_seams) {
+            fprintf(out, ",\n      \"seam_click_db\": %.2f,\n      \"ref_seam_click_db\": %.2f",
+                    r.seam_click_db, r.ref_seam_click_db);
+        }
+        fprintf(out, ",\n      \"quality_pass\": %s", r.quality_pass ? "true" : "false");
+    }
+    if (r.has_baseline) {
+        fprintf(out, ",\n      \"one_shot_time\": %.6f,\n      \"step_overhead_pct\": %.2f",
+                r.baseline_ms, (r.real_time_ms / r.baseline_ms - 1.0) * 100.0);
+    }
+    fprintf(out, "\n    }%s\n", last ? "" : ",");
+}
+
+static const QualityThreshold* find_threshold(const char* func) {
+    for (size_t i = 0; i < sizeof(kThresholds) / sizeof(kThresholds[0]); i++) {
+        if (strcmp(kThresholds[i].func, func) == 0) return &kThresholds[i];
+    }
+    return NULL;
+}
+
+// 平面布局多声道信号中所有声道的最大接缝咔嗒能量
+static double seam_click_db(const float* data, uint32_t frames, uint16_t channels,
+                            const std::vector<uint32_t>& seams, uint32_t sample_rate) {
+    double worst = -METRIC_MAX_DB;
+    for (uint16_t ch = 0; ch < channels; ch++) {
+        double db = metric_seam_click_db(data + (size_t)ch * frames, frames, seams.data(),
+                                         (uint32_t)seams.size(), sample_rate);
+        if (db > worst) worst = db;
+    }
+    return worst;
+}
+
+// 对比优化实现 (test) 与参考实现 (ref) 的输出, 结果记入 r
+// 两者均为 frames x channels 的平面布局; seams 非空时额外比较接缝咔嗒能量
+static void check_quality(BenchResult* r, const char* func, const float* ref, const float* test,
+                          uint32_t frames, uint16_t channels, uint32_t sample_rate,
+                          const std::vector<uint32_t>& seams) {
+    const QualityThreshold* t = find_threshold(func);
+    r->has_quality = true;
+    metric_compare(ref, test, (size_t)frames * channels, sample_rate, &r->quality);
+
+    r->quality_pass = r->quality.max_abs_err <= t->max_abs_err &&
+                      r->quality.snr_db >= t->min_snr_db &&
+                      r->quality.spectral_db <= t->max_spectral_db;
+
+    r->has_seams = !seams.empty();
+    if (r->has_seams) {
+        r->seam_click_db = seam_click_db(test, frames, channels, seams, sample_rate);
+        r->ref_seam_click_db = seam_click_db(ref, frames, channels, seams, sample_rate);
+        if (r->seam_click_db > r->ref_seam_click_db + t->max_click_rise_db) r->quality_pass = false;
+    }
+
+    if (!r->quality_pass) {
+        fprintf(stderr, "  质量不达标: snr %.2f dB, max_abs_err %.3g, spectral %.4f dB\n",
+                r->quality.snr_db, r->quality.max_abs_err, r->quality.spectral_db);
+    }
+}
+
+// 输出帧数不一致时直接判定失败, 各指标记为最差值
+static void fail_quality(BenchResult* r, uint32_t ref_frames, uint32_t test_frames) {
+    r->has_quality = true;
+    r->quality_pass = false;
+    r->quality.snr_db = -METRIC_MAX_DB;
+    r->quality.seg_snr_db = -10.0;
+    r->quality.max_abs_err = METRIC_MAX_DB;
+    r->quality.spectral_db = METRIC_MAX_DB;
+    fprintf(stderr, "  输出长度不一致: 参考 %u 帧, 实测 %u 帧\n", ref_frames, test_frames);
+}
+
+// 记录一次结果; frames 为每次迭代处理的输入帧数, bytes 为读写字节总数
+// timer(&iterations) 运行用例并返回每次迭代的平均耗时 (秒)
+// 返回刚记录的结果 (被 --filter 跳过时返回 NULL), 下一次调用前有效
+template <typename Timer>
+static BenchResult* bench_timed(std::vector<BenchResult>& results, const BenchOptions& opt,
+                                const char* func, const BenchCase& c, double frames, double bytes, Timer timer) {
+    BenchResult r;
+    r.name = case_name(func, c);
+    if (!opt.filter.empty() && r.name.find(opt.filter) == std::string::npos) return NULL;
+    r.has_quality = false;
+    r.quality_pass = true;
+    r.has_seams = false;
+    r.has_baseline = false;
+
+    double per_iter = timer(&r.iterations);
+    r.real_time_ms = per_iter * 1000.0;
+    r.frames_per_second = frames / per_iter;
+    r.bytes_per_second = bytes / per_iter;
+    results.push_back(r);
+    fprintf(stderr, "%-48s %10.3f ms  %8.1f Mframes/s\n", r.name.c_str(), r.real_time_ms,
+            r.frames_per_second / 1e6);
+    return &results.back();
+}
+
+template <typename Fn>
+static BenchResult* bench(std::vector<BenchResult>& results, const BenchOptions& opt,
+                          const char* func, const BenchCase& c, double frames, double bytes, Fn fn) {
+    return bench_timed(results, opt, func, c, frames, bytes, [&](uint64_t* iterations) {
+        return run_timed(fn, opt.min_time, iterations);
+    });
+}
+
+// 分步用例: 每次迭代前执行 setup (不计时), 结果中记录一次性版本的耗时 baseline_ms (为 0 时不记录)
+template <typename Setup, typename Fn>
+static BenchResult* bench_stepped(std::vector<BenchResult>& results, const BenchOptions& opt,
+                                  const char* func, const BenchCase& c, double frames, double bytes,
+                                  double baseline_ms, Setup setup, Fn fn) {
+    BenchResult* r = bench_timed(results, opt, func, c, frames, bytes, [&](uint64_t* iterations) {
+        return run_timed_setup(setup, fn, opt.min_time, iterations);
+    });
+    if (r && baseline_ms > 0) {
+        r->has_baseline = true;
+        r->baseline_ms = baseline_ms;
+        fprintf(stderr, "  分步开销: %+.1f%% (一次性 %.3f ms)\n",
+                (r->real_time_ms / baseline_ms - 1.0) * 100.0, baseline_ms);
+    }
+    return r;
+}
+
+// 把 float32 输入写入任务内存 (同 JS 侧上传)
+// 同时预先写一遍输出内存: 宿主机上大块 malloc 是新映射的页, 首次写入的缺页会计入分步时间,
+// 而一次性版本复用已映射的 g_memory_buffer (WASM 线性内存也没有这部分开销)
+static void upload_job(AudioJob* job, const AudioBuffer* inputs, uint32_t num_inputs) {
+    if (!job) return;
+    for (uint32_t i = 0; i < num_inputs; i++) {
+        memcpy(wasm_job_input(job, i)->data, inputs[i].data,
+               (size_t)inputs[i].length * inputs[i].num_channels * sizeof(float));
+    }
+    const AudioBuffer* output = wasm_job_output(job);
+    memset(output->data, 0, (size_t)output->length * output->num_channels * sizeof(float));
+}
+
+// 分步执行: 每步至多 kJobStepMs 毫秒直到完成
+// 返回任务输出 (job 为 NULL 时返回 NULL), 读完后由调用方 wasm_job_free
+static AudioBuffer* step_job(AudioJob* job) {
+    if (!job) return NULL;
+    while (wasm_job_step(job, 0, kJobStepMs) > 0) {}
+    return wasm_job_output(job);
+}
+
+// 对比 16 位交错 PCM 输出与 ref_process_to_pcm16 的结果
+static void check_pcm16(BenchResult* r, const char* func, const AudioBuffer* source, float highpass_hz,
+                        const int16_t* test, std::vector<float>& ref_out, std::vector<float>& test_out) {
+    size_t samples = (size_t)source->length * source->num_channels;
+    std::vector<int16_t> pcm(samples);
+    ref_process_to_pcm16(source, kPipelineGain, highpass_hz, pcm.data());
+    ref_pcm16_to_float(pcm.data(), samples, ref_out.data());
+    ref_pcm16_to_float(test, samples, test_out.data());
+    // 交错布局按单声道整体比较
+    check_quality(r, func, ref_out.data(), test_out.data(), (uint32_t)samples, 1, source->sample_rate,
+                  std::vector<uint32_t>());
+}
+
+// 对比切分编码后拼接的交错 PCM 与整段参考编码
+static void check_split(BenchResult* r, const char* func, const AudioBuffer* source,
+                        const std::vector<int16_t>& pcm, std::vector<float>& ref_out, std::vector<float>& test_out) {
+    size_t samples = (size_t)source->length * source->num_channels;
+    std::vector<int16_t> ref_pcm(samples);
+    // 交错后用参考实现编码
+    for (uint32_t i = 0; i < source->length; i++) {
+        for (uint16_t ch = 0; ch < source->num_channels; ch++) {
+            test_out[(size_t)i * source->num_channels + ch] = source->data[(size_t)ch * source->length + i];
+        }
+    }
+    ref_to_pcm16(test_out.data(), samples, ref_pcm.data());
+    ref_pcm16_to_float(ref_pcm.data(), samples, ref_out.data());
+    ref_pcm16_to_float(pcm.data(), samples, test_out.data());
+    check_quality(r, func, ref_out.data(), test_out.data(), (uint32_t)samples, 1, source->sample_rate,
+                  std::vector<uint32_t>());
+}
+
+// 平面 <-> 交错
+static void interleave(const float* in, uint32_t frames, uint16_t channels, float* out) {
+    for (uint32_t i = 0; i < frames; i++) {
+        for (uint16_t ch = 0; ch < channels; ch++) out[(size_t)i * channels + ch] = in[(size_t)ch * frames + i];
+    }
+}
+
+static void deinterleave(const float* in, uint32_t frames, uint16_t channels, float* out) {
+    for (uint32_t i = 0; i < frames; i++) {
+        for (uint16_t ch = 0; ch < channels; ch++) out[(size_t)ch * frames + i] = in[(size_t)i * channels + ch];
+    }
+}
+
+// 交错布局输入 (如 wasm_wav_to_audio_buffer 的输出) 直接交给各函数处理, 不做解交错
+// 输出解交错后与平面布局的参考实现对比; source 为同一信号的平面布局版本
+static void run_interleaved(std::vector<BenchResult>& results, const BenchOptions& opt, const BenchCase& c,
+                            const AudioBuffer* source, bool verify,
+                            std::vector<float>& ref_out, std::vector<float>& test_out) {
+    const uint32_t frames = c.frames;
+    const uint16_t channels = c.channels;
+    const size_t samples = (size_t)frames * channels;
+    const double float_bytes = (double)samples * sizeof(float);
+    const std::vector<uint32_t> no_seams;
+
+    std::vector<float> data(samples);
+    interleave(source->data, frames, channels, data.data());
+    AudioBuffer inter = {data.data(), frames, channels, AUDIO_LAYOUT_INTERLEAVED, c.sample_rate};
+    AudioBuffer output;
+    BenchResult* r;
+
+    // 切片
+    uint32_t slice_len = frames / 2;
+    r = bench(results, opt, "slice_audio_interleaved", c, slice_len, 2.0 * slice_len * channels * sizeof(float), [&]() {
+        wasm_slice_audio(&inter, frames / 4, slice_len);
+    });
+    if (r && verify) {
+        uint32_t n = wasm_slice_audio(&inter, frames / 4, slice_len);
+        uint32_t ref_n = ref_slice(source, frames / 4, slice_len, ref_out.data());
+        if (n != ref_n) {
+            fail_quality(r, ref_n, n);
+        } else {
+            deinterleave((const float*)g_memory_buffer.buffer, n, channels, test_out.data());
+            check_quality(r, "slice_audio_interleaved", ref_out.data(), test_out.data(), n, channels,
+                          c.sample_rate, no_seams);
+        }
+    }
+
+    // 合并: 10 秒一段, 拼接结果即整段信号
+    uint32_t seg_frames = c.sample_rate * 10;
+    std::vector<AudioBuffer> segments;
+    std::vector<uint32_t> merge_seams;
+    for (uint32_t start = 0; start < frames; start += seg_frames) {
+        uint32_t len = frames - start < seg_frames ? frames - start : seg_frames;
+        AudioBuffer seg = {data.data() + (size_t)start * channels, len, channels, AUDIO_LAYOUT_INTERLEAVED,
+                           c.sample_rate};
+        segments.push_back(seg);
+        if (start > 0) merge_seams.push_back(start);
+    }
+    r = bench(results, opt, "merge_audio_buffers_interleaved", c, frames, 2.0 * float_bytes, [&]() {
+        wasm_merge_audio_buffers(segments.data(), (uint32_t)segments.size(), &output);
+    });
+    if (r && verify) {
+        uint32_t n = wasm_merge_audio_buffers(segments.data(), (uint32_t)segments.size(), &output);
+        if (n != frames || output.layout != AUDIO_LAYOUT_INTERLEAVED) {
+            fail_quality(r, frames, n);
+        } else {
+            deinterleave(output.data, n, channels, test_out.data());
+            check_quality(r, "merge_audio_buffers_interleaved", source->data, test_out.data(), n, channels,
+                          c.sample_rate, merge_seams);
+        }
+    }
+
+    // 重采样
+    uint32_t target_rate = c.sample_rate == 48000 ? 24000 : 48000;
+    double out_frames = (double)frames * target_rate / c.sample_rate;
+    r = bench(results, opt, "resample_audio_interleaved", c, frames,
+              float_bytes + out_frames * channels * sizeof(float), [&]() {
+        wasm_resample_audio(&inter, target_rate, &output);
+    });
+    if (r && verify) {
+        uint32_t n = wasm_resample_audio(&inter, target_rate, &output);
+        uint32_t ref_n = ref_resample(source, target_rate, ref_out.data());
+        if (n != ref_n) {
+            fail_quality(r, ref_n, n);
+        } else {
+            deinterleave(output.data, n, channels, test_out.data());
+            check_quality(r, "resample_audio_interleaved", ref_out.data(), test_out.data(), n, channels,
+                          target_rate, no_seams);
+        }
+    }
+
+    // 交叉淡化: 前后两半, 10ms 过渡; mixed 为前一半平面布局 + 后一半交错布局
+    uint32_t half = frames / 2;
+    uint32_t fade = c.sample_rate / 100;
+    std::vector<float> planar_first((size_t)half * channels);
+    std::vector<float> planar_second((size_t)(frames - half) * channels);
+    deinterleave(data.data(), half, channels, planar_first.data());
+    deinterleave(data.data() + (size_t)half * channels, frames - half, channels, planar_second.data());
+    AudioBuffer first = {data.data(), half, channels, AUDIO_LAYOUT_INTERLEAVED, c.sample_rate};
+    AudioBuffer second = {data.data() + (size_t)half * channels, frames - half, channels, AUDIO_LAYOUT_INTERLEAVED,
+                          c.sample_rate};
+    AudioBuffer ref_first = {planar_first.data(), half, channels, AUDIO_LAYOUT_PLANAR, c.sample_rate};
+    AudioBuffer ref_second = {planar_second.data(), frames - half, channels, AUDIO_LAYOUT_PLANAR, c.sample_rate};
+    std::vector<uint32_t> fade_seams;
+    fade_seams.push_back(half - fade);
+    fade_seams.push_back(half);
+
+    const char* fade_funcs[] = {"cross_fade_interleaved", "cross_fade_mixed"};
+    AudioBuffer* fade_first[] = {&first, &ref_first};
+    for (int k = 0; k < 2; k++) {
+        r = bench(results, opt, fade_funcs[k], c, frames, 2.0 * float_bytes, [&]() {
+            wasm_cross_fade(fade_first[k], &second, fade, &output);
+        });
+        if (r && verify) {
+            uint32_t n = wasm_cross_fade(fade_first[k], &second, fade, &output);
+            uint32_t ref_n = ref_cross_fade(&ref_first, &ref_second, fade, ref_out.data());
+            if (n != ref_n) {
+                fail_quality(r, ref_n, n);
+                continue;
+            }
+            const float* test = output.data;
+            if (output.layout == AUDIO_LAYOUT_INTERLEAVED) {
+                deinterleave(output.data, n, channels, test_out.data());
+                test = test_out.data();
+            }
+            check_quality(r, fade_funcs[k], ref_out.data(), test, n, channels, c.sample_rate, fade_seams);
+        }
+    }
+
+    // 切分编码: 视图按交错步长读取, 紧密交错时连续编码
+    const uint32_t split_frames = c.sample_rate * 10;
+    std::vector<uint8_t> wav_out(44 + (size_t)split_frames * channels * 2);
+    std::vector<int16_t> split_pcm(verify ? samples : 0);
+    AudioView view;
+    r = bench(results, opt, "split_encode_interleaved", c, frames, float_bytes + (double)samples * 2, [&]() {
+        for (uint32_t start = 0; start < frames; start += split_frames) {
+            wasm_slice_view(&inter, start, split_frames, &view);
+            uint32_t size = wasm_view_to_wav(&view, 16);
+            memcpy(wav_out.data(), g_memory_buffer.buffer, size);
+            if (!split_pcm.empty()) memcpy(&split_pcm[(size_t)start * channels], wav_out.data() + 44, size - 44);
+        }
+    });
+    if (r && verify) check_split(r, "split_encode_interleaved", source, split_pcm, ref_out, test_out);
+
+    // 融合流水线: 按块读取交错输入
+    r = bench(results, opt, "process_to_wav_interleaved", c, frames, float_bytes + (double)samples * 2, [&]() {
+        wasm_process_to_wav(&inter, kPipelineGain, kPipelineHighpass);
+    });
+    if (r && verify) {
+        wasm_process_to_wav(&inter, kPipelineGain, kPipelineHighpass);
+        check_pcm16(r, "process_to_wav_interleaved", source, kPipelineHighpass,
+                    (const int16_t*)(g_memory_buffer.buffer + 44), ref_out, test_out);
+    }
+}
+
+// 对比 wasm_analyze_audio 的输出 (g_memory_buffer 中的 AudioLevel 数组) 与 ref_analyze
+static void check_levels(BenchResult* r, const char* func, const AudioBuffer* source, uint32_t block_frames,
+                         std::vector<float>& ref_out, std::vector<float>& test_out) {
+    uint32_t n = wasm_analyze_audio((AudioBuffer*)source, block_frames);
+    uint32_t ref_n = ref_analyze(source, block_frames, (AudioLevel*)ref_out.data());
+    if (n != ref_n) {
+        fail_quality(r, ref_n, n);
+        return;
+    }
+    memcpy(test_out.data(), g_memory_buffer.buffer, n * sizeof(AudioLevel));
+    // rms / peak 交替排列, 按单声道整体比较
+    check_quality(r, func, ref_out.data(), test_out.data(), n * 2, 1, source->sample_rate,
+                  std::vector<uint32_t>());
+}
+
+// 紧凑样本格式: 压缩 / 合并 / 编码 / 融合流水线直接读取 int16 或 float16, 不先展开为 float
+// int16 的参考输出为 16 位 PCM 往返后的信号 (与先编码为 WAV 再解码相同)
+static void run_compact(std::vector<BenchResult>& results, const BenchOptions& opt, const BenchCase& c,
+                        const AudioBuffer* source, bool verify,
+                        std::vector<float>& ref_out, std::vector<float>& test_out) {
+    const uint32_t frames = c.frames;
+    const uint16_t channels = c.channels;
+    const size_t samples = (size_t)frames * channels;
+    const double float_bytes = (double)samples * sizeof(float);
+    const double compact_bytes = (double)samples * 2;
+    const std::vector<uint32_t> no_seams;
+    const uint16_t s16_layout = audio_make_layout(AUDIO_LAYOUT_PLANAR, AUDIO_SAMPLE_S16);
+
+    std::vector<int16_t> s16(samples);
+    std::vector<float> quantized(verify ? samples : 0);
+    ref_to_pcm16(source->data, samples, s16.data());
+    if (verify) ref_pcm16_to_float(s16.data(), samples, quantized.data());
+    AudioBuffer compact = {(float*)s16.data(), frames, channels, s16_layout, c.sample_rate};
+    AudioBuffer quantized_source = {quantized.data(), frames, channels, AUDIO_LAYOUT_PLANAR, c.sample_rate};
+    AudioBuffer output;
+    BenchResult* r;
+
+    // 压缩
+    r = bench(results, opt, "convert_samples_s16", c, frames, float_bytes + compact_bytes, [&]() {
+        wasm_convert_samples((AudioBuffer*)source, AUDIO_SAMPLE_S16, &output);
+    });
+    if (r && verify) {
+        uint32_t n = wasm_convert_samples((AudioBuffer*)source, AUDIO_SAMPLE_S16, &output);
+        if (n != frames || output.layout != s16_layout) {
+            fail_quality(r, frames, n);
+        } else {
+            ref_pcm16_to_float((const int16_t*)output.data, samples, test_out.data());
+            check_quality(r, "convert_samples_s16", quantized.data(), test_out.data(), n, channels,
+                          c.sample_rate, no_seams);
+        }
+    }
+
+    r = bench(results, opt, "convert_samples_f16", c, frames, float_bytes + compact_bytes, [&]() {
+        wasm_convert_samples((AudioBuffer*)source, AUDIO_SAMPLE_F16, &output);
+    });
+    if (r && verify) {
+        uint32_t n = wasm_convert_samples((AudioBuffer*)source, AUDIO_SAMPLE_F16, &output);
+        if (n != frames) {
+            fail_quality(r, frames, n);
+        } else {
+            // 展开回 float 需要源数据不在输出区内, 先复制出来
+            std::vector<uint16_t> f16((const uint16_t*)output.data, (const uint16_t*)output.data + samples);
+            AudioBuffer half = {(float*)f16.data(), frames, channels, output.layout, c.sample_rate};
+            wasm_convert_samples(&half, AUDIO_SAMPLE_F32, &output);
+            check_quality(r, "convert_samples_f16", source->data, output.data, n, channels, c.sample_rate,
+                          no_seams);
+        }
+    }
+
+    // 合并: 10 秒一段的 int16 片段, 输出仍为 int16
+    uint32_t seg_frames = c.sample_rate * 10;
+    std::vector<std::vector<int16_t> > seg_data;
+    std::vector<AudioBuffer> segments;
+    std::vector<uint32_t> merge_seams;
+    for (uint32_t start = 0; start < frames; start += seg_frames) {
+        uint32_t len = frames - start < seg_frames ? frames - start : seg_frames;
+        seg_data.push_back(std::vector<int16_t>((size_t)len * channels));
+        for (uint16_t ch = 0; ch < channels; ch++) {
+            memcpy(&seg_data.back()[(size_t)ch * len], &s16[(size_t)ch * frames + start], len * sizeof(int16_t));
+        }
+        if (start > 0) merge_seams.push_back(start);
+    }
+    for (size_t i = 0; i < seg_data.size(); i++) {
+        AudioBuffer seg = {(float*)seg_data[i].data(), (uint32_t)(seg_data[i].size() / channels), channels,
+                           s16_layout, c.sample_rate};
+        segments.push_back(seg);
+    }
+    r = bench(results, opt, "merge_audio_buffers_s16", c, frames, 2.0 * compact_bytes, [&]() {
+        wasm_merge_audio_buffers(segments.data(), (uint32_t)segments.size(), &output);
+    });
+    if (r && verify) {
+        uint32_t n = wasm_merge_audio_buffers(segments.data(), (uint32_t)segments.size(), &output);
+        if (n != frames || output.layout != s16_layout) {
+            fail_quality(r, frames, n);
+        } else {
+            ref_pcm16_to_float((const int16_t*)output.data, samples, test_out.data());
+            check_quality(r, "merge_audio_buffers_s16", quantized.data(), test_out.data(), n, channels,
+                          c.sample_rate, merge_seams);
+        }
+    }
+
+    // 批量切分编码: int16 -> 16 位 PCM 只做交错复制, 与 float 源的编码结果逐位一致
+    std::vector<AudioSegment> plan;
+    for (uint32_t start = 0; start < frames; start += seg_frames) {
+        AudioSegment seg = {start, seg_frames};
+        plan.push_back(seg);
+    }
+    std::vector<SegmentResult> plan_results(plan.size());
+    r = bench(results, opt, "split_encode_s16", c, frames, compact_bytes * 2, [&]() {
+        wasm_encode_segments(&compact, plan.data(), (uint32_t)plan.size(), 16, plan_results.data());
+    });
+    if (r && verify) {
+        wasm_encode_segments(&compact, plan.data(), (uint32_t)plan.size(), 16, plan_results.data());
+        std::vector<int16_t> pcm(samples);
+        size_t at = 0;
+        for (size_t i = 0; i < plan_results.size(); i++) {
+            uint32_t bytes = plan_results[i].size - 44;
+            memcpy(&pcm[at], g_memory_buffer.buffer + plan_results[i].offset + 44, bytes);
+            at += bytes / sizeof(int16_t);
+        }
+        check_split(r, "split_encode_s16", source, pcm, ref_out, test_out);
+    }
+
+    // 融合流水线: 读入块时展开
+    r = bench(results, opt, "process_to_wav_s16", c, frames, compact_bytes * 2, [&]() {
+        wasm_process_to_wav(&compact, kPipelineGain, kPipelineHighpass);
+    });
+    if (r && verify) {
+        wasm_process_to_wav(&compact, kPipelineGain, kPipelineHighpass);
+        check_pcm16(r, "process_to_wav_s16", &quantized_source, kPipelineHighpass,
+                    (const int16_t*)(g_memory_buffer.buffer + 44), ref_out, test_out);
+    }
+}
+
+// 可并行函数在不同线程数下的吞吐量; 输出与单线程逐位一致, 仍与参考实现对比
+// 线程数超过构建支持的数量时 (单线程构建只有 1) 跳过
+static void run_scaling(std::vector<BenchResult>& results, const BenchOptions& opt, const BenchCase& base,
+                        const AudioBuffer* source, bool verify,
+                        std::vector<float>& ref_out, std::vector<float>& test_out) {
+    const uint32_t frames = base.frames;
+    const uint16_t channels = base.channels;
+    const size_t samples = (size_t)frames * channels;
+    const double float_bytes = (double)samples * sizeof(float);
+    const std::vector<uint32_t> no_seams;
+
+    // 10 秒一段的平面布局片段 (1 小时输入时为 360 段)
+    uint32_t seg_frames = base.sample_rate * 10;
+    std::vector<AudioBuffer> segments;
+    std::vector<std::vector<float> > seg_data;
+    for (uint32_t start = 0; start < frames; start += seg_frames) {
+        uint32_t len = frames - start < seg_frames ? frames - start : seg_frames;
+        seg_data.push_back(std::vector<float>((size_t)len * channels));
+        for (uint16_t ch = 0; ch < channels; ch++) {
+            memcpy(seg_data.back().data() + (size_t)ch * len, source->data + (size_t)ch * frames + start,
+                   len * sizeof(float));
+        }
+    }
+    for (uint32_t i = 0, start = 0; i < seg_data.size(); i++, start += seg_frames) {
+        uint32_t len = frames - start < seg_frames ? frames - start : seg_frames;
+        AudioBuffer seg = {seg_data[i].data(), len, channels, AUDIO_LAYOUT_PLANAR, base.sample_rate};
+        segments.push_back(seg);
+    }
+
+    uint32_t target_rate = base.sample_rate == 48000 ? 24000 : 48000;
+    double out_frames = (double)frames * target_rate / base.sample_rate;
+    uint32_t level_block = base.sample_rate / 50;
+    AudioBuffer output;
+    BenchResult* r;
+
+    for (size_t t = 0; t < opt.threads.size(); t++) {
+        if (wasm_set_threads(opt.threads[t]) != opt.threads[t]) continue;
+        BenchCase c = base;
+        c.threads = opt.threads[t];
+
+        r = bench(results, opt, "merge_audio_buffers", c, frames, 2.0 * float_bytes, [&]() {
+            wasm_merge_audio_buffers(segments.data(), (uint32_t)segments.size(), &output);
+        });
+        if (r && verify) {
+            uint32_t n = wasm_merge_audio_buffers(segments.data(), (uint32_t)segments.size(), &output);
+            if (n != frames) {
+                fail_quality(r, frames, n);
+            } else {
+                check_quality(r, "merge_audio_buffers", source->data, output.data, n, channels,
+                              base.sample_rate, no_seams);
+            }
+        }
+
+        // 平面数据直接当作交错数据编码, 同 run_case 中的 audio_buffer_to_wav
+        r = bench(results, opt, "audio_buffer_to_wav", c, frames, float_bytes + samples * 2.0, [&]() {
+            wasm_audio_buffer_to_wav(source->data, frames, channels, base.sample_rate, 16);
+        });
+        if (r && verify) {
+            wasm_audio_buffer_to_wav(source->data, frames, channels, base.sample_rate, 16);
+            std::vector<int16_t> pcm(samples);
+            ref_to_pcm16(source->data, samples, pcm.data());
+            ref_pcm16_to_float(pcm.data(), samples, ref_out.data());
+            ref_pcm16_to_float((const int16_t*)(g_memory_buffer.buffer + 44), samples, test_out.data());
+            check_quality(r, "audio_buffer_to_wav", ref_out.data(), test_out.data(), frames, channels,
+                          base.sample_rate, no_seams);
+        }
+
+        r = bench(results, opt, "resample_audio", c, frames, float_bytes + out_frames * channels * sizeof(float), [&]() {
+            wasm_resample_audio((AudioBuffer*)source, target_rate, &output);
+        });
+        if (r && verify) {
+            uint32_t n = wasm_resample_audio((AudioBuffer*)source, target_rate, &output);
+            uint32_t ref_n = ref_resample(source, target_rate, ref_out.data());
+            if (n != ref_n) {
+                fail_quality(r, ref_n, n);
+            } else {
+                check_quality(r, "resample_audio", ref_out.data(), output.data, n, channels, target_rate, no_seams);
+            }
+        }
+
+        r = bench(results, opt, "analyze_audio", c, frames, float_bytes, [&]() {
+            wasm_analyze_audio((AudioBuffer*)source, level_block);
+        });
+        if (r && verify) check_levels(r, "analyze_audio", source, level_block, ref_out, test_out);
+    }
+    wasm_set_threads(1);
+}
+
+// 逐级整段处理: 与融合流水线相同的处理级, 但每一级都完整读写一遍缓冲区
+// work 为 float 中间缓冲区 (平面布局), pcm 为交错输出
+template <typename Stages>
+static void run_multipass(Stages& stages, const AudioBuffer* source, float* work, int16_t* pcm) {
+    using namespace audio_pipeline;
+    PipelineBlock pos;
+    pos.num_channels = source->num_channels;
+    pos.offset = 0;
+    pos.length = source->length;
+
+    stages.reset();
+    memcpy(work, source->data, (size_t)source->length * source->num_channels * sizeof(float));
+    for (uint16_t ch = 0; ch < source->num_channels; ch++) {
+        pos.channel = ch;
+        stages.process(work + (size_t)ch * source->length, source->length, pos);
+    }
+    Pcm16Sink sink(pcm);
+    for (uint16_t ch = 0; ch < source->num_channels; ch++) {
+        pos.channel = ch;
+        sink.process(work + (size_t)ch * source->length, source->length, pos);
+    }
+}
+
+static void run_case(std::vector<BenchResult>& results, const BenchOptions& opt, const BenchCase& c) {
+    const uint32_t frames = c.frames;
+    const uint16_t channels = c.channels;
+    const size_t samples = (size_t)frames * channels;
+    const double float_bytes = (double)samples * sizeof(float);
+    const double pcm16_bytes = (double)samples * 2;
+    const bool verify = c.duration <= opt.quality_max_duration;
+    const std::vector<uint32_t> no_seams;
+
+    float* signal = (float*)malloc(samples * sizeof(float));
+    SpeechSynthParams synth = {c.sample_rate, channels, kSignalSeed, kSignalPeak};
+    speech_synth_generate(&synth, signal, frames);
+
+    AudioBuffer source = {signal, frames, channels, AUDIO_LAYOUT_PLANAR, c.sample_rate};
+    AudioBuffer output;
+    BenchResult* r;
+
+    // 参考输出 / 待测输出的暂存区, 按最大的输出 (重采样到 48k) 分配
+    std::vector<float> ref_out;
+    std::vector<float> test_out;
+    if (verify) {
+        size_t max_samples = (size_t)(samples * (48000.0 / c.sample_rate)) + channels;
+        if (max_samples < samples) max_samples = samples;
+        ref_out.resize(max_samples);
+        test_out.resize(max_samples);
+    }
+
+    // AudioBuffer -> WAV (16 位)
+    // 注意 wasm_audio_buffer_to_wav 的输入是交错布局, 这里直接把平面数据当作交错数据编码 (只影响声道归属, 不影响数值)
+    r = bench(results, opt, "audio_buffer_to_wav", c, frames, float_bytes + pcm16_bytes, [&]() {
+        wasm_audio_buffer_to_wav(signal, frames, channels, c.sample_rate, 16);
+    });
+    if (r && verify) {
+        uint32_t size = wasm_audio_buffer_to_wav(signal, frames, channels, c.sample_rate, 16);
+        std::vector<int16_t> pcm(samples);
+        ref_to_pcm16(signal, samples, pcm.data());
+        if (size != 44 + samples * 2) {
+            fail_quality(r, frames, (size - 44) / (2 * channels));
+        } else {
+            // 两边用同一解码方式转回 float 后比较
+            ref_pcm16_to_float(pcm.data(), samples, ref_out.data());
+            ref_pcm16_to_float((const int16_t*)(g_memory_buffer.buffer + 44), samples, test_out.data());
+            check_quality(r, "audio_buffer_to_wav", ref_out.data(), test_out.data(), frames, channels,
+                          c.sample_rate, no_seams);
+        }
+    }
+
+    // WAV -> AudioBuffer: 先编码一份 WAV 作为输入
+    uint32_t wav_size = wasm_audio_buffer_to_wav(signal, frames, channels, c.sample_rate, 16);
+    uint8_t* wav = (uint8_t*)malloc(wav_size);
+    memcpy(wav, g_memory_buffer.buffer, wav_size);
+    r = bench(results, opt, "wav_to_audio_buffer", c, frames, wav_size + float_bytes, [&]() {
+        wasm_wav_to_audio_buffer(wav, wav_size, &output);
+    });
+    if (r && verify) {
+        uint32_t n = wasm_wav_to_audio_buffer(wav, wav_size, &output);
+        ref_pcm16_to_float((const int16_t*)(wav + 44), samples, ref_out.data());
+        if (n != frames) {
+            fail_quality(r, frames, n);
+        } else {
+            check_quality(r, "wav_to_audio_buffer", ref_out.data(), output.data, frames, channels,
+                          c.sample_rate, no_seams);
+        }
+    }
+    free(wav);
+
+    // 切片: 取中间一半
+    uint32_t slice_len = frames / 2;
+    r = bench(results, opt, "slice_audio", c, slice_len, 2.0 * slice_len * channels * sizeof(float), [&]() {
+        wasm_slice_audio(&source, frames / 4, slice_len);
+    });
+    if (r && verify) {
+        uint32_t n = wasm_slice_audio(&source, frames / 4, slice_len);
+        uint32_t ref_n = ref_slice(&source, frames / 4, slice_len, ref_out.data());
+        if (n != ref_n) {
+            fail_quality(r, ref_n, n);
+        } else {
+            check_quality(r, "slice_audio", ref_out.data(), (const float*)g_memory_buffer.buffer, n, channels,
+                          c.sample_rate, no_seams);
+        }
+    }
+
+    // 切分并编码为 WAV (10 秒一段): 复制切片 vs 切片视图
+    // 复制路径对应原有 JS 包装: 切片复制到 g_memory_buffer -> 拷出 -> 交错 -> 编码;
+    // 视图路径只填写描述符, 编码时直接读取源数据. 两者都把 WAV 拷出一次
+    const uint32_t split_frames = c.sample_rate * 10;
+    std::vector<float> seg_copy((size_t)split_frames * channels);
+    std::vector<float> seg_interleaved((size_t)split_frames * channels);
+    std::vector<uint8_t> wav_out(44 + (size_t)split_frames * channels * 2);
+    // 各段的 PCM 数据按顺序拼起来即为整段交错 PCM, 用于质量对比
+    std::vector<int16_t> split_pcm(verify ? samples : 0);
+
+    r = bench(results, opt, "split_encode_copy", c, frames, float_bytes + pcm16_bytes, [&]() {
+        for (uint32_t start = 0; start < frames; start += split_frames) {
+            uint32_t n = wasm_slice_audio(&source, start, split_frames);
+            memcpy(seg_copy.data(), g_memory_buffer.buffer, (size_t)n * channels * sizeof(float));
+            for (uint32_t i = 0; i < n; i++) {
+                for (uint16_t ch = 0; ch < channels; ch++) {
+                    seg_interleaved[(size_t)i * channels + ch] = seg_copy[(size_t)ch * n + i];
+                }
+            }
+            uint32_t size = wasm_audio_buffer_to_wav(seg_interleaved.data(), n, channels, c.sample_rate, 16);
+            memcpy(wav_out.data(), g_memory_buffer.buffer, size);
+            if (!split_pcm.empty()) memcpy(&split_pcm[(size_t)start * channels], wav_out.data() + 44, size - 44);
+        }
+    });
+    if (r && verify) check_split(r, "split_encode_copy", &source, split_pcm, ref_out, test_out);
+
+    AudioView view;
+    r = bench(results, opt, "split_encode_view", c, frames, float_bytes + pcm16_bytes, [&]() {
+        for (uint32_t start = 0; start < frames; start += split_frames) {
+            wasm_slice_view(&source, start, split_frames, &view);
+            uint32_t size = wasm_view_to_wav(&view, 16);
+            memcpy(wav_out.data(), g_memory_buffer.buffer, size);
+            if (!split_pcm.empty()) memcpy(&split_pcm[(size_t)start * channels], wav_out.data() + 44, size - 44);
+        }
+    });
+    if (r && verify) check_split(r, "split_encode_view", &source, split_pcm, ref_out, test_out);
+
+    // 批量: 一次调用编码全部片段
+    std::vector<AudioSegment> split_plan;
+    for (uint32_t start = 0; start < frames; start += split_frames) {
+        AudioSegment seg = {start, split_frames};
+        split_plan.push_back(seg);
+    }
+    std::vector<SegmentResult> split_results(split_plan.size());
+    std::fill(split_pcm.begin(), split_pcm.end(), 0);  // 不沿用上一个用例的输出
+    r = bench(results, opt, "split_encode_batch", c, frames, float_bytes + pcm16_bytes, [&]() {
+        wasm_encode_segments(&source, split_plan.data(), (uint32_t)split_plan.size(), 16, split_results.data());
+        for (size_t i = 0; i < split_plan.size(); i++) {
+            const SegmentResult& res = split_results[i];
+            memcpy(wav_out.data(), g_memory_buffer.buffer + res.offset, res.size);
+            if (!split_pcm.empty()) {
+                memcpy(&split_pcm[(size_t)split_plan[i].start * channels], wav_out.data() + 44, res.size - 44);
+            }
+        }
+    });
+    if (r && verify) check_split(r, "split_encode_batch", &source, split_pcm, ref_out, test_out);
+
+    // 合并: 按 10 秒一段切开再合并
+    uint32_t seg_frames = c.sample_rate * 10;
+    std::vector<AudioBuffer> segments;
+    std::vector<float*> seg_data;
+    std::vector<uint32_t> merge_seams;
+    for (uint32_t start = 0; start < frames; start += seg_frames) {
+        uint32_t len = frames - start < seg_frames ? frames - start : seg_frames;
+        float* data = (float*)malloc((size_t)len * channels * sizeof(float));
+        for (uint16_t ch = 0; ch < channels; ch++) {
+            memcpy(data + (size_t)ch * len, signal + (size_t)ch * frames + start, len * sizeof(float));
+        }
+        AudioBuffer seg = {data, len, channels, AUDIO_LAYOUT_PLANAR, c.sample_rate};
+        segments.push_back(seg);
+        seg_data.push_back(data);
+        if (start > 0) merge_seams.push_back(start);
+    }
+    r = bench(results, opt, "merge_audio_buffers", c, frames, 2.0 * float_bytes, [&]() {
+        wasm_merge_audio_buffers(segments.data(), (uint32_t)segments.size(), &output);
+    });
+    double one_shot_ms = r ? r->real_time_ms : 0;
+    if (r && verify) {
+        uint32_t n = wasm_merge_audio_buffers(segments.data(), (uint32_t)segments.size(), &output);
+        uint32_t ref_n = ref_merge(segments.data(), (uint32_t)segments.size(), ref_out.data());
+        if (n != ref_n) {
+            fail_quality(r, ref_n, n);
+        } else {
+            check_quality(r, "merge_audio_buffers", ref_out.data(), output.data, n, channels,
+                          c.sample_rate, merge_seams);
+        }
+    }
+    AudioJob* job = NULL;
+    r = bench_stepped(results, opt, "merge_audio_buffers_sliced", c, frames, 2.0 * float_bytes, one_shot_ms, [&]() {
+        wasm_job_free(job);
+        job = wasm_job_merge_begin(segments.data(), (uint32_t)segments.size());
+        upload_job(job, segments.data(), (uint32_t)segments.size());
+    }, [&]() {
+        step_job(job);
+    });
+    wasm_job_free(job);
+    if (r && verify) {
+        job = wasm_job_merge_begin(segments.data(), (uint32_t)segments.size());
+        upload_job(job, segments.data(), (uint32_t)segments.size());
+        AudioBuffer* sliced = step_job(job);
+        uint32_t ref_n = ref_merge(segments.data(), (uint32_t)segments.size(), ref_out.data());
+        if (!sliced || sliced->length != ref_n) {
+            fail_quality(r, ref_n, sliced ? sliced->length : 0);
+        } else {
+            check_quality(r, "merge_audio_buffers_sliced", ref_out.data(), sliced->data, ref_n, channels,
+                          c.sample_rate, merge_seams);
+        }
+        wasm_job_free(job);
+    }
+    for (size_t i = 0; i < seg_data.size(); i++) free(seg_data[i]);
+
+    // 重采样: 48k -> 24k, 其余 -> 48k
+    uint32_t target_rate = c.sample_rate == 48000 ? 24000 : 48000;
+    double out_frames = (double)frames * target_rate / c.sample_rate;
+    r = bench(results, opt, "resample_audio", c, frames, float_bytes + out_frames * channels * sizeof(float), [&]() {
+        wasm_resample_audio(&source, target_rate, &output);
+    });
+    one_shot_ms = r ? r->real_time_ms : 0;
+    if (r && verify) {
+        uint32_t n = wasm_resample_audio(&source, target_rate, &output);
+        uint32_t ref_n = ref_resample(&source, target_rate, ref_out.data());
+        if (n != ref_n) {
+            fail_quality(r, ref_n, n);
+        } else {
+            check_quality(r, "resample_audio", ref_out.data(), output.data, n, channels,
+                          target_rate, no_seams);
+        }
+    }
+    job = NULL;
+    r = bench_stepped(results, opt, "resample_audio_sliced", c, frames,
+                      float_bytes + out_frames * channels * sizeof(float), one_shot_ms, [&]() {
+        wasm_job_free(job);
+        job = wasm_job_resample_begin(&source, target_rate);
+        upload_job(job, &source, 1);
+    }, [&]() {
+        step_job(job);
+    });
+    wasm_job_free(job);
+    if (r && verify) {
+        job = wasm_job_resample_begin(&source, target_rate);
+        upload_job(job, &source, 1);
+        AudioBuffer* sliced = step_job(job);
+        uint32_t ref_n = ref_resample(&source, target_rate, ref_out.data());
+        if (!sliced || sliced->length != ref_n) {
+            fail_quality(r, ref_n, sliced ? sliced->length : 0);
+        } else {
+            check_quality(r, "resample_audio_sliced", ref_out.data(), sliced->data, ref_n, channels,
+                          target_rate, no_seams);
+        }
+        wasm_job_free(job);
+    }
+
+    // 音量调整 (原地)
+    r = bench(results, opt, "adjust_volume", c, frames, 2.0 * float_bytes, [&]() {
+        wasm_adjust_volume(&source, 0.999f);
+    });
+    if (r && verify) {
+        // 计时循环已反复修改 signal, 在副本上再运行一次
+        memcpy(test_out.data(), signal, samples * sizeof(float));
+        AudioBuffer copy = {test_out.data(), frames, channels, AUDIO_LAYOUT_PLANAR, c.sample_rate};
+        wasm_adjust_volume(&copy, 0.999f);
+        ref_adjust_volume(signal, samples, 0.999f, ref_out.data());
+        check_quality(r, "adjust_volume", ref_out.data(), test_out.data(), frames, channels,
+                      c.sample_rate, no_seams);
+    }
+
+    // 交叉淡化: 把信号缓冲区当作前后两个独立的平面缓冲区, 10ms 过渡
+    uint32_t half = frames / 2;
+    AudioBuffer first = {signal, half, channels, AUDIO_LAYOUT_PLANAR, c.sample_rate};
+    AudioBuffer second = {signal + (size_t)half * channels, frames - half, channels, AUDIO_LAYOUT_PLANAR,
+                          c.sample_rate};
+    uint32_t fade = c.sample_rate / 100;
+    r = bench(results, opt, "cross_fade", c, frames, 2.0 * float_bytes, [&]() {
+        wasm_cross_fade(&first, &second, fade, &output);
+    });
+    if (r && verify) {
+        uint32_t n = wasm_cross_fade(&first, &second, fade, &output);
+        uint32_t ref_n = ref_cross_fade(&first, &second, fade, ref_out.data());
+        // 接缝: 过渡区的起点和终点
+        std::vector<uint32_t> fade_seams;
+        fade_seams.push_back(half - fade);
+        fade_seams.push_back(half);
+        if (n != ref_n) {
+            fail_quality(r, ref_n, n);
+        } else {
+            check_quality(r, "cross_fade", ref_out.data(), output.data, n, channels,
+                          c.sample_rate, fade_seams);
+        }
+    }
+
+    // 只有过渡区的交叉淡化 (两段均为 100ms 且全部重叠), 对应流式合并时每个接缝上的开销
+    uint32_t region = c.sample_rate / 10;
+    AudioBuffer tail = {signal, region, channels, AUDIO_LAYOUT_PLANAR, c.sample_rate};
+    AudioBuffer head = {signal + (size_t)region * channels, region, channels, AUDIO_LAYOUT_PLANAR,
+                        c.sample_rate};
+    r = bench(results, opt, "cross_fade_region", c, region, 3.0 * region * channels * sizeof(float), [&]() {
+        wasm_cross_fade(&tail, &head, region, &output);
+    });
+    if (r && verify) {
+        uint32_t n = wasm_cross_fade(&tail, &head, region, &output);
+        uint32_t ref_n = ref_cross_fade(&tail, &head, region, ref_out.data());
+        if (n != ref_n) {
+            fail_quality(r, ref_n, n);
+        } else {
+            check_quality(r, "cross_fade_region", ref_out.data(), output.data, n, channels,
+                          c.sample_rate, no_seams);
+        }
+    }
+
+    // 电平分析: 20ms 一块
+    uint32_t level_block = c.sample_rate / 50;
+    uint32_t num_levels = (frames + level_block - 1) / level_block;
+    r = bench(results, opt, "analyze_audio", c, frames, float_bytes + num_levels * sizeof(AudioLevel), [&]() {
+        wasm_analyze_audio(&source, level_block);
+    });
+    if (r && verify) check_levels(r, "analyze_audio", &source, level_block, ref_out, test_out);
+
+    // 参考音频预处理: 下混 + 重采样到 22.05k + 裁剪静音 + 截取 15 秒
+    const uint32_t reference_rate = 22050;
+    r = bench(results, opt, "prepare_reference", c, frames, float_bytes, [&]() {
+        wasm_prepare_reference(&source, reference_rate, 15.0f, -40.0f, &output);
+    });
+    if (r && verify) {
+        uint32_t n = wasm_prepare_reference(&source, reference_rate, 15.0f, -40.0f, &output);
+        uint32_t ref_n = ref_prepare_reference(&source, reference_rate, 15.0f, -40.0f, ref_out.data());
+        if (n != ref_n) {
+            fail_quality(r, ref_n, n);
+        } else {
+            check_quality(r, "prepare_reference", ref_out.data(), output.data, n, 1, reference_rate, no_seams);
+        }
+    }
+
+    // 交错布局输入 (单声道时两种布局相同, 不重复测试)
+    if (channels > 1) run_interleaved(results, opt, c, &source, verify, ref_out, test_out);
+    run_compact(results, opt, c, &source, verify, ref_out, test_out);
+
+    // 1 ~ 8 线程的扩展性
+    run_scaling(results, opt, c, &source, verify, ref_out, test_out);
+
+    // 多遍 vs 融合: 同样的处理链, 对比逐级整段处理与按块单遍处理的吞吐量
+    // bytes 统一按 "读一遍 float 输入 + 写一遍 16 位输出" 计, 两者的 bytes_per_second 可直接比较
+    std::vector<float> work(samples);
+    std::vector<int16_t> pcm(samples);
+    std::vector<float> interleaved(channels > 1 ? samples : 0);
+    const double chain_bytes = float_bytes + pcm16_bytes;
+
+    // 增益 -> 限幅 -> 16 位: 原有导出函数 (复制 + wasm_adjust_volume + 交错 + wasm_audio_buffer_to_wav)
+    r = bench(results, opt, "multipass_gain_to_wav", c, frames, chain_bytes, [&]() {
+        memcpy(work.data(), signal, samples * sizeof(float));
+        AudioBuffer copy = {work.data(), frames, channels, AUDIO_LAYOUT_PLANAR, c.sample_rate};
+        wasm_adjust_volume(&copy, kPipelineGain);
+        const float* input = work.data();
+        if (channels > 1) {
+            for (uint32_t i = 0; i < frames; i++) {
+                for (uint16_t ch = 0; ch < channels; ch++) {
+                    interleaved[(size_t)i * channels + ch] = work[(size_t)ch * frames + i];
+                }
+            }
+            input = interleaved.data();
+        }
+        wasm_audio_buffer_to_wav((float*)input, frames, channels, c.sample_rate, 16);
+    });
+    if (r && verify) {
+        check_pcm16(r, "multipass_gain_to_wav", &source, 0.0f, (const int16_t*)(g_memory_buffer.buffer + 44),
+                    ref_out, test_out);
+    }
+
+    r = bench(results, opt, "gain_to_wav", c, frames, chain_bytes, [&]() {
+        wasm_gain_to_wav(&source, kPipelineGain);
+    });
+    if (r && verify) {
+        wasm_gain_to_wav(&source, kPipelineGain);
+        check_pcm16(r, "gain_to_wav", &source, 0.0f, (const int16_t*)(g_memory_buffer.buffer + 44),
+                    ref_out, test_out);
+    }
+
+    // 增益 -> 高通 -> 限幅 -> 16 位
+    r = bench(results, opt, "multipass_process_to_wav", c, frames, chain_bytes, [&]() {
+        using namespace audio_pipeline;
+        auto stages = Gain(kPipelineGain) | Biquad::highpass(kPipelineHighpass, c.sample_rate) | Limit();
+        run_multipass(stages, &source, work.data(), pcm.data());
+    });
+    if (r && verify) {
+        check_pcm16(r, "multipass_process_to_wav", &source, kPipelineHighpass, pcm.data(), ref_out, test_out);
+    }
+
+    r = bench(results, opt, "process_to_wav", c, frames, chain_bytes, [&]() {
+        wasm_process_to_wav(&source, kPipelineGain, kPipelineHighpass);
+    });
+    if (r && verify) {
+        wasm_process_to_wav(&source, kPipelineGain, kPipelineHighpass);
+        check_pcm16(r, "process_to_wav", &source, kPipelineHighpass,
+                    (const int16_t*)(g_memory_buffer.buffer + 44), ref_out, test_out);
+    }
+
+    free(signal);
+}
+
+static void parse_args(int argc, char** argv, BenchOptions* opt) {
+    opt->max_duration = 3600;
+    opt->min_time = 0.2;
+    opt->out_path = NULL;
+    opt->quality_max_duration = 600;
+    opt->threads.clear();
+    const char* threads = "1,2,4,8";
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        if (strncmp(arg, "--filter=", 9) == 0) {
+            opt->filter = arg + 9;
+        } else if (strncmp(arg, "--max_duration=", 15) == 0) {
+            opt->max_duration = (uint32_t)atoi(arg + 15);
+        } else if (strncmp(arg, "--min_time=", 11) == 0) {
+            opt->min_time = atof(arg + 11);
+        } else if (strncmp(arg, "--out=", 6) == 0) {
+            opt->out_path = arg + 6;
+        } else if (strncmp(arg, "--quality_max_duration=", 23) == 0) {
+            opt->quality_max_duration = (uint32_t)atoi(arg + 23);
+        } else if (strncmp(arg, "--threads=", 10) == 0) {
+            threads = arg + 10;
+        } else {
+            fprintf(stderr, "未知参数: %s\n", arg);
+            exit(1);
+        }
+    }
+    for (const char* p = threads; *p;) {
+        uint32_t n = (uint32_t)strtoul(p, (char**)&p, 10);
+        if (n > 0) opt->threads.push_back(n);
+        if (*p) p++;
+    }
+}
+
+int main(int argc, char** argv) {
+    BenchOptions opt;
+    parse_args(argc, argv, &opt);
+
+    wasm_init_memory(16 * 1024 * 1024);
+
+    std::vector<BenchResult> results;
+    for (size_t d = 0; d < sizeof(kDurations) / sizeof(kDurations[0]); d++) {
+        if (kDurations[d] > opt.max_duration) continue;
+        for (size_t r = 0; r < sizeof(kSampleRates) / sizeof(kSampleRates[0]); r++) {
+            for (size_t ch = 0; ch < sizeof(kChannels) / sizeof(kChannels[0]); ch++) {
+                BenchCase c;
+                c.duration = kDurations[d];
+                c.sample_rate = kSampleRates[r];
+                c.channels = kChannels[ch];
+                c.frames = c.duration * c.sample_rate;
+                c.threads = 0;
+                run_case(results, opt, c);
+            }
+        }
+    }
+
+    wasm_cleanup();
+    task_pool_shutdown();
+
+    FILE* out = opt.out_path ? fopen(opt.out_path, "w") : stdout;
+    if (!out) {
+        fprintf(stderr, "无法写入 %s\n", opt.out_path);
+        return 1;
+    }
+
+    char date[32];
+    time_t t = time(NULL);
+    strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", localtime(&t));
+    fprintf(out, "{\n  \"context\": {\n    \"date\": \"%s\",\n    \"library\": \"audio_processor\",\n"
+                 "    \"min_time\": %.3f\n  },\n  \"benchmarks\": [\n", date, opt.min_time);
+    for (size_t i = 0; i < results.size(); i++) {
+        print_result(out, results[i], i + 1 == results.size());
+    }
+    fprintf(out, "  ]\n}\n");
+
+    if (out != stdout) fclose(out);
+
+    size_t failed = 0;
+    for (size_t i = 0; i < results.size(); i++) {
+        if (!results[i].quality_pass) {
+            fprintf(stderr, "质量不达标: %s\n", results[i].name.c_str());
+            failed++;
+        }
+    }
+    return failed ? 2 : 0;
+}
@@ -0,0 +1,424 @@
+/**
+ * WASM 与 JavaScript 实现的吞吐对比 (Node 无头运行)
+ *
+ * 直接加载 audio_processor.wasm (导出名从 audio_processor.js 中解析) 和 audio_legacy.js，
+ * 对同一份类语音合成输入 (speech_synth, 固定种子) 分别运行两条路径，校验输出一致后报告每个操作的加速比。
+ * WASM 路径计入数据拷入/拷出 WASM 内存的开销 (页面实际调用时同样需要)，另单独给出纯计算耗时。
+ *
+ * 输入信号优先由 WASM 导出的 wasm_generate_speech 生成；
+ * 旧版 audio_processor.wasm 未导出该函数时，读取 bench/gen_corpus 预先生成的 WAV 语料:
+ *   ./bench/gen_corpus --durations=1,10,60 --rates=24000,48000
+ *
+ * 运行:
+ *   node bench/bench_node.js                       # 默认 1/10/60 秒, 24kHz 单声道 + 48kHz 双声道
+ *   node bench/bench_node.js --durations=1,10 --min_time=0.5 --out=bench_output.txt
+ *   node bench/bench_node.js --corpus=/data/corpus  # 指定语料目录 (默认 bench/corpus)
+ *   node bench/bench_node.js --startup              # 只测启动: 各构建配置的下载体积与就绪耗时
+ *
+ * 启动测试按 audio_processor.cpp 开头的构建配置 (完整模块 / 核心模块 + 按需加载的功能模块) 分别统计
+ * 胶水代码 + .wasm 的字节数和就绪耗时 (读取 + 编译 + 实例化), 功能模块单独给出首次使用时的加载耗时;
+ * 缺少构建产物的配置标记为 missing
+ */
+
+const fs = require('fs');
+const path = require('path');
+
+const legacy = require('../audio_legacy.js');
+const { instantiateFromGlue } = require('../wasm_audio.js');
+
+const ROOT = path.join(__dirname, '..');
+
+// ==================== 参数 ====================
+
+function parseArgs(argv) {
+    const options = {
+        durations: [1, 10, 60],
+        formats: [{ sampleRate: 24000, channels: 1 }, { sampleRate: 48000, channels: 2 }],
+        segmentSeconds: 10,
+        minTime: 0.3,
+        corpus: path.join(__dirname, 'corpus'),
+        out: null,
+        startup: false,
+        startupRuns: 10
+    };
+    for (const arg of argv) {
+        const [key, value] = arg.replace(/^--/, '').split('=');
+        if (key === 'durations') options.durations = value.split(',').map(Number);
+        else if (key === 'segment') options.segmentSeconds = Number(value);
+        else if (key === 'min_time') options.minTime = Number(value);
+        else if (key === 'out') options.out = value;
+        else if (key === 'corpus') options.corpus = value;
+        else if (key === 'startup') options.startup = true;
+        else if (key === 'startup_runs') options.startupRuns = Number(value);
+        else throw new Error(`未知参数: ${arg}`);
+    }
+    return options;
+}
+
+// ==================== WASM 加载 ====================
+
+/**
+ * 加载一个构建产物 (name.js + name.wasm), 返回 WasmAudioKernels
+ * 核心模块缺少的导出由 kernels.feature() 按需加载同目录下的功能模块
+ */
+async function loadWasm(name = 'audio_processor') {
+    const glue = fs.readFileSync(path.join(ROOT, name + '.js'), 'utf8');
+    const binary = fs.readFileSync(path.join(ROOT, name + '.wasm'));
+    return instantiateFromGlue(glue, binary, feature => loadWasm(path.basename(feature.wasmUrl, '.wasm')));
+}
+
+// ==================== 测试数据 ====================
+
+/**
+ * Node 中的 AudioBuffer 替身 (平面存储)
+ */
+class SimpleAudioBuffer {
+    constructor(numberOfChannels, length, sampleRate) {
+        this.numberOfChannels = numberOfChannels;
+        this.length = length;
+        this.sampleRate = sampleRate;
+        this.channels = [];
+        for (let ch = 0; ch < numberOfChannels; ch++) {
+            this.channels.push(new Float32Array(length));
+        }
+    }
+
+    getChannelData(ch) {
+        return this.channels[ch];
+    }
+}
+
+// 与 bench/bench_audio.cpp 相同的信号参数
+const SIGNAL_SEED = 1;
+const SIGNAL_PEAK = 1.2;    // 最响的语句略超过 1.0, 覆盖削波分支
+const CORPUS_SEED = 1;      // gen_corpus 默认种子 (语料峰值为 1.0, 16 位存储)
+
+/**
+ * 读取 gen_corpus 生成的 16 位 PCM WAV (44 字节标准头)
+ */
+function readCorpusWav(file) {
+    const bytes = fs.readFileSync(file);
+    const view = new DataView(bytes.buffer, bytes.byteOffset, bytes.byteLength);
+    const channels = view.getUint16(22, true);
+    const sampleRate = view.getUint32(24, true);
+    const length = view.getUint32(40, true) / (channels * 2);
+    const buffer = new SimpleAudioBuffer(channels, length, sampleRate);
+    for (let ch = 0; ch < channels; ch++) {
+        const data = buffer.getChannelData(ch);
+        for (let i = 0, offset = 44 + ch * 2; i < length; i++, offset += channels * 2) {
+            const v = view.getInt16(offset, true);
+            data[i] = v < 0 ? v / 32768 : v / 32767;
+        }
+    }
+    return buffer;
+}
+
+// 类语音测试信号: WASM 生成, 或读取语料文件
+function makeSignal(kernels, seconds, sampleRate, channels, corpusDir) {
+    const generated = kernels.generateSpeech(
+        { frames: Math.round(seconds * sampleRate), sampleRate, channels, seed: SIGNAL_SEED, peak: SIGNAL_PEAK },
+        (ch, length, rate) => new SimpleAudioBuffer(ch, length, rate));
+    if (generated) return generated;
+
+    const file = path.join(corpusDir, `speech_${seconds}s_${sampleRate}Hz_${channels}ch_s${CORPUS_SEED}.wav`);
+    if (!fs.existsSync(file)) {
+        throw new Error(`audio_processor.wasm 未导出 wasm_generate_speech，且找不到语料 ${file}\n` +
+            `请先运行: ./bench/gen_corpus --out=${corpusDir} --durations=${seconds} --rates=${sampleRate} --channels=${channels}`);
+    }
+    return readCorpusWav(file);
+}
+
+function splitPlan(buffer, segmentSeconds) {
+    const samplesPerSegment = segmentSeconds * buffer.sampleRate;
+    const plan = [];
+    for (let start = 0; start < buffer.length; start += samplesPerSegment) {
+        plan.push({ start, length: Math.min(samplesPerSegment, buffer.length - start) });
+    }
+    return plan;
+}
+
+// ==================== 计时 ====================
+
+function now() {
+    return Number(process.hrtime.bigint()) / 1e6;
+}
+
+/**
+ * 反复运行 fn 直到累计时间超过 minTime 秒，返回每次平均毫秒数
+ * fn 可返回 { kernelMs } 报告其中纯 WASM 计算的耗时
+ */
+function timeIt(fn, minTime) {
+    let iterations = 0;
+    let kernelMs = 0;
+    const start = now();
+    let elapsed = 0;
+    do {
+        const r = fn();
+        if (r && r.kernelMs !== undefined) kernelMs += r.kernelMs;
+        iterations++;
+        elapsed = now() - start;
+    } while (elapsed < minTime * 1000);
+    return { ms: elapsed / iterations, kernelMs: kernelMs / iterations, iterations };
+}
+
+// ==================== 各操作的两种实现 ====================
+
+const operations = {
+    // AudioBuffer -> 16 位 WAV
+    wav_encode: {
+        js: {
+            legacy: buffer => new Uint8Array(legacy.encodeWavLegacy(buffer))
+        },
+        wasm: (kernels, buffer) => () => {
+            const output = new Uint8Array(kernels.encodeWav(buffer));
+            return { output, kernelMs: kernels.lastKernelMs };
+        },
+        equal: pcmEqual
+    },
+
+    // 按片段时长切分 (只比较样本复制，不含编码)
+    split: {
+        js: {
+            legacy: (buffer, plan) => plan.map(seg => {
+                const target = new SimpleAudioBuffer(buffer.numberOfChannels, seg.length, buffer.sampleRate);
+                legacy.copySegmentLegacy(buffer, target, seg.start);
+                return target;
+            }),
+            typed: (buffer, plan) => plan.map(seg => {
+                const target = new SimpleAudioBuffer(buffer.numberOfChannels, seg.length, buffer.sampleRate);
+                legacy.copySegmentTyped(buffer, target, seg.start);
+                return target;
+            })
+        },
+        // 源数据每次重新上传 (平面布局)，每个片段调用一次切片并拷出
+        wasm: (kernels, buffer, plan) => () => {
+            const output = kernels.sliceSegments(buffer, plan,
+                (channels, length, sampleRate) => new SimpleAudioBuffer(channels, length, sampleRate));
+            return { output, kernelMs: kernels.lastKernelMs };
+        },
+        equal: (a, b) => a.length === b.length && a.every((seg, i) => buffersEqual(seg, b[i]))
+    },
+
+    // 切分并逐段编码为 WAV (页面实际的切分流程)
+    // WASM 支持切片视图时片段不复制，直接从源数据编码；旧版 WASM 退回切片 + 逐段编码
+    split_encode: {
+        js: {
+            typed: (buffer, plan) => operations.split.js.typed(buffer, plan)
+                .map(seg => new Uint8Array(legacy.encodeWavLegacy(seg)))
+        },
+        wasm: (kernels, buffer, plan) => () => {
+            let kernelMs = 0;
+            let output;
+            if (kernels.supportsViews) {
+                output = kernels.encodeSegments(buffer, plan).map(wav => new Uint8Array(wav));
+                kernelMs = kernels.lastKernelMs;
+            } else {
+                const slices = kernels.sliceSegments(buffer, plan,
+                    (channels, length, sampleRate) => new SimpleAudioBuffer(channels, length, sampleRate));
+                kernelMs = kernels.lastKernelMs;
+                output = slices.map(seg => {
+                    const wav = new Uint8Array(kernels.encodeWav(seg));
+                    kernelMs += kernels.lastKernelMs;
+                    return wav;
+                });
+            }
+            return { output, kernelMs };
+        },
+        equal: (a, b) => a.length === b.length && a.every((wav, i) => pcmEqual(wav, b[i]))
+    },
+
+    // 合并片段
+    merge: {
+        js: {
+            legacy: (buffer, plan, segments) => {
+                const target = new SimpleAudioBuffer(buffer.numberOfChannels, buffer.length, buffer.sampleRate);
+                legacy.concatSegmentsLegacy(segments, target);
+                return target;
+            },
+            typed: (buffer, plan, segments) => {
+                const target = new SimpleAudioBuffer(buffer.numberOfChannels, buffer.length, buffer.sampleRate);
+                legacy.concatSegmentsTyped(segments, target);
+                return target;
+            }
+        },
+        wasm: (kernels, buffer, plan, segments) => () => {
+            const output = kernels.concat(segments,
+                (channels, length, sampleRate) => new SimpleAudioBuffer(channels, length, sampleRate));
+            return { output, kernelMs: kernels.lastKernelMs };
+        },
+        equal: buffersEqual
+    }
+};
+
+function bytesEqual(a, b) {
+    if (a.length !== b.length) return false;
+    for (let i = 0; i < a.length; i++) {
+        if (a[i] !== b[i]) return false;
+    }
+    return true;
+}
+
+// WAV 头逐字节一致, PCM 样本允许 ±1 LSB:
+// C 端以 float 计算 sample * 0x7FFF, JS 以 double 计算, 截断前的舍入偶尔相差 1
+function pcmEqual(a, b) {
+    if (a.length !== b.length || !bytesEqual(a.subarray(0, 44), b.subarray(0, 44))) return false;
+    const pa = new Int16Array(a.buffer, a.byteOffset + 44, (a.length - 44) >> 1);
+    const pb = new Int16Array(b.buffer, b.byteOffset + 44, (b.length - 44) >> 1);
+    for (let i = 0; i < pa.length; i++) {
+        if (Math.abs(pa[i] - pb[i]) > 1) return false;
+    }
+    return true;
+}
+
+function buffersEqual(a, b) {
+    if (a.numberOfChannels !== b.numberOfChannels || a.length !== b.length) return false;
+    for (let ch = 0; ch < a.numberOfChannels; ch++) {
+        if (!bytesEqual(a.getChannelData(ch), b.getChannelData(ch))) return false;
+    }
+    return true;
+}
+
+// ==================== 启动 ====================
+
+// 页面启动时加载 initial, 首次使用对应功能时加载 lazy
+const STARTUP_CONFIGS = [
+    { name: 'full', initial: 'audio_processor', lazy: [] },
+    { name: 'core', initial: 'audio_core', lazy: [] },
+    { name: 'core+dsp', initial: 'audio_core', lazy: ['audio_dsp'] },
+    { name: 'core+speech', initial: 'audio_core', lazy: ['audio_speech'] }
+];
+
+function artifactBytes(name) {
+    const files = [name + '.js', name + '.wasm'].map(file => path.join(ROOT, file));
+    if (!files.every(file => fs.existsSync(file))) return null;
+    return files.reduce((sum, file) => sum + fs.statSync(file).size, 0);
+}
+
+function median(values) {
+    const sorted = values.slice().sort((a, b) => a - b);
+    return sorted[sorted.length >> 1];
+}
+
+// 就绪耗时: 读取文件 + 编译 + 实例化 + 全局构造 (每次重新编译, 不命中任何缓存)
+async function timeReady(name, runs) {
+    const times = [];
+    for (let i = 0; i < runs; i++) {
+        const t0 = now();
+        await loadWasm(name);
+        times.push(now() - t0);
+    }
+    return median(times);
+}
+
+async function measureStartup(runs) {
+    const results = [];
+    for (const config of STARTUP_CONFIGS) {
+        const names = [config.initial].concat(config.lazy);
+        const bytes = names.map(artifactBytes);
+        if (bytes.some(b => b === null)) {
+            results.push({ name: config.name, missing: true, files: names.map(n => n + '.{js,wasm}') });
+            console.error(`${config.name.padEnd(14)} missing (${names.join(', ')})`);
+            continue;
+        }
+        const result = {
+            name: config.name,
+            initial_bytes: bytes[0],
+            ready_ms: await timeReady(config.initial, runs),
+            lazy: []
+        };
+        for (let i = 0; i < config.lazy.length; i++) {
+            result.lazy.push({ module: config.lazy[i], bytes: bytes[i + 1], ready_ms: await timeReady(config.lazy[i], runs) });
+        }
+        results.push(result);
+        console.error(
+            `${config.name.padEnd(14)} ${String(result.initial_bytes).padStart(8)} B  ready ${result.ready_ms.toFixed(2)} ms` +
+            result.lazy.map(l => `  + ${l.module} ${l.bytes} B / ${l.ready_ms.toFixed(2)} ms`).join('')
+        );
+    }
+    return results;
+}
+
+// ==================== 主流程 ====================
+
+async function main() {
+    const options = parseArgs(process.argv.slice(2));
+    if (options.startup) {
+        const report = JSON.stringify({
+            context: { date: new Date().toISOString(), node: process.version, runs: options.startupRuns },
+            startup: await measureStartup(options.startupRuns)
+        }, null, 2);
+        if (options.out) {
+            fs.writeFileSync(options.out, report + '\n');
+        } else {
+            console.log(report);
+        }
+        return;
+    }
+
+    const kernels = await loadWasm();
+    const results = [];
+
+    for (const seconds of options.durations) {
+        for (const format of options.formats) {
+            const buffer = makeSignal(kernels, seconds, format.sampleRate, format.channels, options.corpus);
+            const plan = splitPlan(buffer, options.segmentSeconds);
+            const segments = operations.split.js.typed(buffer, plan);
+            const caseName = `${seconds}s/${format.sampleRate}Hz/${format.channels}ch`;
+
+            for (const [opName, op] of Object.entries(operations)) {
+                const runWasm = op.wasm(kernels, buffer, plan, segments);
+                const wasmOutput = runWasm().output;
+                const wasmTime = timeIt(runWasm, options.minTime);
+
+                for (const [variant, jsFn] of Object.entries(op.js)) {
+                    const jsOutput = jsFn(buffer, plan, segments);
+                    const equal = op.equal(jsOutput, wasmOutput);
+                    const jsTime = timeIt(() => jsFn(buffer, plan, segments), options.minTime);
+
+                    const result = {
+                        name: `${opName}/${caseName}`,
+                        js_variant: variant,
+                        outputs_equal: equal,
+                        js_ms: jsTime.ms,
+                        wasm_ms: wasmTime.ms,
+                        wasm_kernel_ms: wasmTime.kernelMs,
+                        speedup: jsTime.ms / wasmTime.ms,
+                        kernel_speedup: jsTime.ms / wasmTime.kernelMs
+                    };
+                    results.push(result);
+                    console.error(
+                        `${result.name.padEnd(28)} ${variant.padEnd(7)} ` +
+                        `js ${result.js_ms.toFixed(3).padStart(9)} ms  ` +
+                        `wasm ${result.wasm_ms.toFixed(3).padStart(9)} ms (kernel ${result.wasm_kernel_ms.toFixed(3)})  ` +
+                        `x${result.speedup.toFixed(2)}${equal ? '' : '  ✗ 输出不一致'}`
+                    );
+                }
+            }
+        }
+    }
+
+    kernels.module._wasm_cleanup();
+
+    const report = JSON.stringify({
+        context: { date: new Date().toISOString(), node: process.version, min_time: options.minTime },
+        benchmarks: results
+    }, null, 2);
+    if (options.out) {
+        fs.writeFileSync(options.out, report + '\n');
+    } else {
+        console.log(report);
+    }
+
+    if (results.some(r => !r.outputs_equal)) {
+        process.exitCode = 1;
+    }
+}
+
+if (require.main === module) {
+    main().catch(error => {
+        console.error(error);
+        process.exit(1);
+    });
+}
+
+module.exports = { loadWasm };
@@ -0,0 +1,168 @@
+// 基准测试语料生成 - 用 speech_synth 生成类语音 WAV 文件 (16 位 PCM)
+// 同样的参数在任何机器上生成逐字节相同的文件, 不需要分发真实录音
+//
+// 编译:
+//   g++ -O2 -std=c++11 -I. bench/gen_corpus.cpp speech_synth.cpp -o bench/gen_corpus
+// 运行:
+//   ./bench/gen_corpus                                   # 默认 1/10/60/600 秒, 全部采样率 / 声道组合
+//   ./bench/gen_corpus --durations=1,7200 --rates=24000 --channels=1
+//   ./bench/gen_corpus --out=bench/corpus --seed=7 --peak=0.9
+//
+// 文件名: speech_<秒>s_<采样率>Hz_<声道>ch_s<种子>.wav (bench/bench_node.js 按此读取)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <sys/stat.h>
+
+#include <string>
+#include <vector>
+
+#include "audio_processor.h"
+#include "speech_synth.h"
+
+static const uint32_t kBlockFrames = 65536;     // 分块渲染, 2 小时的文件也只占用固定内存
+
+struct CorpusOptions {
+    std::string out_dir;
+    std::vector<uint32_t> durations;
+    std::vector<uint32_t> rates;
+    std::vector<uint32_t> channels;
+    uint32_t seed;
+    float peak;
+};
+
+static std::vector<uint32_t> parse_list(const char* text) {
+    std::vector<uint32_t> values;
+    while (*text) {
+        char* end;
+        unsigned long value = strtoul(text, &end, 10);
+        if (end == text) break;
+        values.push_back((uint32_t)value);
+        text = *end == ',' ? end + 1 : end;
+    }
+    return values;
+}
+
+static void parse_args(int argc, char** argv, CorpusOptions* opt) {
+    opt->out_dir = "bench/corpus";
+    opt->durations = parse_list("1,10,60,600");
+    opt->rates = parse_list("16000,22050,24000,48000");
+    opt->channels = parse_list("1,2");
+    opt->seed = 1;
+    opt->peak = 1.0f;
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        if (strncmp(arg, "--out=", 6) == 0) {
+            opt->out_dir = arg + 6;
+        } else if (strncmp(arg, "--durations=", 12) == 0) {
+            opt->durations = parse_list(arg + 12);
+        } else if (strncmp(arg, "--rates=", 8) == 0) {
+            opt->rates = parse_list(arg + 8);
+        } else if (strncmp(arg, "--channels=", 11) == 0) {
+            opt->channels = parse_list(arg + 11);
+        } else if (strncmp(arg, "--seed=", 7) == 0) {
+            opt->seed = (uint32_t)strtoul(arg + 7, NULL, 10);
+        } else if (strncmp(arg, "--peak=", 7) == 0) {
+            opt->peak = (float)atof(arg + 7);
+        } else {
+            fprintf(stderr, "未知参数: %s\n", arg);
+            exit(1);
+        }
+    }
+}
+
+// 与 wasm_audio_buffer_to_wav / encodeWavLegacy 相同的量化方式
+static inline int16_t to_pcm16(float s) {
+    if (s > 1.0f) s = 1.0f;
+    if (s < -1.0f) s = -1.0f;
+    return (int16_t)(s < 0 ? s * 32768.0f : s * 32767.0f);
+}
+
+static int write_wav(const char* path, uint32_t seconds, uint32_t sample_rate, uint16_t channels,
+                     const CorpusOptions& opt) {
+    FILE* f = fopen(path, "wb");
+    if (!f) {
+        fprintf(stderr, "无法写入 %s: %s\n", path, strerror(errno));
+        return 0;
+    }
+
+    const uint64_t frames = (uint64_t)seconds * sample_rate;
+    const uint64_t data_size = frames * channels * 2;
+    if (data_size + 36 > 0xFFFFFFFFull) {
+        fprintf(stderr, "%s 超过 WAV 的 4GB 限制\n", path);
+        fclose(f);
+        return 0;
+    }
+
+    WAVHeader header;
+    memcpy(header.riff, "RIFF", 4);
+    header.file_size = (uint32_t)(36 + data_size);
+    memcpy(header.wave, "WAVE", 4);
+    memcpy(header.fmt, "fmt ", 4);
+    header.fmt_size = 16;
+    header.audio_format = 1;
+    header.num_channels = channels;
+    header.sample_rate = sample_rate;
+    header.byte_rate = sample_rate * channels * 2;
+    header.block_align = channels * 2;
+    header.bits_per_sample = 16;
+    memcpy(header.data, "data", 4);
+    header.data_size = (uint32_t)data_size;
+    fwrite(&header, sizeof(header), 1, f);
+
+    SpeechSynthParams params = {sample_rate, channels, opt.seed, opt.peak};
+    SpeechSynth synth;
+    speech_synth_init(&synth, &params);
+
+    std::vector<float> planar((size_t)kBlockFrames * channels);
+    std::vector<int16_t> pcm((size_t)kBlockFrames * channels);
+    float* outputs[SPEECH_SYNTH_MAX_CHANNELS];
+
+    for (uint64_t done = 0; done < frames;) {
+        uint32_t n = frames - done < kBlockFrames ? (uint32_t)(frames - done) : kBlockFrames;
+        for (uint16_t ch = 0; ch < channels; ch++) outputs[ch] = &planar[(size_t)ch * kBlockFrames];
+        speech_synth_render(&synth, outputs, n);
+
+        // 交错并量化
+        for (uint32_t i = 0; i < n; i++) {
+            for (uint16_t ch = 0; ch < channels; ch++) {
+                pcm[(size_t)i * channels + ch] = to_pcm16(outputs[ch][i]);
+            }
+        }
+        fwrite(pcm.data(), sizeof(int16_t), (size_t)n * channels, f);
+        done += n;
+    }
+
+    fclose(f);
+    return 1;
+}
+
+int main(int argc, char** argv) {
+    CorpusOptions opt;
+    parse_args(argc, argv, &opt);
+
+    if (mkdir(opt.out_dir.c_str(), 0755) != 0 && errno != EEXIST) {
+        fprintf(stderr, "无法创建目录 %s: %s\n", opt.out_dir.c_str(), strerror(errno));
+        return 1;
+    }
+
+    for (size_t d = 0; d < opt.durations.size(); d++) {
+        for (size_t r = 0; r < opt.rates.size(); r++) {
+            for (size_t c = 0; c < opt.channels.size(); c++) {
+                uint16_t channels = (uint16_t)opt.channels[c];
+                if (channels == 0 || channels > SPEECH_SYNTH_MAX_CHANNELS) {
+                    fprintf(stderr, "跳过不支持的声道数 %u\n", channels);
+                    continue;
+                }
+                char path[512];
+                snprintf(path, sizeof(path), "%s/speech_%us_%uHz_%uch_s%u.wav", opt.out_dir.c_str(),
+                         opt.durations[d], opt.rates[r], channels, opt.seed);
+                if (!write_wav(path, opt.durations[d], opt.rates[r], channels, opt)) return 1;
+                fprintf(stderr, "%s\n", path);
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,275 @@
+// 标量参考实现 (见 reference_kernels.h)
+// 刻意保持最直接的写法: 不做向量化 / 分块 / 循环交换, 包括交叉淡化的增益方向在内都与原实现逐位一致
+
+#include <math.h>
+#include <string.h>
+
+#include <vector>
+
+#include "reference_kernels.h"
+
+void ref_to_pcm16(const float* input, size_t count, int16_t* output) {
+    for (size_t i = 0; i < count; i++) {
+        float sample = fmaxf(-1.0f, fminf(1.0f, input[i]));
+        output[i] = (int16_t)(sample < 0 ? sample * 0x8000 : sample * 0x7FFF);
+    }
+}
+
+void ref_pcm16_to_float(const int16_t* input, size_t count, float* output) {
+    for (size_t i = 0; i < count; i++) {
+        output[i] = (float)input[i] / (input[i] < 0 ? 0x8000 : 0x7FFF);
+    }
+}
+
+uint32_t ref_slice(const AudioBuffer* source, uint32_t start_sample, uint32_t slice_length, float* output) {
+    if (start_sample + slice_length > source->length) {
+        slice_length = source->length - start_sample;
+    }
+    for (uint16_t ch = 0; ch < source->num_channels; ch++) {
+        const float* src = source->data + (size_t)ch * source->length + start_sample;
+        float* dst = output + (size_t)ch * slice_length;
+        for (uint32_t i = 0; i < slice_length; i++) dst[i] = src[i];
+    }
+    return slice_length;
+}
+
+uint32_t ref_merge(const AudioBuffer* buffers, uint32_t num_buffers, float* output) {
+    if (num_buffers == 0) return 0;
+
+    uint16_t num_channels = buffers[0].num_channels;
+    uint32_t total_length = 0;
+    for (uint32_t i = 0; i < num_buffers; i++) {
+        if (buffers[i].num_channels != num_channels || buffers[i].sample_rate != buffers[0].sample_rate) {
+            return 0;
+        }
+        total_length += buffers[i].length;
+    }
+
+    uint32_t offset = 0;
+    for (uint32_t i = 0; i < num_buffers; i++) {
+        for (uint16_t ch = 0; ch < num_channels; ch++) {
+            const float* src = buffers[i].data + (size_t)ch * buffers[i].length;
+            float* dst = output + (size_t)ch * total_length + offset;
+            for (uint32_t j = 0; j < buffers[i].length; j++) dst[j] = src[j];
+        }
+        offset += buffers[i].length;
+    }
+    return total_length;
+}
+
+uint32_t ref_resample_length(const AudioBuffer* source, uint32_t target_sample_rate) {
+    if (source->sample_rate == target_sample_rate) return source->length;
+    double ratio = (double)target_sample_rate / source->sample_rate;
+    return (uint32_t)(source->length * ratio);
+}
+
+uint32_t ref_resample(const AudioBuffer* source, uint32_t target_sample_rate, float* output) {
+    uint32_t target_length = ref_resample_length(source, target_sample_rate);
+    if (source->sample_rate == target_sample_rate) {
+        memcpy(output, source->data, (size_t)target_length * source->num_channels * sizeof(float));
+        return target_length;
+    }
+
+    double ratio = (double)target_sample_rate / source->sample_rate;
+    for (uint16_t ch = 0; ch < source->num_channels; ch++) {
+        const float* src = source->data + (size_t)ch * source->length;
+        float* dst = output + (size_t)ch * target_length;
+        for (uint32_t i = 0; i < target_length; i++) {
+            double src_pos = i / ratio;
+            uint32_t src_idx = (uint32_t)src_pos;
+            double frac = src_pos - src_idx;
+            if (src_idx >= source->length - 1) {
+                dst[i] = src[source->length - 1];
+            } else {
+                dst[i] = (float)(src[src_idx] * (1 - frac) + src[src_idx + 1] * frac);
+            }
+        }
+    }
+    return target_length;
+}
+
+void ref_adjust_volume(const float* input, size_t count, float volume, float* output) {
+    for (size_t i = 0; i < count; i++) {
+        output[i] = fmaxf(-1.0f, fminf(1.0f, input[i] * volume));
+    }
+}
+
+uint32_t ref_cross_fade(const AudioBuffer* buffer1, const AudioBuffer* buffer2, uint32_t fade_length,
+                        float* output) {
+    uint32_t total_length = buffer1->length + buffer2->length - fade_length;
+    uint32_t head = buffer1->length - fade_length;
+
+    for (uint16_t ch = 0; ch < buffer1->num_channels; ch++) {
+        const float* src1 = buffer1->data + (size_t)ch * buffer1->length;
+        const float* src2 = buffer2->data + (size_t)ch * buffer2->length;
+        float* dst = output + (size_t)ch * total_length;
+
+        for (uint32_t i = 0; i < head; i++) dst[i] = src1[i];
+        for (uint32_t i = 0; i < fade_length; i++) {
+            float fade_out = (float)i / fade_length;
+            float fade_in = 1.0f - fade_out;
+            dst[head + i] = src1[head + i] * fade_out + src2[i] * fade_in;
+        }
+        for (uint32_t i = fade_length; i < buffer2->length; i++) dst[head + i] = src2[i];
+    }
+    return total_length;
+}
+
+void ref_process_to_pcm16(const AudioBuffer* source, float gain, float highpass_hz, int16_t* output) {
+    float b0 = 1.0f, b1 = 0.0f, b2 = 0.0f, a1 = 0.0f, a2 = 0.0f;
+    if (highpass_hz > 0) {
+        double w0 = 2.0 * M_PI * highpass_hz / source->sample_rate;
+        double cw = cos(w0);
+        double alpha = sin(w0) / (2.0 * 0.70710678118654752);
+        double a0 = 1 + alpha;
+        b0 = (float)((1 + cw) / 2 / a0);
+        b1 = (float)(-(1 + cw) / a0);
+        b2 = (float)((1 + cw) / 2 / a0);
+        a1 = (float)(-2 * cw / a0);
+        a2 = (float)((1 - alpha) / a0);
+    }
+
+    uint16_t channels = source->num_channels;
+    for (uint16_t ch = 0; ch < channels; ch++) {
+        const float* src = source->data + (size_t)ch * source->length;
+        float z1 = 0.0f, z2 = 0.0f;
+        for (uint32_t i = 0; i < source->length; i++) {
+            float x = src[i] * gain;
+            if (highpass_hz > 0) {
+                float y = b0 * x + z1;
+                z1 = b1 * x - a1 * y + z2;
+                z2 = b2 * x - a2 * y;
+                x = y;
+            }
+            x = fmaxf(-1.0f, fminf(1.0f, x));
+            output[(size_t)i * channels + ch] = (int16_t)(x < 0 ? x * 0x8000 : x * 0x7FFF);
+        }
+    }
+}
+
+uint32_t ref_analyze(const AudioBuffer* source, uint32_t block_frames, AudioLevel* output) {
+    uint32_t num_blocks = (source->length + block_frames - 1) / block_frames;
+    for (uint32_t b = 0; b < num_blocks; b++) {
+        uint32_t start = b * block_frames;
+        uint32_t end = start + block_frames < source->length ? start + block_frames : source->length;
+        double sum = 0.0;
+        float peak = 0.0f;
+        for (uint16_t ch = 0; ch < source->num_channels; ch++) {
+            const float* src = source->data + (size_t)ch * source->length;
+            for (uint32_t i = start; i < end; i++) {
+                sum += (double)src[i] * src[i];
+                if (fabsf(src[i]) > peak) peak = fabsf(src[i]);
+            }
+        }
+        output[b].rms = (float)sqrt(sum / ((double)(end - start) * source->num_channels));
+        output[b].peak = peak;
+    }
+    return num_blocks;
+}
+
+uint32_t ref_prepare_reference(const AudioBuffer* source, uint32_t target_sample_rate, float max_seconds,
+                               float silence_db, float* output) {
+    // 下混
+    std::vector<float> mono(source->length, 0.0f);
+    for (uint16_t ch = 0; ch < source->num_channels; ch++) {
+        const float* src = source->data + (size_t)ch * source->length;
+        for (uint32_t i = 0; i < source->length; i++) mono[i] += src[i];
+    }
+    if (source->num_channels > 1) {
+        for (uint32_t i = 0; i < source->length; i++) mono[i] *= 1.0f / source->num_channels;
+    }
+
+    // 降采样时先低通: Blackman 窗 sinc, 截止频率 0.42 * 目标采样率, 每侧 16 个过零点, 两端以外按 0 处理
+    if (target_sample_rate < source->sample_rate) {
+        double cutoff = 0.42 * target_sample_rate / source->sample_rate;
+        int64_t half = (int64_t)ceil(16 / (2.0 * cutoff));
+        if (half > 512) half = 512;
+        std::vector<float> taps(2 * half + 1);
+        double sum = 0.0;
+        for (int64_t k = 0; k <= 2 * half; k++) {
+            double n = (double)(k - half);
+            double x = 2.0 * M_PI * cutoff * n;
+            double sinc = n == 0 ? 1.0 : sin(x) / x;
+            double window = 0.42 + 0.5 * cos(M_PI * n / half) + 0.08 * cos(2.0 * M_PI * n / half);
+            taps[k] = (float)(sinc * window);
+            sum += taps[k];
+        }
+        for (int64_t k = 0; k <= 2 * half; k++) taps[k] = (float)(taps[k] / sum);
+
+        std::vector<float> filtered(source->length);
+        for (int64_t i = 0; i < (int64_t)source->length; i++) {
+            float acc = 0.0f;
+            for (int64_t k = 0; k <= 2 * half; k++) {
+                int64_t j = i + k - half;
+                if (j >= 0 && j < (int64_t)source->length) acc += taps[k] * mono[j];
+            }
+            filtered[i] = acc;
+        }
+        mono.swap(filtered);
+    }
+
+    // 重采样
+    AudioBuffer mono_buffer = {mono.data(), source->length, 1, AUDIO_LAYOUT_PLANAR, source->sample_rate};
+    std::vector<float> x(ref_resample_length(&mono_buffer, target_sample_rate));
+    uint32_t length = ref_resample(&mono_buffer, target_sample_rate, x.data());
+    if (length == 0) return 0;
+
+    // 10ms 帧能量
+    uint32_t frame = target_sample_rate / 100 ? target_sample_rate / 100 : 1;
+    uint32_t frames = (length + frame - 1) / frame;
+    std::vector<float> rms(frames);
+    float peak = 0.0f;
+    for (uint32_t f = 0; f < frames; f++) {
+        uint32_t start = f * frame;
+        uint32_t end = start + frame < length ? start + frame : length;
+        double sum = 0.0;
+        for (uint32_t i = start; i < end; i++) sum += (double)x[i] * x[i];
+        rms[f] = (float)sqrt(sum / (end - start));
+        if (rms[f] > peak) peak = rms[f];
+    }
+    float threshold = peak * powf(10.0f, silence_db / 20.0f);
+
+    // 首尾有声帧 (各留 2 帧)
+    int64_t first = -1, last = -1;
+    for (uint32_t f = 0; f < frames; f++) {
+        if (rms[f] > 0.0f && rms[f] >= threshold) {
+            if (first < 0) first = f;
+            last = f;
+        }
+    }
+    if (first < 0) {
+        first = 0;
+        last = frames - 1;
+    } else {
+        first = first - 2 > 0 ? first - 2 : 0;
+        last = last + 2 < (int64_t)frames ? last + 2 : frames - 1;
+    }
+
+    // 有声帧能量之和最大的窗口 (逐个窗口求和)
+    uint32_t window = max_seconds > 0 ? (uint32_t)(max_seconds * 100) : frames;
+    if (window == 0) window = 1;
+    uint32_t span = (uint32_t)(last - first + 1);
+    uint32_t best = (uint32_t)first;
+    if (window < span) {
+        std::vector<double> prefix(span + 1, 0.0);
+        for (uint32_t k = 0; k < span; k++) {
+            float e = rms[first + k];
+            prefix[k + 1] = prefix[k] + (e >= threshold ? e : 0.0f);
+        }
+        double best_sum = -1.0;
+        for (uint32_t k = 0; k + window <= span; k++) {
+            double sum = prefix[k + window] - prefix[k];
+            if (sum > best_sum) {
+                best_sum = sum;
+                best = (uint32_t)first + k;
+            }
+        }
+    } else {
+        window = span;
+    }
+
+    uint32_t start = best * frame;
+    uint32_t end = (best + window) * frame < length ? (best + window) * frame : length;
+    memcpy(output, x.data() + start, (size_t)(end - start) * sizeof(float));
+    return end - start;
+}
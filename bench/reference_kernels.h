@@ -0,0 +1,39 @@
+// 标量参考实现 - audio_processor.cpp 中各 DSP 函数最初的逐样本版本
+// 冻结不再修改, 作为优化实现 (SIMD / 融合 / 特化) 的数值基准
+// 与导出函数不同, 输出写入调用方提供的缓冲区, 不经过 g_memory_buffer
+
+#ifndef REFERENCE_KERNELS_H
+#define REFERENCE_KERNELS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "audio_processor.h"
+
+// float -> 16 位 PCM (与 wasm_audio_buffer_to_wav 的数据部分一致)
+void ref_to_pcm16(const float* input, size_t count, int16_t* output);
+
+// 16 位 PCM -> float (与 wasm_wav_to_audio_buffer 一致)
+void ref_pcm16_to_float(const int16_t* input, size_t count, float* output);
+
+// 以下输入输出均为平面布局, 返回输出帧数
+uint32_t ref_slice(const AudioBuffer* source, uint32_t start_sample, uint32_t slice_length, float* output);
+uint32_t ref_merge(const AudioBuffer* buffers, uint32_t num_buffers, float* output);
+uint32_t ref_resample_length(const AudioBuffer* source, uint32_t target_sample_rate);
+uint32_t ref_resample(const AudioBuffer* source, uint32_t target_sample_rate, float* output);
+void ref_adjust_volume(const float* input, size_t count, float volume, float* output);
+uint32_t ref_cross_fade(const AudioBuffer* buffer1, const AudioBuffer* buffer2, uint32_t fade_length,
+                        float* output);
+
+// 增益 -> 高通 (RBJ, Q = 0.7071) -> 限幅 -> 16 位 PCM, 输出交错布局
+// highpass_hz <= 0 时不滤波; 融合流水线 (audio_pipeline.h) 的逐样本对照
+void ref_process_to_pcm16(const AudioBuffer* source, float gain, float highpass_hz, int16_t* output);
+
+// 每 block_frames 帧的 RMS / 峰值 (平面布局输入), 与 wasm_analyze_audio 的输出格式一致, 返回块数
+uint32_t ref_analyze(const AudioBuffer* source, uint32_t block_frames, AudioLevel* output);
+
+// 参考音频预处理 (与 wasm_prepare_reference 相同的步骤), 输出单声道, output 至少为重采样后的长度
+uint32_t ref_prepare_reference(const AudioBuffer* source, uint32_t target_sample_rate, float max_seconds,
+                               float silence_db, float* output);
+
+#endif // REFERENCE_KERNELS_H
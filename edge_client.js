@@ -0,0 +1,154 @@
+/**
+ * 边缘克隆客户端 - 页面由 Worker (worker/index.js) 提供时, 整段克隆交给 /api/edge/clone
+ * TTS 音频与参考音频各上传一次, 切分 / 分发 / 合并在边缘完成 (worker/edge_clone.js).
+ *
+ * 响应为事件流: 每行一个 JSON 事件, audio 事件行之后紧跟 bytes 个字节的 WAV 数据 (按片段顺序),
+ * 第一个 audio 数据以 44 字节文件头开头, 文件头中的长度在 result 事件 (data_bytes) 到达后改写.
+ * 浏览器中挂到 window，Node 中通过 module.exports 导出
+ */
+(function(root) {
+    const EDGE_CLONE_PATH = '/api/edge/clone';
+    const EDGE_HEALTH_PATH = '/api/edge/health';
+    const WAV_HEADER_BYTES = 44;
+
+    /**
+     * 查询同源 Worker 提供的边缘服务, 不是由 Worker 提供 (静态托管 / file://) 时返回 null
+     * @returns {Promise<{clone: boolean, tts: boolean}|null>}
+     */
+    async function detectEdgeServices(fetchImpl = root.fetch) {
+        if (typeof location === 'undefined' || !location.protocol.startsWith('http')) return null;
+        try {
+            const response = await fetchImpl(EDGE_HEALTH_PATH, { cache: 'no-store' });
+            if (!response.ok) return null;
+            const result = await response.json();
+            return result && result.success ? { clone: !!result.clone, tts: !!result.tts } : null;
+        } catch (error) {
+            return null;
+        }
+    }
+
+    /**
+     * 读取事件流, 每个事件调用 onFrame(event, parts); audio 事件的 parts 为数据块数组 (其他事件为 null)
+     * 数据块直接引用收到的 chunk, 不拼接
+     */
+    async function readFrames(body, onFrame) {
+        const reader = body.getReader();
+        let line = [];          // 当前事件行已收到的字节
+        let pending = null;     // 等待数据的 audio 事件
+        let parts = [];
+        let need = 0;
+
+        const parseLine = () => {
+            const decoder = new TextDecoder();
+            const text = line.map(bytes => decoder.decode(bytes, { stream: true })).join('') + decoder.decode();
+            line = [];
+            return text.trim() ? JSON.parse(text) : null;
+        };
+
+        for (;;) {
+            const { done, value } = await reader.read();
+            if (done) break;
+            let offset = 0;
+            while (offset < value.length) {
+                if (pending) {
+                    const n = Math.min(need, value.length - offset);
+                    parts.push(value.subarray(offset, offset + n));
+                    offset += n;
+                    need -= n;
+                    if (need === 0) {
+                        await onFrame(pending, parts);
+                        pending = null;
+                        parts = [];
+                    }
+                    continue;
+                }
+                const newline = value.indexOf(10, offset);
+                if (newline < 0) {
+                    line.push(value.subarray(offset));
+                    break;
+                }
+                line.push(value.subarray(offset, newline));
+                offset = newline + 1;
+                const event = parseLine();
+                if (!event) continue;
+                if (event.type === 'audio' && event.bytes > 0) {
+                    pending = event;
+                    need = event.bytes;
+                } else {
+                    await onFrame(event, event.type === 'audio' ? [] : null);
+                }
+            }
+        }
+        if (pending || line.length > 0) {
+            throw new Error('边缘克隆响应被截断');
+        }
+    }
+
+    /**
+     * 通过边缘 Worker 克隆整段音频
+     * @param {Object} options
+     * @param {Blob} options.source - TTS 音频 (WAV)
+     * @param {Blob} options.target - 参考音频
+     * @param {number} options.tau
+     * @param {number} options.segmentDuration - 片段时长 (秒, 页面的分段计划)
+     * @param {number} options.concurrency - 边缘同时发出的片段请求数
+     * @param {Function} [options.onEvent] - (event) plan / segment / audio / result 事件
+     * @param {Function} [options.fetch]
+     * @returns {Promise<{blob: Blob, stats: Object}>} 合并后的 WAV
+     */
+    async function edgeClone(options) {
+        const form = new FormData();
+        form.append('source', options.source, 'source.wav');
+        form.append('target', options.target, 'target.wav');
+        form.append('tau', String(options.tau));
+        form.append('segment_duration', String(options.segmentDuration));
+        form.append('concurrency', String(options.concurrency));
+        form.append('auto_tune', '0');     // 计划由页面决定 (页面的延迟模型有更多观测)
+
+        const fetchImpl = options.fetch || root.fetch;
+        const response = await fetchImpl(options.url || EDGE_CLONE_PATH, { method: 'POST', body: form });
+        if (!response.ok) {
+            let message = `HTTP ${response.status}`;
+            try {
+                message = (await response.json()).error || message;
+            } catch (error) {}
+            throw new Error(`边缘克隆失败: ${message}`);
+        }
+
+        const chunks = [];
+        let result = null;
+        await readFrames(response.body, (event, parts) => {
+            if (event.type === 'error') {
+                throw new Error(event.error || '边缘克隆失败');
+            }
+            if (event.type === 'audio') chunks.push(...parts);
+            if (event.type === 'result') result = event;
+            if (options.onEvent) options.onEvent(event);
+        });
+        if (!result) {
+            throw new Error('边缘克隆响应不完整');
+        }
+
+        // 按实际数据长度改写文件头中的 RIFF / data 长度
+        const data = new Blob(chunks);
+        if (data.size !== WAV_HEADER_BYTES + result.data_bytes) {
+            throw new Error(`边缘克隆结果长度不一致 (${data.size} / ${WAV_HEADER_BYTES + result.data_bytes} 字节)`);
+        }
+        const header = new Uint8Array(await data.slice(0, WAV_HEADER_BYTES).arrayBuffer());
+        const view = new DataView(header.buffer);
+        view.setUint32(4, 36 + result.data_bytes, true);
+        view.setUint32(40, result.data_bytes, true);
+        return {
+            blob: new Blob([header, data.slice(WAV_HEADER_BYTES)], { type: 'audio/wav' }),
+            stats: result.stats || {}
+        };
+    }
+
+    const api = { detectEdgeServices, readFrames, edgeClone, EDGE_CLONE_PATH };
+
+    if (typeof module !== 'undefined' && module.exports) {
+        module.exports = api;
+    } else {
+        Object.assign(root, api);
+    }
+})(typeof window !== 'undefined' ? window : globalThis);
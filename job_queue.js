@@ -0,0 +1,431 @@
+/**
+ * 持久化克隆任务队列 - 长任务 (有声书章节) 的片段计划 / 每个片段的状态 / 完成的结果写入 IndexedDB,
+ * 刷新页面或浏览器崩溃后自动续跑, 只重新请求未完成的片段 (已完成的片段不再消耗克隆服务的 GPU 时间).
+ *
+ * 存储 (数据库 clone-job-queue):
+ *   jobs: 任务记录 { id, name, createdAt, status, tau, plan, duration, segments: [{ duration, status, attempts }] }
+ *         只含元数据 (几 KB), 每个片段完成时与结果在同一事务中更新
+ *   data: 大块数据, 键为 `${jobId}/target`、`${jobId}/source/${i}`、`${jobId}/result/${i}`、`${jobId}/output`
+ *         片段完成后删除其输入; 任务完成后只保留合并结果 (Blob)
+ *
+ * CloneJobRunner 在后台执行队列中的所有任务: 全部任务共用一个并发上限, 按任务轮转取片段 (公平调度),
+ * 新加入的短任务不必等前面的长任务全部完成. 失败的片段重试 MAX_ATTEMPTS 次后标记失败, 合并时跳过.
+ * 队列之外的请求 (批量克隆, 边缘克隆) 通过 schedule() 占用同一并发上限, 与队列任务一起轮转, 合计不超过克隆服务的上限.
+ * 浏览器中挂到 window，Node 中通过 module.exports 导出
+ */
+(function(root) {
+    const JOB_QUEUE_DB = 'clone-job-queue';
+    const JOBS_STORE = 'jobs';
+    const DATA_STORE = 'data';
+    const MAX_ATTEMPTS = 3;
+
+    const dataKey = (jobId, kind, index) => (index === undefined ? `${jobId}/${kind}` : `${jobId}/${kind}/${index}`);
+    // 以 prefix 开头的全部键
+    const prefixRange = prefix => IDBKeyRange.bound(prefix, prefix + '\uffff');
+
+    function requestPromise(request) {
+        return new Promise((resolve, reject) => {
+            request.onsuccess = () => resolve(request.result);
+            request.onerror = () => reject(request.error);
+        });
+    }
+
+    function transactionDone(tx) {
+        return new Promise((resolve, reject) => {
+            tx.oncomplete = resolve;
+            tx.onerror = () => reject(tx.error);
+            tx.onabort = () => reject(tx.error);
+        });
+    }
+
+    class CloneJobQueue {
+        constructor(db) {
+            this.db = db;
+        }
+
+        static supported() {
+            return typeof indexedDB !== 'undefined';
+        }
+
+        static open() {
+            return new Promise((resolve, reject) => {
+                const request = indexedDB.open(JOB_QUEUE_DB, 1);
+                request.onupgradeneeded = () => {
+                    request.result.createObjectStore(JOBS_STORE, { keyPath: 'id' });
+                    request.result.createObjectStore(DATA_STORE);
+                };
+                request.onsuccess = () => resolve(new CloneJobQueue(request.result));
+                request.onerror = () => reject(request.error);
+            });
+        }
+
+        // 在一个事务中执行 fn(jobs, data), 事务提交后返回 fn 的结果
+        async transaction(mode, fn) {
+            const tx = this.db.transaction([JOBS_STORE, DATA_STORE], mode);
+            const result = await fn(tx.objectStore(JOBS_STORE), tx.objectStore(DATA_STORE));
+            await transactionDone(tx);
+            return result;
+        }
+
+        /**
+         * 加入新任务 (输入片段一并写入, 之后不再需要 TTS 和切分)
+         * @param {Object} spec - { name, targetBase64, tau, plan: { segmentDuration, concurrency },
+         *                          segments: [{ index, duration, base64 }] }
+         * @returns {Promise<Object>} 任务记录
+         */
+        async addJob(spec) {
+            const job = {
+                id: `job-${Date.now()}-${Math.random().toString(36).slice(2, 8)}`,
+                name: spec.name,
+                createdAt: Date.now(),
+                status: 'queued',
+                tau: spec.tau,
+                plan: spec.plan,
+                duration: spec.segments.reduce((sum, seg) => sum + seg.duration, 0),
+                segments: spec.segments.map(seg => ({ duration: seg.duration, status: 'pending', attempts: 0 })),
+                error: null
+            };
+            await this.transaction('readwrite', (jobs, data) => {
+                jobs.put(job);
+                data.put(spec.targetBase64, dataKey(job.id, 'target'));
+                spec.segments.forEach(seg => data.put(seg.base64, dataKey(job.id, 'source', seg.index)));
+            });
+            return job;
+        }
+
+        /**
+         * 全部任务 (按加入顺序)
+         */
+        async listJobs() {
+            const jobs = await this.transaction('readonly', jobs => requestPromise(jobs.getAll()));
+            return jobs.sort((a, b) => a.createdAt - b.createdAt);
+        }
+
+        loadData(key) {
+            return this.transaction('readonly', (jobs, data) => requestPromise(data.get(key)));
+        }
+
+        loadTarget(jobId) {
+            return this.loadData(dataKey(jobId, 'target'));
+        }
+
+        loadSource(jobId, index) {
+            return this.loadData(dataKey(jobId, 'source', index));
+        }
+
+        loadOutput(jobId) {
+            return this.loadData(dataKey(jobId, 'output'));
+        }
+
+        /**
+         * 片段完成: 结果与状态在同一事务中写入, 并删除输入
+         */
+        completeSegment(job, index, result) {
+            job.status = 'running';
+            job.segments[index].status = 'done';
+            return this.transaction('readwrite', (jobs, data) => {
+                data.put(result, dataKey(job.id, 'result', index));
+                data.delete(dataKey(job.id, 'source', index));
+                jobs.put(job);
+            });
+        }
+
+        /**
+         * 片段失败: 未达到重试次数时仍为 pending
+         * @returns {Promise<string>} 'pending' (需要重试) 或 'failed'
+         */
+        async failSegment(job, index, message) {
+            const segment = job.segments[index];
+            segment.attempts++;
+            segment.status = segment.attempts >= MAX_ATTEMPTS ? 'failed' : 'pending';
+            segment.error = message;
+            await this.transaction('readwrite', (jobs, data) => {
+                if (segment.status === 'failed') data.delete(dataKey(job.id, 'source', index));
+                jobs.put(job);
+            });
+            return segment.status;
+        }
+
+        /**
+         * 按片段顺序逐个读取结果 (每次只有一个片段在内存中), 失败的片段传入 null
+         * @param {Function} fn - async (result, index)
+         */
+        async forEachResult(job, fn) {
+            for (let i = 0; i < job.segments.length; i++) {
+                const result = job.segments[i].status === 'done'
+                    ? await this.loadData(dataKey(job.id, 'result', i))
+                    : null;
+                await fn(result === undefined ? null : result, i);
+            }
+        }
+
+        /**
+         * 任务完成: 保存合并结果, 删除参考音频和片段结果
+         */
+        finishJob(job, output) {
+            job.status = 'done';
+            job.finishedAt = Date.now();
+            return this.transaction('readwrite', (jobs, data) => {
+                data.delete(prefixRange(`${job.id}/result/`));
+                data.delete(prefixRange(`${job.id}/source/`));
+                data.delete(dataKey(job.id, 'target'));
+                data.put(output, dataKey(job.id, 'output'));
+                jobs.put(job);
+            });
+        }
+
+        failJob(job, message) {
+            job.status = 'failed';
+            job.error = message;
+            return this.transaction('readwrite', jobs => {
+                jobs.put(job);
+            });
+        }
+
+        removeJob(jobId) {
+            return this.transaction('readwrite', (jobs, data) => {
+                jobs.delete(jobId);
+                data.delete(prefixRange(`${jobId}/`));
+            });
+        }
+    }
+
+    /**
+     * 后台执行队列中的任务
+     */
+    class CloneJobRunner {
+        /**
+         * @param {CloneJobQueue} queue
+         * @param {Object} options
+         * @param {number} options.maxConcurrency - 全部任务合计的并发上限 (实际取各任务计划并发数的最大值, 不超过此值)
+         * @param {Function} options.clone - async (job, index, targetBase64, sourceBase64) => 克隆结果 (base64 WAV)
+         * @param {Function} options.finish - async (job) => 合并结果 (Blob), 任务的全部片段结束后调用 (逐个任务执行)
+         * @param {Function} [options.onUpdate] - (job, event), event 为
+         *        { type: 'segment', index, status: 'processing' | 'done' | 'retry' | 'failed', error? } 或
+         *        { type: 'job', status: 'done' | 'failed' | 'cancelled', error? }
+         */
+        constructor(queue, options) {
+            this.queue = queue;
+            this.options = options;
+            this.active = [];           // 有未完成片段的任务: { job, pending, inflight, target, resolve, reject }
+            this.external = [];         // 等待执行的队列外请求: { fn, concurrency, slots, resolve, reject }
+            this.externalPlans = [];    // 等待中和执行中的队列外请求的计划并发数 (参与 limit())
+            this.cursor = 0;            // 轮转位置 (最后一个位置是队列外请求)
+            this.inflight = 0;          // 队列任务与队列外请求合计
+            this.finishing = Promise.resolve();     // 合并逐个进行 (溢出存储同时只能有一个任务)
+            this.completing = new Map();            // 片段已全部结束、等待合并或正在合并的任务: jobId -> entry
+        }
+
+        /**
+         * 恢复未完成的任务 (页面加载时调用), 返回恢复的任务
+         */
+        async resume() {
+            const jobs = await this.queue.listJobs();
+            const unfinished = jobs.filter(job => job.status === 'queued' || job.status === 'running');
+            for (const job of unfinished) {
+                this.add(job).catch(() => {});
+            }
+            return unfinished;
+        }
+
+        /**
+         * 开始执行任务, 返回任务完成时的合并结果
+         */
+        add(job) {
+            const existing = this.active.find(entry => entry.job.id === job.id);
+            if (existing) return existing.promise;
+            const entry = {
+                job,
+                pending: job.segments.map((seg, i) => (seg.status === 'pending' ? i : -1)).filter(i => i >= 0),
+                inflight: 0,
+                target: null,
+                cancelled: false
+            };
+            entry.promise = new Promise((resolve, reject) => {
+                entry.resolve = resolve;
+                entry.reject = reject;
+            });
+            this.active.push(entry);
+            if (entry.pending.length === 0) {
+                this.complete(entry);
+            } else {
+                this.pump();
+            }
+            return entry.promise;
+        }
+
+        /**
+         * 停止任务 (已发出的请求结束后丢弃结果); 等待合并或正在合并的任务不再写回队列,
+         * 调用方随后 removeJob() 删除的记录不会被 finishJob / failJob 重新写入.
+         * 这类任务的 cancelled 事件在合并结束后发出 (合并结果可以在事件中释放)
+         */
+        cancel(jobId) {
+            const entry = this.active.find(item => item.job.id === jobId) || this.completing.get(jobId);
+            if (!entry || entry.cancelled) return;
+            entry.cancelled = true;
+            entry.pending = [];
+            entry.reject(new Error('任务已取消'));
+            if (this.active.includes(entry)) {
+                this.active.splice(this.active.indexOf(entry), 1);
+                this.notify(entry.job, { type: 'job', status: 'cancelled' });
+            }
+        }
+
+        /**
+         * 在共享并发上限内执行队列之外的请求 (不持久化), 没有空位时等待
+         * @param {Function} fn - async () => 结果
+         * @param {number} concurrency - 请求方的计划并发数 (与任务的 plan.concurrency 一样参与 limit())
+         * @param {number} [slots] - fn 占用的后端请求数 (边缘克隆一次请求在后端并发 concurrency 个片段)
+         * @returns {Promise} fn 的结果
+         */
+        schedule(fn, concurrency, slots = 1) {
+            return new Promise((resolve, reject) => {
+                this.external.push({ fn, concurrency, slots, resolve, reject });
+                this.externalPlans.push(concurrency || 1);
+                this.pump();
+            });
+        }
+
+        isActive(jobId) {
+            return this.active.some(entry => entry.job.id === jobId);
+        }
+
+        limit() {
+            const planned = Math.max(1, ...this.active.map(entry => entry.job.plan.concurrency || 1), ...this.externalPlans);
+            return Math.min(this.options.maxConcurrency || planned, planned);
+        }
+
+        notify(job, event) {
+            if (this.options.onUpdate) this.options.onUpdate(job, event);
+        }
+
+        // 公平调度: 从轮转位置开始找下一个有待处理片段的任务, 每个任务每轮取一个片段
+        // 队列外请求作为轮转中的最后一个位置, 每轮取一个; 它需要多个空位而空位不够时停在这里等已发出的请求结束,
+        // 不让队列任务继续占满空位
+        nextTask() {
+            const count = this.active.length + 1;
+            for (let k = 0; k < count; k++) {
+                const slot = (this.cursor + k) % count;
+                if (slot === this.active.length) {
+                    if (this.external.length > 0) {
+                        if (this.inflight + this.slotsOf(this.external[0]) > this.limit()) return null;
+                        this.cursor = (slot + 1) % count;
+                        return { external: this.external.shift() };
+                    }
+                    continue;
+                }
+                const entry = this.active[slot];
+                if (entry.pending.length > 0) {
+                    this.cursor = (slot + 1) % count;
+                    return { entry, index: entry.pending.shift() };
+                }
+            }
+            return null;
+        }
+
+        pump() {
+            while (this.inflight < this.limit()) {
+                const task = this.nextTask();
+                if (!task) break;
+                if (task.external) {
+                    task.external.reserved = this.slotsOf(task.external);
+                    this.inflight += task.external.reserved;
+                    this.runExternal(task.external);
+                    continue;
+                }
+                this.inflight++;
+                task.entry.inflight++;
+                this.runTask(task.entry, task.index).finally(() => {
+                    this.inflight--;
+                    task.entry.inflight--;
+                    if (!task.entry.cancelled && task.entry.pending.length === 0 && task.entry.inflight === 0) {
+                        this.complete(task.entry);
+                    }
+                    this.pump();
+                });
+            }
+        }
+
+        async runTask(entry, index) {
+            const { job } = entry;
+            this.notify(job, { type: 'segment', index, status: 'processing' });
+            try {
+                if (!entry.target) entry.target = this.queue.loadTarget(job.id);
+                const source = await this.queue.loadSource(job.id, index);
+                const result = await this.options.clone(job, index, await entry.target, source);
+                if (entry.cancelled) return;
+                await this.queue.completeSegment(job, index, result);
+                this.notify(job, { type: 'segment', index, status: 'done' });
+            } catch (error) {
+                if (entry.cancelled) return;
+                const status = await this.queue.failSegment(job, index, error.message).catch(() => 'failed');
+                if (status === 'pending') {
+                    entry.pending.push(index);
+                    this.notify(job, { type: 'segment', index, status: 'retry', error });
+                } else {
+                    this.notify(job, { type: 'segment', index, status: 'failed', error });
+                }
+            }
+        }
+
+        // 不超过并发上限, 否则永远等不到足够的空位
+        slotsOf(task) {
+            return Math.max(1, Math.min(task.slots || 1, this.limit()));
+        }
+
+        async runExternal(task) {
+            let settle;
+            try {
+                const result = await task.fn();
+                settle = () => task.resolve(result);
+            } catch (error) {
+                settle = () => task.reject(error);
+            }
+            // 先释放空位再通知调用方: 调用方随即提交的下一个请求可以直接开始
+            this.inflight -= task.reserved;
+            this.externalPlans.splice(this.externalPlans.indexOf(task.concurrency || 1), 1);
+            settle();
+            this.pump();
+        }
+
+        // 合并前和写回前都检查 cancel(): 取消后不再调用 finish / finishJob / failJob
+        // (finishJob 的事务在检查的同一轮中创建, 排在之后 removeJob 的事务之前)
+        complete(entry) {
+            this.active.splice(this.active.indexOf(entry), 1);
+            const { job } = entry;
+            this.completing.set(job.id, entry);
+            this.finishing = this.finishing.then(async () => {
+                try {
+                    if (entry.cancelled) return;
+                    if (!job.segments.some(seg => seg.status === 'done')) {
+                        throw new Error('所有片段处理都失败了');
+                    }
+                    const merged = await this.options.finish(job);
+                    if (entry.cancelled) return;
+                    await this.queue.finishJob(job, merged);
+                    if (entry.cancelled) return;
+                    // 返回 IndexedDB 中的副本: 合并结果可能在溢出存储中, 任务结束后即可清理
+                    const output = await this.queue.loadOutput(job.id);
+                    this.notify(job, { type: 'job', status: 'done' });
+                    entry.resolve(output);
+                } catch (error) {
+                    if (entry.cancelled) return;
+                    await this.queue.failJob(job, error.message).catch(() => {});
+                    this.notify(job, { type: 'job', status: 'failed', error });
+                    entry.reject(error);
+                } finally {
+                    this.completing.delete(job.id);
+                    if (entry.cancelled) this.notify(job, { type: 'job', status: 'cancelled' });
+                }
+            });
+        }
+    }
+
+    const api = { CloneJobQueue, CloneJobRunner, MAX_ATTEMPTS };
+
+    if (typeof module !== 'undefined' && module.exports) {
+        module.exports = api;
+    } else {
+        Object.assign(root, api);
+    }
+})(typeof window !== 'undefined' ? window : globalThis);
@@ -0,0 +1,267 @@
+/**
+ * 运行时路径选择 - 启动时微基准校准 WASM / JS 的交叉点
+ *
+ * 对 WAV 编码、切分 (含逐段编码)、合并分别在几个输入规模上计时两条路径，
+ * 求出 WASM 开始稳定快于 JS 的最小样本数 (交叉点)，按浏览器版本缓存到 localStorage。
+ * 页面中的 audioBufferToWav / splitAudioIntoSegments / mergeAudioSegments 据此按输入规模选路。
+ *
+ * 规模统一用 "样本数" (帧数 x 声道数) 衡量，校准使用单声道输入。
+ */
+(function(root) {
+    const legacy = root.encodeWavLegacy ? root
+        : (typeof require === 'function' ? require('./audio_legacy.js') : {});
+
+    // 结构变化或测量方法变化时递增，使旧缓存失效
+    const CALIBRATION_VERSION = 2;
+    const CALIBRATION_STORAGE_KEY = 'audioPathCalibration';
+
+    // 校准规模: 24kHz 单声道下约 0.1 / 1 / 10 / 60 秒
+    const CALIBRATION_SIZES = [2400, 24000, 240000, 1440000];
+    const CALIBRATION_SAMPLE_RATE = 24000;
+    const CALIBRATION_SEGMENT = 240000;     // 切分 / 合并用的片段长度 (10 秒)
+    const CALIBRATION_MIN_RUNS = 3;
+    const CALIBRATION_BUDGET_MS = 30;       // 每个测量点的时间预算
+
+    const PATH_OPS = ['wav_encode', 'split', 'merge'];
+
+    function now() {
+        return typeof performance !== 'undefined' ? performance.now() : Date.now();
+    }
+
+    // 让出主线程，避免校准阻塞页面交互
+    function yieldToMain() {
+        return new Promise(resolve => setTimeout(resolve, 0));
+    }
+
+    /**
+     * 校准用的 AudioBuffer 替身 (不依赖 AudioContext)
+     */
+    function createPlainBuffer(numberOfChannels, length, sampleRate) {
+        const channels = [];
+        for (let ch = 0; ch < numberOfChannels; ch++) {
+            channels.push(new Float32Array(length));
+        }
+        return { numberOfChannels, length, sampleRate, getChannelData: ch => channels[ch] };
+    }
+
+    // 类语音测试信号 (wasm_generate_speech)；旧版 WASM 未导出时退回正弦
+    function makeSignal(samples, kernels) {
+        const speech = kernels.generateSpeech(
+            { frames: samples, sampleRate: CALIBRATION_SAMPLE_RATE, channels: 1, seed: 1 }, createPlainBuffer);
+        if (speech) return speech;
+
+        const buffer = createPlainBuffer(1, samples, CALIBRATION_SAMPLE_RATE);
+        const data = buffer.getChannelData(0);
+        for (let i = 0; i < samples; i++) {
+            data[i] = 0.5 * Math.sin(2 * Math.PI * 220 * i / CALIBRATION_SAMPLE_RATE);
+        }
+        return buffer;
+    }
+
+    function segmentPlan(samples) {
+        const plan = [];
+        for (let start = 0; start < samples; start += CALIBRATION_SEGMENT) {
+            plan.push({ start, length: Math.min(CALIBRATION_SEGMENT, samples - start) });
+        }
+        return plan;
+    }
+
+    function sliceTyped(input) {
+        return input.plan.map(seg => {
+            const target = createPlainBuffer(1, seg.length, CALIBRATION_SAMPLE_RATE);
+            legacy.copySegmentTyped(input.buffer, target, seg.start);
+            return target;
+        });
+    }
+
+    /**
+     * 各操作的两条路径，与页面实际调用的实现一致 (JS 侧为 TypedArray 版本)
+     * 页面切分后立即逐段编码，split 按 "切分 + 编码" 计时；WASM 支持切片视图时片段不复制
+     */
+    const PATH_IMPLS = {
+        wav_encode: {
+            js: (input) => legacy.encodeWavLegacy(input.buffer),
+            wasm: (kernels, input) => kernels.encodeWav(input.buffer)
+        },
+        split: {
+            js: (input) => sliceTyped(input).map(segment => legacy.encodeWavLegacy(segment)),
+            wasm: (kernels, input) => kernels.supportsViews
+                ? kernels.encodeSegments(input.buffer, input.plan)
+                : kernels.sliceSegments(input.buffer, input.plan, createPlainBuffer).map(segment => kernels.encodeWav(segment))
+        },
+        merge: {
+            js: (input) => {
+                const target = createPlainBuffer(1, input.buffer.length, CALIBRATION_SAMPLE_RATE);
+                legacy.concatSegmentsTyped(input.segments, target);
+                return target;
+            },
+            wasm: (kernels, input) => kernels.concat(input.segments, createPlainBuffer)
+        }
+    };
+
+    /**
+     * 在时间预算内多次运行 fn，取中位数 (毫秒)
+     */
+    function measure(fn) {
+        fn();   // 预热 (JIT / WASM 内存增长)
+        const times = [];
+        const start = now();
+        while (times.length < CALIBRATION_MIN_RUNS || (now() - start < CALIBRATION_BUDGET_MS && times.length < 50)) {
+            const t0 = now();
+            fn();
+            times.push(now() - t0);
+        }
+        times.sort((a, b) => a - b);
+        return times[times.length >> 1];
+    }
+
+    /**
+     * 由测量点求交叉点: WASM 在该规模及以上所有测量点都更快
+     * 在最后一个 JS 更快的点与之后的点之间取几何中点；WASM 从不更快时返回 null
+     */
+    function findCrossover(samples) {
+        let crossover = null;
+        for (let i = samples.length - 1; i >= 0; i--) {
+            if (samples[i].wasmMs >= samples[i].jsMs) break;
+            crossover = i === 0 ? 0 : Math.round(Math.sqrt(samples[i - 1].samples * samples[i].samples));
+        }
+        return crossover;
+    }
+
+    class PathSelector {
+        /**
+         * @param {Object} options
+         * @param {Storage} options.storage - 缓存位置 (默认 localStorage)
+         * @param {string} options.browserKey - 浏览器版本标识 (默认 navigator.userAgent)
+         */
+        constructor(options = {}) {
+            this.storage = options.storage !== undefined ? options.storage
+                : (typeof localStorage !== 'undefined' ? localStorage : null);
+            this.browserKey = options.browserKey
+                || (typeof navigator !== 'undefined' ? navigator.userAgent : 'unknown');
+            this.table = null;          // { op: { crossover, samples: [...] } }
+            this.force = null;          // 'wasm' / 'js' 时忽略交叉点 (调试对比用)
+            this.calibrating = null;    // 进行中的校准 Promise
+        }
+
+        /**
+         * 读取缓存的交叉点表；版本或浏览器不一致时视为无缓存
+         * @returns {boolean} 是否命中缓存
+         */
+        load() {
+            if (!this.storage) return false;
+            try {
+                const cached = JSON.parse(this.storage.getItem(CALIBRATION_STORAGE_KEY));
+                if (cached && cached.version === CALIBRATION_VERSION && cached.browser === this.browserKey) {
+                    this.table = cached.table;
+                    console.log('[路径选择] 使用缓存的校准结果 (' + cached.createdAt + ')');
+                    return true;
+                }
+            } catch (error) {
+                console.warn('[路径选择] 校准缓存无效:', error.message);
+            }
+            return false;
+        }
+
+        save() {
+            if (!this.storage || !this.table) return;
+            try {
+                this.storage.setItem(CALIBRATION_STORAGE_KEY, JSON.stringify({
+                    version: CALIBRATION_VERSION,
+                    browser: this.browserKey,
+                    createdAt: new Date().toISOString(),
+                    table: this.table
+                }));
+            } catch (error) {
+                console.warn('[路径选择] 无法写入校准缓存:', error.message);
+            }
+        }
+
+        /**
+         * 运行微基准并生成交叉点表 (每个测量点之间让出主线程)
+         * @param {WasmAudioKernels} kernels - WASM 内核
+         * @returns {Promise<Object>} 交叉点表
+         */
+        calibrate(kernels) {
+            if (this.calibrating) return this.calibrating;
+            this.calibrating = (async () => {
+                const started = now();
+                const table = {};
+                for (const op of PATH_OPS) {
+                    table[op] = { crossover: null, samples: [] };
+                }
+
+                for (const samples of CALIBRATION_SIZES) {
+                    const buffer = makeSignal(samples, kernels);
+                    const plan = segmentPlan(samples);
+                    const input = { buffer, plan, segments: sliceTyped({ buffer, plan }) };
+
+                    for (const op of PATH_OPS) {
+                        const impl = PATH_IMPLS[op];
+                        const jsMs = measure(() => impl.js(input));
+                        await yieldToMain();
+                        const wasmMs = measure(() => impl.wasm(kernels, input));
+                        await yieldToMain();
+                        table[op].samples.push({ samples, jsMs, wasmMs });
+                    }
+                }
+
+                for (const op of PATH_OPS) {
+                    table[op].crossover = findCrossover(table[op].samples);
+                }
+
+                this.table = table;
+                this.save();
+                console.log(`[路径选择] 校准完成，用时 ${(now() - started).toFixed(0)}ms`);
+                return table;
+            })();
+            this.calibrating.catch(() => {}).then(() => { this.calibrating = null; });
+            return this.calibrating;
+        }
+
+        /**
+         * 按输入规模选择路径
+         * 未校准时沿用原有行为 (优先 WASM)
+         * @param {string} op - 'wav_encode' / 'split' / 'merge'
+         * @param {number} samples - 输入样本数 (帧数 x 声道数)
+         * @returns {string} 'wasm' 或 'js'
+         */
+        choose(op, samples) {
+            if (this.force) return this.force;
+            const entry = this.table && this.table[op];
+            if (!entry) return 'wasm';
+            return entry.crossover !== null && samples >= entry.crossover ? 'wasm' : 'js';
+        }
+
+        /**
+         * 交叉点表的可读形式 (需要时在控制台用 console.table 查看)
+         */
+        describe() {
+            if (!this.table) return [];
+            return PATH_OPS.map(op => {
+                const entry = this.table[op];
+                const row = { op, crossover: entry.crossover === null ? '∞ (始终 JS)' : entry.crossover };
+                for (const s of entry.samples) {
+                    row[s.samples] = `js ${s.jsMs.toFixed(2)} / wasm ${s.wasmMs.toFixed(2)}`;
+                }
+                return row;
+            });
+        }
+
+        /**
+         * 清除缓存并丢弃当前表 (下次启动重新校准)
+         */
+        clear() {
+            this.table = null;
+            if (this.storage) this.storage.removeItem(CALIBRATION_STORAGE_KEY);
+        }
+    }
+
+    const api = { PathSelector, CALIBRATION_VERSION, CALIBRATION_STORAGE_KEY };
+
+    if (typeof module !== 'undefined' && module.exports) {
+        module.exports = api;
+    } else {
+        Object.assign(root, api);
+    }
+})(typeof window !== 'undefined' ? window : globalThis);
@@ -0,0 +1,344 @@
+/**
+ * 性能追踪器 - 阶段级 / 片段级耗时打点
+ * 基于 performance.mark / performance.measure，可导出为 Chrome trace-event JSON
+ * (chrome://tracing 或 https://ui.perfetto.dev 打开)
+ */
+
+// 与 audio_internal.h 中 enum AudioFunc 顺序一致
+const WASM_FUNC_NAMES = [
+    'wasm_audio_buffer_to_wav',
+    'wasm_wav_to_audio_buffer',
+    'wasm_slice_audio',
+    'wasm_merge_audio_buffers',
+    'wasm_resample_audio',
+    'wasm_adjust_volume',
+    'wasm_cross_fade',
+    'wasm_generate_speech',
+    'wasm_gain_to_wav',
+    'wasm_process_to_wav',
+    'wasm_process_audio',
+    'wasm_view_to_wav',
+    'wasm_view_materialize',
+    'wasm_resample_view',
+    'wasm_analyze_audio',
+    'wasm_encode_segments',
+    'wasm_slice_segments',
+    'wasm_convert_samples',
+    'wasm_prepare_reference',
+    'wasm_job_step'
+];
+
+// TraceEvent 结构体: uint32 func_id, uint32 frames, double start_ms, double end_ms
+const WASM_TRACE_EVENT_SIZE = 24;
+const WASM_TRACE_RING_SIZE = 1024;
+
+// AudioStats 结构体 (packed): 4 x uint32 头部 + FuncStats[func_count]
+// FuncStats: uint32 calls, uint32 grow_events, double x 5 (input_frames, output_frames, bytes_in, bytes_out, total_ms)
+const WASM_STATS_HEADER_SIZE = 16;
+const WASM_FUNC_STATS_SIZE = 48;
+
+class PerfTracer {
+    constructor() {
+        this.enabled = typeof performance !== 'undefined' && typeof performance.mark === 'function';
+        this.events = [];
+        this.tracks = new Map(); // 轨道名 -> tid
+        this.nextId = 0;
+        this.jobName = '';
+        this.jobStart = 0;
+        this.wasmStats = null;
+        this.marks = [];            // 本追踪器创建的 mark 名 (name#id:start / name#id:end)
+        this.measures = [];         // 本追踪器创建的 measure 名 (name#id)
+    }
+
+    /**
+     * 开始一次新的任务追踪，清空之前的记录
+     * 只清除本追踪器创建的 mark / measure, 页面其他代码的性能条目不受影响
+     * @param {string} jobName - 任务名称
+     * @param {Object} [module] - Emscripten 模块对象，传入时同时清空 C++ 侧的追踪和统计
+     */
+    reset(jobName = 'job', module = null) {
+        if (this.enabled && performance.clearMarks) {
+            this.marks.forEach(name => performance.clearMarks(name));
+            this.measures.forEach(name => performance.clearMeasures(name));
+        }
+        this.marks = [];
+        this.measures = [];
+        this.events = [];
+        this.tracks = new Map();
+        this.nextId = 0;
+        this.jobName = jobName;
+        this.jobStart = performance.now();
+        this.wasmStats = null;
+
+        if (module) {
+            if (typeof module._wasm_trace_clear === 'function') module._wasm_trace_clear();
+            if (typeof module._wasm_reset_stats === 'function') module._wasm_reset_stats();
+        }
+    }
+
+    /**
+     * 获取轨道对应的线程 ID (Chrome trace 中每条轨道单独一行)
+     */
+    trackId(track) {
+        if (!this.tracks.has(track)) {
+            this.tracks.set(track, this.tracks.size + 1);
+        }
+        return this.tracks.get(track);
+    }
+
+    /**
+     * 开始一个区间
+     * @param {string} name - 区间名 (如 'split', 'segment.request')
+     * @param {Object} [args] - 附加参数，会写入 trace 的 args
+     * @param {string} [track='main'] - 所属轨道
+     * @returns {Object} 区间句柄，传给 end()
+     */
+    begin(name, args = {}, track = 'main') {
+        const span = { id: this.nextId++, name, args, track, start: performance.now() };
+        if (this.enabled) {
+            const startMark = `${name}#${span.id}:start`;
+            performance.mark(startMark);
+            this.marks.push(startMark);
+        }
+        return span;
+    }
+
+    /**
+     * 结束一个区间
+     * @param {Object} span - begin() 返回的句柄
+     * @param {Object} [extraArgs] - 结束时补充的参数 (如输出大小)
+     */
+    end(span, extraArgs) {
+        if (!span || span.ended) return 0;
+        span.ended = true;
+        const endTime = performance.now();
+        const args = extraArgs ? Object.assign({}, span.args, extraArgs) : span.args;
+
+        if (this.enabled) {
+            const endMark = `${span.name}#${span.id}:end`;
+            performance.mark(endMark);
+            const measure = `${span.name}#${span.id}`;
+            this.marks.push(endMark);
+            this.measures.push(measure);
+            try {
+                performance.measure(measure, {
+                    start: `${span.name}#${span.id}:start`,
+                    end: endMark,
+                    detail: args
+                });
+            } catch (e) {
+                // 旧浏览器不支持 measure 的 options 参数
+                performance.measure(measure, `${span.name}#${span.id}:start`, endMark);
+            }
+        }
+
+        this.events.push({
+            name: span.name,
+            track: span.track,
+            start: span.start,
+            dur: endTime - span.start,
+            args
+        });
+        return endTime - span.start;
+    }
+
+    /**
+     * 追踪一个异步操作
+     * @param {string} name - 区间名
+     * @param {Function} fn - 异步函数
+     * @param {Object} [args] - 附加参数
+     * @param {string} [track='main'] - 所属轨道
+     */
+    async span(name, fn, args = {}, track = 'main') {
+        const span = this.begin(name, args, track);
+        try {
+            return await fn();
+        } catch (error) {
+            this.end(span, { error: error && error.message });
+            throw error;
+        } finally {
+            this.end(span);
+        }
+    }
+
+    /**
+     * 追踪一个同步操作
+     */
+    spanSync(name, fn, args = {}, track = 'main') {
+        const span = this.begin(name, args, track);
+        try {
+            return fn();
+        } catch (error) {
+            this.end(span, { error: error && error.message });
+            throw error;
+        } finally {
+            this.end(span);
+        }
+    }
+
+    /**
+     * 记录瞬时事件 (如片段失败、重试)
+     */
+    instant(name, args = {}, track = 'main') {
+        this.events.push({ name, track, start: performance.now(), dur: -1, args });
+    }
+
+    /**
+     * 从 WASM 模块读取 C++ 侧的调用计时 (wasm_trace_*)，合并到 'wasm' 轨道
+     * 模块未编译追踪导出时直接返回 0
+     * @param {Object} module - Emscripten 模块对象
+     * @returns {number} 读取的事件数
+     */
+    collectWasmEvents(module) {
+        if (!module || typeof module._wasm_trace_get_count !== 'function') {
+            return 0;
+        }
+
+        const total = module._wasm_trace_get_count();
+        const count = Math.min(total, WASM_TRACE_RING_SIZE);
+        const base = module._wasm_trace_get_events();
+        const first = total - count;
+
+        for (let i = 0; i < count; i++) {
+            const ptr = base + ((first + i) % WASM_TRACE_RING_SIZE) * WASM_TRACE_EVENT_SIZE;
+            const funcId = module.getValue(ptr, 'i32') >>> 0;
+            const frames = module.getValue(ptr + 4, 'i32') >>> 0;
+            const startMs = module.getValue(ptr + 8, 'double');
+            const endMs = module.getValue(ptr + 16, 'double');
+
+            // 只保留本次任务内的调用
+            if (startMs < this.jobStart) continue;
+
+            this.events.push({
+                name: WASM_FUNC_NAMES[funcId] || `wasm#${funcId}`,
+                track: 'wasm',
+                start: startMs,
+                dur: endMs - startMs,
+                args: { frames }
+            });
+        }
+
+        module._wasm_trace_clear();
+        return count;
+    }
+
+    /**
+     * 读取 C++ 侧的统计计数 (wasm_get_stats)
+     * 模块未以 AUDIO_STATS=1 编译时返回 null
+     * @param {Object} module - Emscripten 模块对象
+     * @returns {Object|null} { growEvents, peakCapacity, funcs: { name: {...} } }
+     */
+    collectWasmStats(module) {
+        if (!module || typeof module._wasm_get_stats !== 'function') {
+            return null;
+        }
+
+        const ptr = module._wasm_get_stats();
+        if (!ptr) return null;
+
+        const u32 = offset => module.getValue(ptr + offset, 'i32') >>> 0;
+        const funcCount = u32(4);
+        const stats = {
+            version: u32(0),
+            growEvents: u32(8),
+            peakCapacity: u32(12),
+            funcs: {}
+        };
+
+        for (let i = 0; i < funcCount; i++) {
+            const base = ptr + WASM_STATS_HEADER_SIZE + i * WASM_FUNC_STATS_SIZE;
+            const calls = module.getValue(base, 'i32') >>> 0;
+            if (calls === 0) continue;
+            stats.funcs[WASM_FUNC_NAMES[i] || `wasm#${i}`] = {
+                calls,
+                growEvents: module.getValue(base + 4, 'i32') >>> 0,
+                inputFrames: module.getValue(base + 8, 'double'),
+                outputFrames: module.getValue(base + 16, 'double'),
+                bytesIn: module.getValue(base + 24, 'double'),
+                bytesOut: module.getValue(base + 32, 'double'),
+                totalMs: module.getValue(base + 40, 'double')
+            };
+        }
+
+        this.wasmStats = stats;
+        return stats;
+    }
+
+    /**
+     * 按区间名汇总耗时
+     * @returns {Object} name -> { count, total, max }
+     */
+    summary() {
+        const result = {};
+        for (const ev of this.events) {
+            if (ev.dur < 0) continue;
+            const item = result[ev.name] || (result[ev.name] = { count: 0, total: 0, max: 0 });
+            item.count++;
+            item.total += ev.dur;
+            item.max = Math.max(item.max, ev.dur);
+        }
+        return result;
+    }
+
+    /**
+     * 转换为 Chrome trace-event 格式 (时间单位: 微秒)
+     */
+    toChromeTrace() {
+        const pid = 1;
+        const traceEvents = [];
+
+        for (const ev of this.events) {
+            const base = {
+                name: ev.name,
+                cat: ev.track === 'wasm' ? 'wasm' : ev.name.split('.')[0],
+                pid,
+                tid: this.trackId(ev.track),
+                ts: Math.round((ev.start - this.jobStart) * 1000),
+                args: ev.args
+            };
+            if (ev.dur < 0) {
+                traceEvents.push(Object.assign(base, { ph: 'i', s: 't' }));
+            } else {
+                traceEvents.push(Object.assign(base, { ph: 'X', dur: Math.max(1, Math.round(ev.dur * 1000)) }));
+            }
+        }
+
+        // 轨道名元数据
+        traceEvents.push({ name: 'process_name', ph: 'M', pid, tid: 0, args: { name: this.jobName } });
+        for (const [track, tid] of this.tracks) {
+            traceEvents.push({ name: 'thread_name', ph: 'M', pid, tid, args: { name: track } });
+            traceEvents.push({ name: 'thread_sort_index', ph: 'M', pid, tid, args: { sort_index: tid } });
+        }
+
+        return {
+            traceEvents,
+            displayTimeUnit: 'ms',
+            metadata: {
+                job: this.jobName,
+                userAgent: typeof navigator !== 'undefined' ? navigator.userAgent : '',
+                exportedAt: new Date().toISOString(),
+                wasmStats: this.wasmStats
+            }
+        };
+    }
+
+    /**
+     * 导出 trace JSON 文件并触发下载
+     */
+    download(filename) {
+        const json = JSON.stringify(this.toChromeTrace());
+        const blob = new Blob([json], { type: 'application/json' });
+        const url = URL.createObjectURL(blob);
+        const link = document.createElement('a');
+        link.href = url;
+        link.download = filename || `trace_${new Date().toISOString().slice(0, 19).replace(/[:-]/g, '')}.json`;
+        document.body.appendChild(link);
+        link.click();
+        document.body.removeChild(link);
+        setTimeout(() => URL.revokeObjectURL(url), 100);
+    }
+}
+
+// 导出为全局对象
+window.PerfTracer = PerfTracer;
+window.perfTrace = new PerfTracer();
@@ -0,0 +1,258 @@
+/**
+ * 分段计划自动调优 - 根据克隆服务的历史延迟选择片段时长与并发数
+ *
+ * 每个片段请求的延迟按 latency = (a + b × duration) × (1 + g × (concurrency - 1)) 建模
+ * (a: 固定开销, b: 每秒音频的处理耗时, g: 同时请求之间的争用)，用最近若干次请求做最小二乘拟合，按后端分别保存在 localStorage。
+ * 流式处理为连续的请求池 (同时至多 concurrency 个请求，一个结束立即发出下一个，与 runPool / runBatchClone 相同)，
+ * 在后端并发上限内枚举片段时长与并发数，选预计总耗时最短的组合。
+ */
+(function(root) {
+    const PLANNER_STORAGE_PREFIX = 'segmentPlanner:';
+    const PLANNER_MAX_OBSERVATIONS = 200;   // 每个后端保留的最近观测数
+    const PLANNER_MIN_OBSERVATIONS = 3;     // 少于此数不拟合，使用手动设置
+    const PLANNER_MAX_CONTENTION = 2;       // 争用系数搜索上限
+
+    /**
+     * 最小二乘拟合 y = a + b × x
+     * x 没有变化时无法区分 a 与 b，按过原点拟合；系数限制为非负
+     * @param {Array<[number, number]>} points - [x, y]
+     */
+    function fitLinear(points) {
+        const n = points.length;
+        let sx = 0, sy = 0, sxx = 0, sxy = 0;
+        for (const [x, y] of points) {
+            sx += x;
+            sy += y;
+            sxx += x * x;
+            sxy += x * y;
+        }
+        const denom = n * sxx - sx * sx;
+        let a, b;
+        if (denom > 1e-9 * n * sxx) {
+            b = (n * sxy - sx * sy) / denom;
+            a = (sy - b * sx) / n;
+        } else {
+            a = 0;
+            b = sxy / sxx;
+        }
+        if (b < 0) {
+            // 延迟不随时长增长: 视为纯固定开销
+            b = 0;
+            a = sy / n;
+        } else if (a < 0) {
+            a = 0;
+            b = sxy / sxx;
+        }
+        return { a, b };
+    }
+
+    class SegmentPlanner {
+        /**
+         * @param {Object} options
+         * @param {Storage} options.storage - 观测数据存储 (默认 localStorage)
+         * @param {number} options.minDuration - 片段时长下限 (秒)
+         * @param {number} options.maxDuration - 片段时长上限 (秒)
+         */
+        constructor(options = {}) {
+            this.storage = options.storage !== undefined ? options.storage
+                : (typeof localStorage !== 'undefined' ? localStorage : null);
+            this.minDuration = options.minDuration || 5;
+            this.maxDuration = options.maxDuration || 30;
+            this.cache = {};    // backend -> 观测数组
+        }
+
+        /**
+         * 读取某个后端的历史观测
+         * @returns {Array<{duration: number, latencyMs: number, concurrency: number, at: number}>}
+         */
+        observations(backend) {
+            if (this.cache[backend]) return this.cache[backend];
+            let list = [];
+            if (this.storage) {
+                try {
+                    list = JSON.parse(this.storage.getItem(PLANNER_STORAGE_PREFIX + backend)) || [];
+                } catch (error) {
+                    console.warn('[分段计划] 历史观测无效，已忽略:', error.message);
+                }
+            }
+            this.cache[backend] = list;
+            return list;
+        }
+
+        /**
+         * 记录一次请求的延迟
+         * @param {string} backend - 后端地址
+         * @param {number} duration - 请求中的音频时长 (秒)
+         * @param {number} latencyMs - 从发出请求到收到完整响应的耗时
+         * @param {number} concurrency - 发出时请求池的并发数
+         */
+        record(backend, duration, latencyMs, concurrency = 1) {
+            if (!(duration > 0) || !(latencyMs > 0)) return;
+            const list = this.observations(backend);
+            list.push({ duration, latencyMs, concurrency, at: Date.now() });
+            if (list.length > PLANNER_MAX_OBSERVATIONS) {
+                list.splice(0, list.length - PLANNER_MAX_OBSERVATIONS);
+            }
+            if (this.storage) {
+                try {
+                    this.storage.setItem(PLANNER_STORAGE_PREFIX + backend, JSON.stringify(list));
+                } catch (error) {
+                    console.warn('[分段计划] 无法保存观测:', error.message);
+                }
+            }
+        }
+
+        /**
+         * 拟合 latency = (a + b × duration) × (1 + g × (concurrency - 1))
+         * g 为并发争用系数 (0: 并发请求互不影响, 1: 后端实际串行处理): 对 g 做黄金分割搜索,
+         * 每个 g 下除去争用后对 a / b 做最小二乘, 取残差平方和最小的组合;
+         * 观测只有一种并发数时无法区分 g 与 a / b, 取 g = 0 (按新计划发出的请求会补上其他并发数的观测)
+         * @returns {{a: number, b: number, g: number, n: number}|null} 观测不足时返回 null
+         */
+        fit(backend) {
+            const list = this.observations(backend);
+            const n = list.length;
+            if (n < PLANNER_MIN_OBSERVATIONS) return null;
+
+            // 没有 concurrency 字段的旧观测按并发 1 处理
+            const extra = list.map(o => Math.max(1, o.concurrency || 1) - 1);
+            const fitAt = g => {
+                const model = fitLinear(list.map((o, i) => [o.duration, o.latencyMs / (1 + g * extra[i])]));
+                model.g = g;
+                model.sse = list.reduce((sum, o, i) => {
+                    const r = o.latencyMs - (model.a + model.b * o.duration) * (1 + g * extra[i]);
+                    return sum + r * r;
+                }, 0);
+                return model;
+            };
+
+            let best = fitAt(0);
+            if (extra.some(e => e !== extra[0])) {
+                let lo = 0, hi = PLANNER_MAX_CONTENTION;
+                const phi = (Math.sqrt(5) - 1) / 2;
+                let m1 = fitAt(hi - phi * (hi - lo)), m2 = fitAt(lo + phi * (hi - lo));
+                while (hi - lo > 1e-4) {
+                    if (m1.sse <= m2.sse) {
+                        hi = m2.g;
+                        m2 = m1;
+                        m1 = fitAt(hi - phi * (hi - lo));
+                    } else {
+                        lo = m1.g;
+                        m1 = m2;
+                        m2 = fitAt(lo + phi * (hi - lo));
+                    }
+                }
+                for (const m of [m1, m2]) {
+                    if (m.sse < best.sse) best = m;
+                }
+            }
+            return { a: best.a, b: best.b, g: best.g, n };
+        }
+
+        /**
+         * 单个片段请求的预计延迟 (同时有 concurrency 个请求时)
+         */
+        latency(model, duration, concurrency) {
+            return (model.a + model.b * duration) * (1 + (model.g || 0) * (concurrency - 1));
+        }
+
+        /**
+         * 预计总耗时: 连续请求池，片段按顺序交给最先空闲的请求位，总耗时为最后一个请求结束的时间
+         * 请求数不足 concurrency 时 (最后几个片段) 仍按 concurrency 计算争用, 略偏保守
+         */
+        estimate(model, audioDuration, segmentDuration, concurrency) {
+            const numSegments = Math.ceil(audioDuration / segmentDuration);
+            const slots = new Array(Math.max(1, Math.min(concurrency, numSegments))).fill(0);   // 各请求位空闲的时刻
+            for (let i = 0; i < numSegments; i++) {
+                const duration = Math.min(segmentDuration, audioDuration - i * segmentDuration);
+                let k = 0;
+                for (let j = 1; j < slots.length; j++) {
+                    if (slots[j] < slots[k]) k = j;
+                }
+                slots[k] += this.latency(model, duration, slots.length);
+            }
+            return Math.max(...slots);
+        }
+
+        /**
+         * 生成分段计划
+         * @param {string} backend - 后端地址
+         * @param {number} audioDuration - 待处理音频时长 (秒)
+         * @param {Object} options
+         * @param {{segmentDuration: number, concurrency: number}} options.manual - 手动设置 (关闭调优或观测不足时使用)
+         * @param {number} options.maxConcurrency - 后端并发上限
+         * @param {boolean} options.autoTune - 是否自动调优
+         * @returns {Object} { segmentDuration, concurrency, numSegments, expectedMs, model, source }
+         */
+        plan(backend, audioDuration, options) {
+            const manual = options.manual;
+            const maxConcurrency = Math.max(1, options.maxConcurrency || manual.concurrency);
+            const model = this.fit(backend);
+
+            let best = {
+                segmentDuration: manual.segmentDuration,
+                concurrency: Math.min(manual.concurrency, maxConcurrency),
+                source: model ? 'manual' : 'manual (观测不足)'
+            };
+
+            if (options.autoTune && model) {
+                let bestMs = Infinity;
+                let bestRequests = Infinity;
+                for (let d = this.minDuration; d <= this.maxDuration; d++) {
+                    const requests = Math.ceil(audioDuration / d);
+                    for (let c = 1; c <= Math.min(maxConcurrency, requests); c++) {
+                        const ms = this.estimate(model, audioDuration, d, c);
+                        // 预计耗时相差 1% 以内时选请求数更少、并发更低的方案
+                        const better = ms < bestMs * 0.99
+                            || (ms <= bestMs * 1.01 && (requests < bestRequests
+                                || (requests === bestRequests && c < best.concurrency)));
+                        if (better) {
+                            bestMs = Math.min(bestMs, ms);
+                            bestRequests = requests;
+                            best = { segmentDuration: d, concurrency: c, source: 'model' };
+                        }
+                    }
+                }
+            }
+
+            best.numSegments = Math.ceil(audioDuration / best.segmentDuration);
+            best.audioDuration = audioDuration;
+            best.model = model;
+            best.expectedMs = model
+                ? this.estimate(model, audioDuration, best.segmentDuration, best.concurrency)
+                : null;
+            return best;
+        }
+
+        /**
+         * 计划的可读描述
+         */
+        describe(plan) {
+            let text = `${plan.numSegments} 段 × ${plan.segmentDuration} 秒，并发 ${plan.concurrency}`;
+            if (plan.expectedMs !== null) {
+                text += `，预计 ${(plan.expectedMs / 1000).toFixed(1)} 秒`;
+            }
+            if (plan.model) {
+                text += ` (模型: (${(plan.model.a / 1000).toFixed(2)}s + ${(plan.model.b / 1000).toFixed(2)}s × 时长)` +
+                    ` × (1 + ${plan.model.g.toFixed(2)} × (并发 - 1)), ${plan.model.n} 个样本)`;
+            }
+            return `${text} [${plan.source}]`;
+        }
+
+        /**
+         * 清除某个后端的观测
+         */
+        clear(backend) {
+            delete this.cache[backend];
+            if (this.storage) this.storage.removeItem(PLANNER_STORAGE_PREFIX + backend);
+        }
+    }
+
+    const api = { SegmentPlanner };
+
+    if (typeof module !== 'undefined' && module.exports) {
+        module.exports = api;
+    } else {
+        Object.assign(root, api);
+    }
+})(typeof window !== 'undefined' ? window : globalThis);
@@ -0,0 +1,223 @@
+// 类语音合成信号发生器实现
+// 每个采样点只用加减乘除 (声门脉冲用多项式近似), 谐振器系数在共振峰变化时按块更新
+
+#include <math.h>
+#include <string.h>
+
+#include "speech_synth.h"
+
+// 元音共振峰 F1/F2/F3 (Hz): a e i o u ə
+static const float kVowels[][SPEECH_SYNTH_FORMANTS] = {
+    {800.0f, 1200.0f, 2500.0f},
+    {500.0f, 1900.0f, 2500.0f},
+    {300.0f, 2300.0f, 3000.0f},
+    {500.0f,  900.0f, 2400.0f},
+    {350.0f,  800.0f, 2300.0f},
+    {500.0f, 1500.0f, 2500.0f},
+};
+static const float kBandwidths[SPEECH_SYNTH_FORMANTS] = {80.0f, 100.0f, 140.0f};
+static const float kFormantAmps[SPEECH_SYNTH_FORMANTS] = {1.0f, -0.5f, 0.25f};
+
+static const uint32_t kCoefBlock = 32;      // 谐振器系数更新间隔 (采样点)
+static const float kOutputGain = 2.2f;     // 使最响的语句峰值约为 0.9
+static const float kNoiseFloor = 0.0005f;   // 停顿中的底噪 (约 -66 dBFS)
+
+// xorshift32
+static inline uint32_t synth_next(SpeechSynth* s) {
+    uint32_t x = s->rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    s->rng = x;
+    return x;
+}
+
+// [0, 1)
+static inline float synth_uniform(SpeechSynth* s) {
+    return (synth_next(s) >> 8) * (1.0f / 16777216.0f);
+}
+
+static inline float synth_range(SpeechSynth* s, float lo, float hi) {
+    return lo + (hi - lo) * synth_uniform(s);
+}
+
+static inline uint32_t synth_ms(SpeechSynth* s, float lo_ms, float hi_ms) {
+    return (uint32_t)(synth_range(s, lo_ms, hi_ms) * 0.001f * s->params.sample_rate);
+}
+
+static void resonator_set(SynthResonator* r, float freq, float bandwidth, uint32_t sample_rate) {
+    // 共振峰不超过奈奎斯特频率的 90%
+    float nyquist = 0.45f * sample_rate;
+    if (freq > nyquist) freq = nyquist;
+    double w = 2.0 * M_PI * freq / sample_rate;
+    double radius = exp(-M_PI * bandwidth / sample_rate);
+    double a1 = -2.0 * radius * cos(w);
+    double a2 = radius * radius;
+    // 归一化为共振频率处增益 1, 不同采样率下电平一致
+    double re = 1.0 + a1 * cos(w) + a2 * cos(2.0 * w);
+    double im = a1 * sin(w) + a2 * sin(2.0 * w);
+    r->a1 = (float)a1;
+    r->a2 = (float)a2;
+    r->gain = (float)sqrt(re * re + im * im);
+}
+
+static inline float resonator_process(SynthResonator* r, float x) {
+    float y = r->gain * x - r->a1 * r->y1 - r->a2 * r->y2;
+    r->y2 = r->y1;
+    r->y1 = y;
+    return y;
+}
+
+// Rosenberg 声门脉冲的多项式近似: 开相 40%, 闭合 16%, 其余为闭相
+static inline float glottal_pulse(float phase) {
+    if (phase < 0.4f) {
+        float x = phase * 2.5f;
+        return x * x * (3.0f - 2.0f * x);
+    }
+    if (phase < 0.56f) {
+        float x = (phase - 0.4f) * 6.25f;
+        return 1.0f - x * x;
+    }
+    return 0.0f;
+}
+
+// 开始下一个单元: 语句之间插入停顿, 语句内部逐个音节
+static void next_unit(SpeechSynth* s) {
+    s->unit_pos = 0;
+
+    if (s->syllables_left == 0 && !s->in_pause && s->position > 0) {
+        s->in_pause = 1;
+        s->unit_length = synth_ms(s, 100.0f, 800.0f);
+        return;
+    }
+
+    if (s->syllables_left == 0) {
+        // 新语句: 音节数、响度 (-18..0 dB)、起始基频
+        s->syllables_left = 3 + synth_next(s) % 13;
+        s->utterance_gain = powf(10.0f, synth_range(s, -18.0f, 0.0f) / 20.0f);
+        s->f0 = s->speaker_f0 * synth_range(s, 0.9f, 1.15f);
+    }
+
+    s->in_pause = 0;
+    s->syllables_left--;
+    s->unit_length = synth_ms(s, 90.0f, 260.0f);
+    s->consonant_length = synth_uniform(s) < 0.6f ? synth_ms(s, 20.0f, 70.0f) : 0;
+    if (s->consonant_length >= s->unit_length) s->consonant_length = s->unit_length / 2;
+
+    const float* vowel = kVowels[synth_next(s) % (sizeof(kVowels) / sizeof(kVowels[0]))];
+    for (int i = 0; i < SPEECH_SYNTH_FORMANTS; i++) {
+        s->formant_target[i] = vowel[i] * synth_range(s, 0.95f, 1.05f);
+    }
+}
+
+void speech_synth_init(SpeechSynth* synth, const SpeechSynthParams* params) {
+    memset(synth, 0, sizeof(*synth));
+    synth->params = *params;
+    if (synth->params.num_channels == 0) synth->params.num_channels = 1;
+    if (synth->params.num_channels > SPEECH_SYNTH_MAX_CHANNELS) synth->params.num_channels = SPEECH_SYNTH_MAX_CHANNELS;
+    synth->rng = params->seed ? params->seed : 0x9E3779B9u;
+
+    // 种子决定说话人基频 (男声 / 女声)
+    synth->speaker_f0 = (synth_next(synth) & 1) ? 115.0f : 205.0f;
+    // 声源增益: 差分换算为每毫秒变化量 (与采样率无关), 高基频的脉冲更陡更密, 按基频归一化
+    synth->source_gain = params->sample_rate * 0.001f * powf(115.0f / synth->speaker_f0, 1.5f);
+    // 基频在约 2 秒内下降 20%
+    synth->f0_decay = powf(0.8f, 1.0f / (2.0f * params->sample_rate));
+
+    for (int i = 0; i < SPEECH_SYNTH_FORMANTS; i++) {
+        synth->formant[i] = kVowels[5][i];
+        synth->formant_target[i] = kVowels[5][i];
+        resonator_set(&synth->resonators[i], synth->formant[i], kBandwidths[i], params->sample_rate);
+    }
+    resonator_set(&synth->fricative, 4500.0f, 2000.0f, params->sample_rate);
+}
+
+// 生成一个单声道采样点
+static inline float synth_sample(SpeechSynth* s, float glide) {
+    if (s->unit_pos >= s->unit_length) next_unit(s);
+    uint32_t pos = s->unit_pos++;
+    float noise = synth_uniform(s) * 2.0f - 1.0f;
+
+    if (s->in_pause) {
+        return noise * kNoiseFloor;
+    }
+
+    // 音节包络: 10ms 起音, 后 30% 线性衰减
+    float attack = 0.01f * s->params.sample_rate;
+    float release_start = 0.7f * s->unit_length;
+    float env = pos < attack ? pos / attack : 1.0f;
+    if (pos > release_start) env *= (s->unit_length - pos) / (s->unit_length - release_start);
+
+    float y;
+    if (pos < s->consonant_length) {
+        // 清辅音: 高频噪声
+        y = resonator_process(&s->fricative, noise) * 0.15f;
+    } else {
+        // 浊音: 声门脉冲 (带抖动) -> 唇辐射 -> 共振峰滤波
+        s->glottal_phase += s->f0 / s->params.sample_rate;
+        if (s->glottal_phase >= 1.0f) {
+            s->glottal_phase -= 1.0f;
+            s->f0 *= 1.0f + (synth_uniform(s) - 0.5f) * 0.02f;
+        }
+        s->f0 *= s->f0_decay;
+        if (s->f0 < 0.6f * s->speaker_f0) s->f0 = 0.6f * s->speaker_f0;
+
+        float g = glottal_pulse(s->glottal_phase);
+        float source = (g - s->prev_glottal) * s->source_gain + noise * 0.02f;
+        s->prev_glottal = g;
+
+        // 共振峰向目标元音滑动, 系数按块更新
+        if ((s->position % kCoefBlock) == 0) {
+            for (int i = 0; i < SPEECH_SYNTH_FORMANTS; i++) {
+                s->formant[i] += (s->formant_target[i] - s->formant[i]) * glide;
+                resonator_set(&s->resonators[i], s->formant[i], kBandwidths[i], s->params.sample_rate);
+            }
+        }
+
+        // 并联共振峰 (符号交替避免共振峰之间出现零点)
+        y = 0.0f;
+        for (int i = 0; i < SPEECH_SYNTH_FORMANTS; i++) {
+            y += kFormantAmps[i] * resonator_process(&s->resonators[i], source);
+        }
+    }
+
+    return y * env * s->utterance_gain * kOutputGain;
+}
+
+void speech_synth_render(SpeechSynth* synth, float* const* channels, uint32_t frames) {
+    const uint16_t num_channels = synth->params.num_channels;
+    const float peak = synth->params.peak > 0.0f ? synth->params.peak : 1.0f;
+    // 共振峰滑动: 每个系数块向目标靠近约 30ms 时间常数
+    const float glide = 1.0f - (float)exp(-(double)kCoefBlock / (0.03 * synth->params.sample_rate));
+
+    for (uint32_t i = 0; i < frames; i++) {
+        float x = synth_sample(synth, glide) * peak;
+        if (x > peak) x = peak;
+        if (x < -peak) x = -peak;
+        synth->position++;
+
+        channels[0][i] = x;
+        if (num_channels > 1) {
+            // 其余声道: 每个声道多延迟 7 个采样点、衰减 2 dB
+            synth->delay[synth->delay_pos] = x;
+            float gain = 1.0f;
+            for (uint16_t ch = 1; ch < num_channels; ch++) {
+                uint32_t d = (synth->delay_pos + SPEECH_SYNTH_DELAY - (ch * 7) % SPEECH_SYNTH_DELAY) % SPEECH_SYNTH_DELAY;
+                gain *= 0.794f;
+                channels[ch][i] = synth->delay[d] * gain;
+            }
+            synth->delay_pos = (synth->delay_pos + 1) % SPEECH_SYNTH_DELAY;
+        }
+    }
+}
+
+void speech_synth_generate(const SpeechSynthParams* params, float* data, uint32_t frames) {
+    SpeechSynth synth;
+    speech_synth_init(&synth, params);
+
+    float* channels[SPEECH_SYNTH_MAX_CHANNELS];
+    for (uint16_t ch = 0; ch < synth.params.num_channels; ch++) {
+        channels[ch] = data + (size_t)ch * frames;
+    }
+    speech_synth_render(&synth, channels, frames);
+}
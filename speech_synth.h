@@ -0,0 +1,70 @@
+// 类语音合成信号发生器 - 基准测试 / 回归测试的确定性输入
+// 声门脉冲串经共振峰滤波器生成元音，噪声段模拟清辅音，音节间有停顿和响度变化
+// 同样的参数 (采样率 / 声道数 / 种子) 在任何平台上生成同样的信号
+
+#ifndef SPEECH_SYNTH_H
+#define SPEECH_SYNTH_H
+
+#include <stdint.h>
+
+// 生成参数
+typedef struct {
+    uint32_t sample_rate;   // 采样率
+    uint16_t num_channels;  // 声道数 (第 2 个起为延迟 + 衰减的副本, 最多 8)
+    uint32_t seed;          // 随机种子
+    float peak;             // 峰值幅度, 大于 1 时会产生需要削波的样本
+} SpeechSynthParams;
+
+// 二阶谐振器 (单个共振峰)
+typedef struct {
+    float a1, a2, gain;
+    float y1, y2;
+} SynthResonator;
+
+#define SPEECH_SYNTH_FORMANTS 3
+#define SPEECH_SYNTH_DELAY 64   // 多声道延迟线长度 (采样点)
+#define SPEECH_SYNTH_MAX_CHANNELS 8
+
+// 发生器状态, 可分块连续渲染任意长度
+typedef struct {
+    SpeechSynthParams params;
+    uint32_t rng;
+
+    // 当前单元 (音节或停顿)
+    uint32_t unit_length;
+    uint32_t unit_pos;
+    int in_pause;
+    uint32_t consonant_length;      // 音节开头的清辅音长度
+
+    // 当前语句
+    uint32_t syllables_left;
+    float utterance_gain;
+    float speaker_f0;
+    float f0;
+    float f0_decay;                 // 每个采样点的基频下降系数 (语调下倾)
+
+    // 声源与滤波器
+    float glottal_phase;            // 0..1
+    float prev_glottal;             // 唇辐射 (一阶差分) 的上一个值
+    float source_gain;
+    float formant[SPEECH_SYNTH_FORMANTS];
+    float formant_target[SPEECH_SYNTH_FORMANTS];
+    SynthResonator resonators[SPEECH_SYNTH_FORMANTS];
+    SynthResonator fricative;
+
+    // 多声道延迟线
+    float delay[SPEECH_SYNTH_DELAY];
+    uint32_t delay_pos;
+
+    uint64_t position;              // 已生成的采样点数
+} SpeechSynth;
+
+void speech_synth_init(SpeechSynth* synth, const SpeechSynthParams* params);
+
+// 渲染 frames 个采样点, channels[ch] 为各声道的输出位置 (平面布局)
+void speech_synth_render(SpeechSynth* synth, float* const* channels, uint32_t frames);
+
+// 便捷函数: 一次生成整段平面布局信号 (data 长度 frames * num_channels)
+void speech_synth_generate(const SpeechSynthParams* params, float* data, uint32_t frames);
+
+#endif // SPEECH_SYNTH_H
@@ -0,0 +1,185 @@
+/**
+ * 溢出存储 - 长任务把完成的片段写入 OPFS (Origin Private File System), 不在内存中累积
+ * 写入由 spill_worker.js 在专用 Worker 中用同步访问句柄完成; 结束后 finish() 返回磁盘上的 File,
+ * 播放和下载时由浏览器从磁盘按需读取, 整个合并结果不会进入 JS 堆或 WASM 内存.
+ * 结果文件在 release() 之前一直保留 (页面播放 / 下载仍引用它), 之后由 cleanup() 删除;
+ * 保留期间持有 Web Lock, 其他标签页的 cleanup() 不会删除本页仍在使用的文件.
+ * 浏览器中挂到 window，Node 中通过 module.exports 导出
+ */
+(function(root) {
+    const SPILL_ROOT = 'spill';
+    const SPILL_LOCK_PREFIX = 'spill:';
+    const retained = new Set();     // 本页未 release() 的任务名
+
+    class SpillStore {
+        constructor(worker, jobId) {
+            this.worker = worker;
+            this.jobId = jobId;
+            this.nextId = 0;
+            this.pending = new Map();   // 消息 id -> { resolve, reject }
+            this.dataBytes = 0;         // 已写入结果文件的音频数据字节数
+            this.spilled = 0;           // 提前到达、暂存在磁盘上的片段数
+            worker.addEventListener('message', event => {
+                const { id, ok, result, error } = event.data;
+                const request = this.pending.get(id);
+                if (!request) return;
+                this.pending.delete(id);
+                if (ok) {
+                    if (result && result.dataBytes !== undefined) {
+                        this.dataBytes = result.dataBytes;
+                        this.spilled = result.spilled;
+                    }
+                    request.resolve(result);
+                } else {
+                    request.reject(new Error(error));
+                }
+            });
+            worker.addEventListener('error', event => {
+                const error = new Error(event.message || '溢出存储 Worker 出错');
+                for (const request of this.pending.values()) request.reject(error);
+                this.pending.clear();
+            });
+        }
+
+        /**
+         * 浏览器是否支持 OPFS (同步访问句柄是否可用要到 Worker 中才能确定, 由 open() 检测)
+         */
+        static supported() {
+            return typeof Worker !== 'undefined' && typeof navigator !== 'undefined'
+                && !!navigator.storage && typeof navigator.storage.getDirectory === 'function';
+        }
+
+        /**
+         * 打开一个新任务
+         * @param {string} [jobId] - 任务名, 默认按时间生成
+         * @param {string} [workerUrl]
+         * @returns {Promise<SpillStore>} 不支持时 reject
+         */
+        static async open(jobId = `job-${Date.now()}-${Math.random().toString(36).slice(2, 8)}`,
+                          workerUrl = 'spill_worker.js') {
+            if (!SpillStore.supported()) {
+                throw new Error('浏览器不支持 OPFS');
+            }
+            const store = new SpillStore(new Worker(workerUrl), jobId);
+            await store.retain();
+            try {
+                await store.call('open', { jobId });
+            } catch (error) {
+                store.worker.terminate();
+                store.release();
+                throw error;
+            }
+            return store;
+        }
+
+        /**
+         * 删除本页和其他标签页都不再引用的任务目录 (页面加载时, 以及结果被新结果替换后调用)
+         * @returns {Promise<number>} 删除的目录数
+         */
+        static async cleanup() {
+            if (!SpillStore.supported()) return 0;
+            let dir;
+            try {
+                dir = await (await navigator.storage.getDirectory()).getDirectoryHandle(SPILL_ROOT);
+            } catch (error) {
+                return 0;   // 还没有溢出过
+            }
+            const keep = new Set(retained);
+            if (navigator.locks) {
+                const { held } = await navigator.locks.query();
+                held.filter(lock => lock.name.startsWith(SPILL_LOCK_PREFIX))
+                    .forEach(lock => keep.add(lock.name.slice(SPILL_LOCK_PREFIX.length)));
+            }
+            const names = [];
+            for await (const name of dir.keys()) names.push(name);
+            let removed = 0;
+            for (const name of names.filter(name => !keep.has(name))) {
+                await dir.removeEntry(name, { recursive: true }).then(() => removed++, () => {});
+            }
+            return removed;
+        }
+
+        // 持有任务的 Web Lock 直到 release() (标签页关闭时浏览器自动释放)
+        async retain() {
+            retained.add(this.jobId);
+            if (!navigator.locks) return;
+            const released = new Promise(resolve => { this.unlock = resolve; });
+            await new Promise(granted => {
+                navigator.locks.request(SPILL_LOCK_PREFIX + this.jobId, () => {
+                    granted();
+                    return released;
+                });
+            });
+        }
+
+        /**
+         * 不再引用结果文件时调用, 之后的 cleanup() 会删除它
+         */
+        release() {
+            retained.delete(this.jobId);
+            if (this.unlock) {
+                this.unlock();
+                this.unlock = null;
+            }
+        }
+
+        call(op, params = {}, transfer = []) {
+            return new Promise((resolve, reject) => {
+                const id = this.nextId++;
+                this.pending.set(id, { resolve, reject });
+                this.worker.postMessage(Object.assign({ id, op }, params), transfer);
+            });
+        }
+
+        /**
+         * 写入一个完成的片段 (WAV), buffer 转移给 Worker, 调用后不可再使用
+         * @param {number} index - 片段序号
+         * @param {ArrayBuffer} buffer - WAV 文件数据
+         */
+        append(index, buffer) {
+            return this.call('append', { index, buffer }, [buffer]);
+        }
+
+        /**
+         * 标记失败的片段 (合并时跳过)
+         */
+        skip(index) {
+            return this.call('skip', { index });
+        }
+
+        /**
+         * 所有片段处理完后调用: 写入 WAV 文件头, 返回磁盘上的结果文件
+         * @param {number} total - 片段总数
+         * @returns {Promise<File>}
+         */
+        async finish(total) {
+            await this.call('finish', { total });
+            this.worker.terminate();
+            const storageRoot = await navigator.storage.getDirectory();
+            const dir = await (await storageRoot.getDirectoryHandle(SPILL_ROOT)).getDirectoryHandle(this.jobId);
+            const file = await (await dir.getFileHandle('result.wav')).getFile();
+            // OPFS 文件没有 MIME 类型, 包一层 Blob 保持 audio/wav (仍引用磁盘上的数据, 不复制)
+            return new File([file], 'result.wav', { type: 'audio/wav' });
+        }
+
+        /**
+         * 放弃任务并删除文件
+         */
+        async abort() {
+            try {
+                await this.call('abort');
+            } finally {
+                this.worker.terminate();
+                this.release();
+            }
+        }
+    }
+
+    const api = { SpillStore };
+
+    if (typeof module !== 'undefined' && module.exports) {
+        module.exports = api;
+    } else {
+        Object.assign(root, api);
+    }
+})(typeof window !== 'undefined' ? window : globalThis);
@@ -0,0 +1,214 @@
+/**
+ * 溢出存储 Worker - 用 OPFS 同步访问句柄把克隆结果直接写到磁盘 (只能在专用 Worker 中使用)
+ *
+ * 同一任务的片段格式一致 (PCM, 声道数 / 采样率 / 位深相同) 时, 合并结果就是文件头 + 各片段 data 块依次相连,
+ * 不需要解码: 按序到达的片段直接追加到 result.wav, 提前到达的片段暂存为 seg-<index>.pcm,
+ * 前面的片段到齐后再搬进 result.wav 并删除. 内存中只有当前处理的一个片段和固定大小的拷贝缓冲区.
+ * 与 spill_store.js 配合使用, 消息格式: { id, op, ... } -> { id, ok, result | error }
+ */
+
+const SPILL_ROOT = 'spill';
+const COPY_CHUNK = 1 << 20;
+const WAV_HEADER_SIZE = 44;
+
+let job = null;
+
+function tag(bytes, offset) {
+    return String.fromCharCode(bytes[offset], bytes[offset + 1], bytes[offset + 2], bytes[offset + 3]);
+}
+
+/**
+ * 找到 fmt / data 块, 返回格式和 data 在 bytes 中的位置
+ */
+function parseWav(buffer) {
+    const bytes = new Uint8Array(buffer);
+    const view = new DataView(buffer);
+    if (bytes.length < 12 || tag(bytes, 0) !== 'RIFF' || tag(bytes, 8) !== 'WAVE') {
+        throw new Error('不是 WAV 文件');
+    }
+    let fmt = null;
+    for (let offset = 12; offset + 8 <= bytes.length;) {
+        const size = view.getUint32(offset + 4, true);
+        if (tag(bytes, offset) === 'fmt ') {
+            fmt = bytes.slice(offset + 8, offset + 24);
+        } else if (tag(bytes, offset) === 'data') {
+            if (!fmt) break;
+            const start = offset + 8;
+            const blockAlign = new DataView(fmt.buffer).getUint16(12, true);
+            let length = Math.min(size, bytes.length - start);
+            length -= length % Math.max(1, blockAlign);
+            return { fmt, data: bytes.subarray(start, start + length) };
+        }
+        offset += 8 + size + (size & 1);
+    }
+    throw new Error('WAV 缺少 fmt 或 data 块');
+}
+
+function sameFormat(a, b) {
+    for (let i = 0; i < a.length; i++) {
+        if (a[i] !== b[i]) return false;
+    }
+    return true;
+}
+
+async function createHandle(dir, name) {
+    const file = await dir.getFileHandle(name, { create: true });
+    return file.createSyncAccessHandle();
+}
+
+// 把暂存片段分块搬进结果文件
+async function appendSpilled(index) {
+    const name = `seg-${index}.pcm`;
+    const handle = await createHandle(job.dir, name);
+    try {
+        const size = handle.getSize();
+        for (let at = 0; at < size; at += COPY_CHUNK) {
+            const chunk = job.copyBuffer.subarray(0, Math.min(COPY_CHUNK, size - at));
+            handle.read(chunk, { at });
+            job.result.write(chunk, { at: WAV_HEADER_SIZE + job.dataBytes });
+            job.dataBytes += chunk.length;
+        }
+    } finally {
+        handle.close();
+    }
+    await job.dir.removeEntry(name);
+    job.spilled.delete(index);
+}
+
+// 依次写入已到齐的片段 (失败的片段跳过)
+async function drain() {
+    while (job.spilled.has(job.next) || job.skipped.has(job.next)) {
+        if (job.spilled.has(job.next)) {
+            await appendSpilled(job.next);
+        }
+        job.next++;
+    }
+}
+
+function writeHeader() {
+    const header = new Uint8Array(WAV_HEADER_SIZE);
+    const view = new DataView(header.buffer);
+    header.set([0x52, 0x49, 0x46, 0x46], 0);                      // RIFF
+    view.setUint32(4, 36 + job.dataBytes, true);
+    header.set([0x57, 0x41, 0x56, 0x45, 0x66, 0x6d, 0x74, 0x20], 8); // WAVEfmt
+    view.setUint32(16, 16, true);
+    header.set(job.fmt, 20);
+    header.set([0x64, 0x61, 0x74, 0x61], 36);                     // data
+    view.setUint32(40, job.dataBytes, true);
+    job.result.write(header, { at: 0 });
+}
+
+const handlers = {
+    /**
+     * 开始新任务 (之前任务留下的文件可能仍被页面引用, 由 SpillStore.cleanup() 在不再引用时删除)
+     */
+    async open({ jobId }) {
+        if (job) await handlers.abort();
+        const storageRoot = await navigator.storage.getDirectory();
+        const root = await storageRoot.getDirectoryHandle(SPILL_ROOT, { create: true });
+        const dir = await root.getDirectoryHandle(jobId, { create: true });
+        const result = await createHandle(dir, 'result.wav');
+        result.truncate(0);
+        job = {
+            jobId, dir, result,
+            fmt: null,
+            next: 0,
+            dataBytes: 0,
+            spilled: new Set(),
+            skipped: new Set(),
+            copyBuffer: new Uint8Array(COPY_CHUNK)
+        };
+        return { path: `${SPILL_ROOT}/${jobId}/result.wav` };
+    },
+
+    /**
+     * 写入一个完成的片段
+     */
+    async append({ index, buffer }) {
+        const { fmt, data } = parseWav(buffer);
+        if (!job.fmt) {
+            job.fmt = fmt;
+        } else if (!sameFormat(job.fmt, fmt)) {
+            throw new Error(`片段 ${index + 1} 的格式与之前的片段不一致`);
+        }
+
+        if (index === job.next) {
+            job.result.write(data, { at: WAV_HEADER_SIZE + job.dataBytes });
+            job.dataBytes += data.length;
+            job.next++;
+            await drain();
+        } else {
+            const handle = await createHandle(job.dir, `seg-${index}.pcm`);
+            try {
+                handle.truncate(0);
+                handle.write(data, { at: 0 });
+            } finally {
+                handle.close();
+            }
+            job.spilled.add(index);
+        }
+        return { dataBytes: job.dataBytes, spilled: job.spilled.size };
+    },
+
+    /**
+     * 标记失败的片段, 合并时跳过
+     */
+    async skip({ index }) {
+        job.skipped.add(index);
+        await drain();
+        return { dataBytes: job.dataBytes, spilled: job.spilled.size };
+    },
+
+    /**
+     * 全部片段结束后写入文件头并关闭, 主线程随后用 getFile() 取得磁盘上的文件
+     */
+    async finish({ total }) {
+        await drain();
+        if (job.next < total) {
+            throw new Error(`片段 ${job.next + 1} 尚未写入`);
+        }
+        if (!job.fmt) {
+            throw new Error('没有成功的片段');
+        }
+        writeHeader();
+        job.result.flush();
+        job.result.close();
+        const result = { jobId: job.jobId, size: WAV_HEADER_SIZE + job.dataBytes };
+        job = null;
+        return result;
+    },
+
+    /**
+     * 放弃任务并删除其文件
+     */
+    async abort() {
+        if (!job) return {};
+        const { jobId, result } = job;
+        job = null;
+        try {
+            result.close();
+        } catch (error) {
+            // 已关闭
+        }
+        const storageRoot = await navigator.storage.getDirectory();
+        const root = await storageRoot.getDirectoryHandle(SPILL_ROOT, { create: true });
+        await root.removeEntry(jobId, { recursive: true }).catch(() => {});
+        return {};
+    }
+};
+
+// 消息按顺序处理: append 之间不能交错
+let queue = Promise.resolve();
+
+self.addEventListener('message', event => {
+    const { id, op } = event.data;
+    queue = queue.then(async () => {
+        try {
+            if (!handlers[op]) throw new Error(`未知操作: ${op}`);
+            if (op !== 'open' && op !== 'abort' && !job) throw new Error('任务未打开');
+            self.postMessage({ id, ok: true, result: await handlers[op](event.data) });
+        } catch (error) {
+            self.postMessage({ id, ok: false, error: error.message });
+        }
+    });
+});
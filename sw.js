@@ -0,0 +1,166 @@
+/**
+ * Service Worker - 页面 / 脚本 / WASM 的版本化离线缓存, 以及 TTS / 克隆结果缓存
+ *
+ * 静态资源: 安装时按 PRECACHE_MANIFEST 预缓存; 请求时缓存优先, 同时在后台重新获取并更新缓存
+ * (stale-while-revalidate), 再次访问时在界面可交互前不需要任何网络往返. 发布时修改 CACHE_VERSION,
+ * 新版本激活后删除旧版本的缓存.
+ * 服务结果: /api/tts 与 /api/clone 的 POST 请求按 URL + 请求体 SHA-256 缓存, 相同输入直接返回上次的结果;
+ * 只缓存成功的结果 (克隆: JSON 中 success 为 true; TTS: 音频响应), 条目 RESULT_CACHE_TTL_MS 后过期,
+ * 超过 RESULT_CACHE_MAX 条时删除最早的条目. 请求头带 X-Cache-Bypass 时跳过缓存.
+ */
+
+const CACHE_VERSION = 'v9';
+const STATIC_CACHE = `static-${CACHE_VERSION}`;
+const RESULT_CACHE = 'api-results-v2';
+const RESULT_CACHE_MAX = 64;
+const RESULT_CACHE_TTL_MS = 7 * 24 * 3600 * 1000;  // 与边缘 TTS 缓存的默认 TTL 相同
+const CACHED_AT_HEADER = 'X-SW-Cached-At';
+
+// 页面启动需要的全部资源 (相对 sw.js 所在目录)
+const PRECACHE_MANIFEST = [
+    './',
+    'index.html',
+    'ivc.html',
+    'audio_processor.js',
+    'audio_processor.wasm',
+    'wasm_module_cache.js',
+    'perf_trace.js',
+    'audio_legacy.js',
+    'wasm_audio.js',
+    'path_calibration.js',
+    'segment_planner.js',
+    'spill_store.js',
+    'spill_worker.js',
+    'voice_reference.js',
+    'batch_clone.js',
+    'job_queue.js',
+    'edge_client.js'
+];
+
+// 第三方资源: 尽量预缓存, 失败不影响安装
+const PRECACHE_OPTIONAL = [
+    'https://cdn.jsdelivr.net/npm/bootstrap@5.3.0/dist/css/bootstrap.min.css',
+    'https://cdn.jsdelivr.net/npm/bootstrap@5.3.0/dist/js/bootstrap.bundle.min.js'
+];
+
+const CACHEABLE_ORIGINS = [self.location.origin, 'https://cdn.jsdelivr.net'];
+const RESULT_PATHS = ['/api/tts', '/api/clone'];
+
+self.addEventListener('install', event => {
+    event.waitUntil((async () => {
+        const cache = await caches.open(STATIC_CACHE);
+        await cache.addAll(PRECACHE_MANIFEST);
+        await Promise.all(PRECACHE_OPTIONAL.map(url => cache.add(url).catch(error => {
+            console.warn('[SW] 预缓存失败:', url, error.message);
+        })));
+        await self.skipWaiting();
+    })());
+});
+
+self.addEventListener('activate', event => {
+    event.waitUntil((async () => {
+        const names = await caches.keys();
+        await Promise.all(names
+            .filter(name => (name.startsWith('static-') && name !== STATIC_CACHE)
+                || (name.startsWith('api-results-') && name !== RESULT_CACHE))
+            .map(name => caches.delete(name)));
+        await self.clients.claim();
+    })());
+});
+
+self.addEventListener('fetch', event => {
+    const request = event.request;
+    const url = new URL(request.url);
+
+    // 范围请求交给服务端 (边缘 TTS 缓存支持 Range), 这里只缓存完整响应
+    if (request.method === 'POST' && RESULT_PATHS.includes(url.pathname)
+        && !request.headers.has('X-Cache-Bypass') && !request.headers.has('Range')) {
+        event.respondWith(cachedResult(request));
+        return;
+    }
+    if (request.method === 'GET' && CACHEABLE_ORIGINS.includes(url.origin) && !url.pathname.startsWith('/api/')) {
+        event.respondWith(staleWhileRevalidate(event, request));
+    }
+});
+
+/**
+ * 缓存优先; 无论是否命中都在后台重新获取, 成功时更新缓存 (下次访问生效)
+ */
+async function staleWhileRevalidate(event, request) {
+    const cache = await caches.open(STATIC_CACHE);
+    // 页面导航忽略查询参数, 避免 ?xxx 导致不命中
+    const cached = await cache.match(request, { ignoreSearch: request.mode === 'navigate' });
+
+    const network = fetch(request).then(response => {
+        if (response.ok) {
+            return cache.put(request, response.clone()).then(() => response);
+        }
+        return response;
+    });
+
+    if (cached) {
+        event.waitUntil(network.catch(() => {}));
+        return cached;
+    }
+    return network;
+}
+
+async function sha256Hex(buffer) {
+    const digest = await crypto.subtle.digest('SHA-256', buffer);
+    return Array.from(new Uint8Array(digest), b => b.toString(16).padStart(2, '0')).join('');
+}
+
+/**
+ * POST 结果缓存: Cache API 只能存 GET, 把请求体哈希放进查询参数构造 GET 请求作为键
+ * (不能用 URL 片段, 缓存匹配时会忽略片段)
+ */
+async function cachedResult(request) {
+    const body = await request.clone().arrayBuffer();
+    const keyUrl = new URL(request.url);
+    keyUrl.searchParams.set('__body', await sha256Hex(body));
+    const key = new Request(keyUrl.href);
+    const cache = await caches.open(RESULT_CACHE);
+
+    const cached = await cache.match(key);
+    if (cached) {
+        const cachedAt = Number(cached.headers.get(CACHED_AT_HEADER)) || 0;
+        if (Date.now() - cachedAt < RESULT_CACHE_TTL_MS) return cached;
+        await cache.delete(key);
+    }
+
+    const response = await fetch(request);
+    if (await isCacheableResult(new URL(request.url).pathname, response)) {
+        // 写入时间放在缓存副本的响应头中, 命中时据此判断是否过期
+        const copy = response.clone();
+        const headers = new Headers(copy.headers);
+        headers.set(CACHED_AT_HEADER, String(Date.now()));
+        await cache.put(key, new Response(copy.body, { status: copy.status, statusText: copy.statusText, headers }));
+        trimCache(cache, RESULT_CACHE_MAX).catch(() => {});
+    }
+    return response;
+}
+
+/**
+ * 只缓存成功的结果: 克隆服务在 HTTP 200 中也会返回 { success: false, error },
+ * 缓存后相同请求 (包括任务队列的重试) 会一直得到这次失败
+ */
+async function isCacheableResult(pathname, response) {
+    if (!response.ok) return false;
+    if (pathname === '/api/tts') {
+        return (response.headers.get('Content-Type') || '').startsWith('audio/');
+    }
+    try {
+        const result = await response.clone().json();
+        return result !== null && result.success === true;
+    } catch (error) {
+        return false;
+    }
+}
+
+// cache.keys() 按写入顺序返回, 删除最早的条目
+async function trimCache(cache, maxEntries) {
+    const keys = await cache.keys();
+    for (let i = 0; i < keys.length - maxEntries; i++) {
+        await cache.delete(keys[i]);
+    }
+}
@@ -0,0 +1,179 @@
+// 任务池实现 (见 task_pool.h)
+
+#include "task_pool.h"
+
+#if AUDIO_THREADS
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct TaskRange {
+    uint32_t begin;
+    uint32_t end;
+};
+
+// 单个线程的任务队列 (任务块粒度较粗, 加锁开销可以忽略)
+struct TaskQueue {
+    std::mutex lock;
+    std::deque<TaskRange> tasks;
+
+    bool pop_back(TaskRange* out) {
+        std::lock_guard<std::mutex> guard(lock);
+        if (tasks.empty()) return false;
+        *out = tasks.back();
+        tasks.pop_back();
+        return true;
+    }
+
+    bool steal_front(TaskRange* out) {
+        std::lock_guard<std::mutex> guard(lock);
+        if (tasks.empty()) return false;
+        *out = tasks.front();
+        tasks.pop_front();
+        return true;
+    }
+};
+
+struct TaskPool {
+    uint32_t threads = 1;                   // 含调用线程
+    std::vector<std::thread> workers;
+    TaskQueue queues[TASK_POOL_MAX_THREADS];  // queues[0] 属于调用线程
+
+    // 当前批次 (在放入任务之前写入, 任务队列的锁保证工作线程看到的是新值)
+    TaskFn fn = nullptr;
+    void* ctx = nullptr;
+    std::atomic<uint32_t> pending{0};       // 尚未完成的任务块数
+
+    std::mutex wake_lock;
+    std::condition_variable wake;
+    uint64_t generation = 0;                // 每个批次递增
+    bool stop = false;
+};
+
+TaskPool g_pool;
+thread_local bool t_in_task = false;
+
+// 先取自己队列中的任务, 再依次窃取其他队列; 没有可做的任务时返回 false
+bool run_one(uint32_t self) {
+    TaskRange range;
+    bool found = g_pool.queues[self].pop_back(&range);
+    for (uint32_t k = 1; !found && k < g_pool.threads; k++) {
+        found = g_pool.queues[(self + k) % g_pool.threads].steal_front(&range);
+    }
+    if (!found) return false;
+
+    t_in_task = true;
+    g_pool.fn(g_pool.ctx, range.begin, range.end);
+    t_in_task = false;
+    g_pool.pending.fetch_sub(1, std::memory_order_acq_rel);
+    return true;
+}
+
+void worker_main(uint32_t self) {
+    uint64_t seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> guard(g_pool.wake_lock);
+            g_pool.wake.wait(guard, [&] { return g_pool.stop || g_pool.generation != seen; });
+            if (g_pool.stop) return;
+            seen = g_pool.generation;
+        }
+        while (run_one(self)) {}
+    }
+}
+
+} // namespace
+
+extern "C" {
+
+void task_pool_shutdown() {
+    {
+        std::lock_guard<std::mutex> guard(g_pool.wake_lock);
+        g_pool.stop = true;
+    }
+    g_pool.wake.notify_all();
+    for (size_t i = 0; i < g_pool.workers.size(); i++) g_pool.workers[i].join();
+    g_pool.workers.clear();
+    g_pool.stop = false;
+    g_pool.threads = 1;
+}
+
+uint32_t task_pool_set_threads(uint32_t threads) {
+    if (threads < 1) threads = 1;
+    if (threads > TASK_POOL_MAX_THREADS) threads = TASK_POOL_MAX_THREADS;
+    if (threads == g_pool.threads) return threads;
+
+    task_pool_shutdown();
+    g_pool.threads = threads;
+    for (uint32_t i = 1; i < threads; i++) {
+        g_pool.workers.push_back(std::thread(worker_main, i));
+    }
+    return threads;
+}
+
+uint32_t task_pool_threads() {
+    return g_pool.threads;
+}
+
+void task_pool_run(uint32_t count, uint32_t grain, TaskFn fn, void* ctx) {
+    if (grain == 0) grain = 1;
+    if (g_pool.threads <= 1 || count <= grain || t_in_task) {
+        if (count > 0) fn(ctx, 0, count);
+        return;
+    }
+
+    uint32_t chunks = (count + grain - 1) / grain;
+    g_pool.fn = fn;
+    g_pool.ctx = ctx;
+    g_pool.pending.store(chunks, std::memory_order_release);
+
+    // 相邻的块轮流分给各线程, 每个队列内仍按顺序排列
+    for (uint32_t c = 0; c < chunks; c++) {
+        TaskRange range = {c * grain, c + 1 == chunks ? count : (c + 1) * grain};
+        TaskQueue& queue = g_pool.queues[c % g_pool.threads];
+        std::lock_guard<std::mutex> guard(queue.lock);
+        queue.tasks.push_back(range);
+    }
+    {
+        std::lock_guard<std::mutex> guard(g_pool.wake_lock);
+        g_pool.generation++;
+    }
+    g_pool.wake.notify_all();
+
+    // 调用线程参与执行, 然后等待被窃取的块完成
+    // (浏览器主线程不能阻塞等待, 这里用让出 CPU 的自旋代替条件变量)
+    while (run_one(0)) {}
+    while (g_pool.pending.load(std::memory_order_acquire) != 0) std::this_thread::yield();
+}
+
+} // extern "C"
+
+#else // !AUDIO_THREADS
+
+extern "C" {
+
+uint32_t task_pool_set_threads(uint32_t threads) {
+    (void)threads;
+    return 1;
+}
+
+uint32_t task_pool_threads() {
+    return 1;
+}
+
+void task_pool_run(uint32_t count, uint32_t grain, TaskFn fn, void* ctx) {
+    (void)grain;
+    if (count > 0) fn(ctx, 0, count);
+}
+
+void task_pool_shutdown() {}
+
+} // extern "C"
+
+#endif // AUDIO_THREADS
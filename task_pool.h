@@ -0,0 +1,44 @@
+// 任务池 - 按段 / 按块并行执行 DSP 内核 (work stealing)
+//
+// 默认的单线程构建 (AUDIO_THREADS=0) 不创建线程, task_pool_run 在调用线程上顺序执行;
+// 多线程构建用 -DAUDIO_THREADS=1 -pthread 编译. WASM 多线程版本依赖 SharedArrayBuffer,
+// 页面需要跨源隔离 (COOP: same-origin, COEP: require-corp) 才能加载, 否则使用单线程版本:
+//   emcc -O3 -pthread -sPTHREAD_POOL_SIZE=8 -sALLOW_MEMORY_GROWTH -DAUDIO_THREADS=1 audio_processor.cpp audio_dsp.cpp audio_speech.cpp speech_synth.cpp task_pool.cpp -sMODULARIZE -sEXPORT_NAME=AudioProcessorWASM_MT -o audio_processor_mt.js
+//
+// 每个线程有自己的任务队列: 自己从尾部取 (后放入的块, 缓存较热), 空闲时从其他线程队列的头部窃取.
+// 调用线程同样参与执行, 全部任务完成后 task_pool_run 才返回. 同一时刻只支持一个调用线程;
+// 在任务内部再调用 task_pool_run 时直接顺序执行.
+
+#ifndef TASK_POOL_H
+#define TASK_POOL_H
+
+#include <stdint.h>
+
+#ifndef AUDIO_THREADS
+#define AUDIO_THREADS 0
+#endif
+
+#define TASK_POOL_MAX_THREADS 8
+
+// 处理 [begin, end) 范围内的工作项
+typedef void (*TaskFn)(void* ctx, uint32_t begin, uint32_t end);
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 设置线程数 (含调用线程, 截断到 1..TASK_POOL_MAX_THREADS), 返回实际线程数; 单线程构建恒为 1
+uint32_t task_pool_set_threads(uint32_t threads);
+uint32_t task_pool_threads();
+
+// 把 [0, count) 按 grain 个一块切分后并行执行 fn; 线程数为 1 或 count <= grain 时直接调用 fn(ctx, 0, count)
+void task_pool_run(uint32_t count, uint32_t grain, TaskFn fn, void* ctx);
+
+// 停止并回收所有工作线程
+void task_pool_shutdown();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TASK_POOL_H
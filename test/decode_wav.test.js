@@ -0,0 +1,109 @@
+/**
+ * WasmAudioKernels.decodeWav 的编码检查 (运行: node --test test/)
+ *
+ * 只支持 16 / 24 位整数 PCM (含子格式为 PCM 的 WAVE_FORMAT_EXTENSIBLE);
+ * IEEE float 与 8 位等其他编码必须抛出错误, 不能返回未初始化的采样
+ */
+
+const { describe, test, before } = require('node:test');
+const assert = require('node:assert');
+const fs = require('fs');
+const path = require('path');
+
+const ROOT = path.join(__dirname, '..');
+const { instantiateFromGlue } = require('../wasm_audio.js');
+
+/**
+ * Node 中的 AudioBuffer 替身 (平面存储)
+ */
+function createTarget(numberOfChannels, length, sampleRate) {
+    const channels = [];
+    for (let ch = 0; ch < numberOfChannels; ch++) channels.push(new Float32Array(length));
+    return { numberOfChannels, length, sampleRate, getChannelData: ch => channels[ch] };
+}
+
+/**
+ * 构造 WAV 文件, fmt 块大小 16 (PCM / float) 或 40 (EXTENSIBLE, subFormat 为子格式)
+ */
+function buildWav({ audioFormat, bitsPerSample, channels = 1, sampleRate = 16000, data, subFormat = 1 }) {
+    const fmtSize = audioFormat === 0xFFFE ? 40 : 16;
+    const bytes = new Uint8Array(12 + 8 + fmtSize + 8 + data.length);
+    const view = new DataView(bytes.buffer);
+    const tag = (offset, text) => { for (let i = 0; i < 4; i++) bytes[offset + i] = text.charCodeAt(i); };
+    const blockAlign = channels * (bitsPerSample >> 3);
+    tag(0, 'RIFF');
+    view.setUint32(4, bytes.length - 8, true);
+    tag(8, 'WAVE');
+    tag(12, 'fmt ');
+    view.setUint32(16, fmtSize, true);
+    view.setUint16(20, audioFormat, true);
+    view.setUint16(22, channels, true);
+    view.setUint32(24, sampleRate, true);
+    view.setUint32(28, sampleRate * blockAlign, true);
+    view.setUint16(32, blockAlign, true);
+    view.setUint16(34, bitsPerSample, true);
+    if (fmtSize === 40) {
+        view.setUint16(36, 22, true);               // cbSize
+        view.setUint16(38, bitsPerSample, true);    // wValidBitsPerSample
+        view.setUint16(44, subFormat, true);        // 子格式 GUID 的前 2 字节
+    }
+    const dataOffset = 20 + fmtSize;
+    tag(dataOffset, 'data');
+    view.setUint32(dataOffset + 4, data.length, true);
+    bytes.set(data, dataOffset + 8);
+    return bytes;
+}
+
+// 正负半轴的缩放 (32768 / 32767) 略有不同, 按 16 位量化精度比较
+function assertSamples(actual, expected) {
+    assert.strictEqual(actual.length, expected.length);
+    expected.forEach((value, i) => assert.ok(Math.abs(actual[i] - value) < 1e-4, `[${i}] ${actual[i]} != ${value}`));
+}
+
+function pcm16(samples) {
+    const data = new Uint8Array(samples.length * 2);
+    const view = new DataView(data.buffer);
+    samples.forEach((s, i) => view.setInt16(i * 2, s, true));
+    return data;
+}
+
+describe('decodeWav', () => {
+    let kernels = null;
+
+    before(async () => {
+        const glue = fs.readFileSync(path.join(ROOT, 'audio_processor.js'), 'utf8');
+        const binary = fs.readFileSync(path.join(ROOT, 'audio_processor.wasm'));
+        kernels = await instantiateFromGlue(glue, binary);
+    });
+
+    test('16 位 PCM 正常解码', () => {
+        const wav = buildWav({ audioFormat: 1, bitsPerSample: 16, channels: 2, data: pcm16([16384, -16384, 0, 32767]) });
+        const buffer = kernels.decodeWav(wav, createTarget);
+        assert.strictEqual(buffer.numberOfChannels, 2);
+        assert.strictEqual(buffer.length, 2);
+        assert.strictEqual(buffer.sampleRate, 16000);
+        assertSamples(buffer.getChannelData(0), [0.5, 0]);
+        assertSamples(buffer.getChannelData(1), [-0.5, 1]);
+    });
+
+    test('子格式为 PCM 的 EXTENSIBLE 按 PCM 解码', () => {
+        const wav = buildWav({ audioFormat: 0xFFFE, bitsPerSample: 16, data: pcm16([8192, -8192]) });
+        const buffer = kernels.decodeWav(wav, createTarget);
+        assertSamples(buffer.getChannelData(0), [0.25, -0.25]);
+    });
+
+    test('32 位 float 抛出错误', () => {
+        const data = new Uint8Array(new Float32Array([0.5, -0.5, 0.25, 0]).buffer);
+        assert.throws(() => kernels.decodeWav(buildWav({ audioFormat: 3, bitsPerSample: 32, data }), createTarget),
+            /不支持的 WAV 编码/);
+        // EXTENSIBLE 包装的 float 同样拒绝
+        assert.throws(() => kernels.decodeWav(buildWav({ audioFormat: 0xFFFE, bitsPerSample: 32, data, subFormat: 3 }), createTarget),
+            /不支持的 WAV 编码/);
+    });
+
+    test('8 位 PCM 抛出错误', () => {
+        const data = new Uint8Array([128, 192, 64, 255]);
+        assert.throws(() => kernels.decodeWav(buildWav({ audioFormat: 1, bitsPerSample: 8, data }), createTarget),
+            /不支持的 WAV 编码/);
+    });
+});
@@ -0,0 +1,114 @@
+/**
+ * 边缘克隆的流式合并 (运行: node --test test/)
+ *
+ * handleEdgeClone (worker/edge_clone.js) 与 edgeClone (edge_client.js) 端到端: 后端用桩代替 (原样返回片段),
+ * 片段乱序完成, 其中一个失败. 合并结果按片段顺序流式写出, 失败片段跳过, 客户端改写文件头长度后得到完整 WAV
+ */
+
+const { describe, test, before } = require('node:test');
+const assert = require('node:assert');
+const fs = require('fs');
+const path = require('path');
+
+const ROOT = path.join(__dirname, '..');
+const { instantiateFromGlue } = require('../wasm_audio.js');
+const { edgeClone, readFrames } = require('../edge_client.js');
+
+const SAMPLE_RATE = 16000;
+
+function createTarget(numberOfChannels, length, sampleRate) {
+    const channels = [];
+    for (let ch = 0; ch < numberOfChannels; ch++) channels.push(new Float32Array(length));
+    return { numberOfChannels, length, sampleRate, duration: length / sampleRate, getChannelData: ch => channels[ch] };
+}
+
+// 按字节逐个分块的流: 事件行与数据在任意位置被切开
+function byteStream(bytes) {
+    let i = 0;
+    return new ReadableStream({
+        pull(controller) {
+            if (i < bytes.length) controller.enqueue(bytes.subarray(i, ++i));
+            else controller.close();
+        }
+    });
+}
+
+describe('边缘克隆', () => {
+    let kernels = null;
+    let handleEdgeClone = null;
+
+    before(async () => {
+        const glue = fs.readFileSync(path.join(ROOT, 'audio_processor.js'), 'utf8');
+        kernels = await instantiateFromGlue(glue, fs.readFileSync(path.join(ROOT, 'audio_processor.wasm')));
+        ({ handleEdgeClone } = await import('../worker/edge_clone.js'));
+    });
+
+    test('按片段顺序流式合并, 跳过失败片段', async () => {
+        // 4.5 秒斜坡信号, 按 1 秒切分为 5 段
+        const source = createTarget(1, SAMPLE_RATE * 4.5, SAMPLE_RATE);
+        source.getChannelData(0).forEach((v, i, data) => { data[i] = ((i % 2000) - 1000) / 2000; });
+        const sourceWav = new Uint8Array(kernels.encodeWav(source));
+
+        // 桩后端: 第 2 个请求 (片段 1) 失败, 第 1 个请求最慢 (片段 0 最后完成)
+        let calls = 0;
+        const backendFetch = async (url, init) => {
+            const call = ++calls;
+            const body = JSON.parse(init.body);
+            await new Promise(resolve => setTimeout(resolve, call === 1 ? 30 : 1));
+            const result = call === 2
+                ? { success: false, error: 'busy' }
+                : { success: true, result_audio: body.source_audio };
+            return new Response(JSON.stringify(result), { headers: { 'Content-Type': 'application/json' } });
+        };
+
+        const events = [];
+        const realFetch = globalThis.fetch;
+        globalThis.fetch = backendFetch;
+        let output;
+        try {
+            output = await edgeClone({
+                source: new Blob([sourceWav]),
+                target: new Blob([new Uint8Array(16)]),
+                tau: 0.3,
+                segmentDuration: 1,
+                concurrency: 2,
+                onEvent: event => events.push(event),
+                fetch: (url, init) => handleEdgeClone(new Request(`http://edge${url}`, init),
+                    { ISV_BACKEND: 'http://backend' }, kernels)
+            });
+        } finally {
+            globalThis.fetch = realFetch;
+        }
+
+        assert.deepStrictEqual(events.filter(e => e.type === 'audio').map(e => e.index), [0, 2, 3, 4]);
+        assert.deepStrictEqual(output.stats, { total_segments: 5, successful_segments: 4, failed_segments: 1, edge: true });
+
+        const merged = kernels.decodeWav(new Uint8Array(await output.blob.arrayBuffer()), createTarget);
+        const input = source.getChannelData(0);
+        const expected = new Float32Array(SAMPLE_RATE * 3.5);
+        expected.set(input.subarray(0, SAMPLE_RATE));
+        expected.set(input.subarray(SAMPLE_RATE * 2), SAMPLE_RATE);
+        assert.strictEqual(merged.length, expected.length);
+        const actual = merged.getChannelData(0);
+        for (let i = 0; i < expected.length; i++) {
+            assert.ok(Math.abs(actual[i] - expected[i]) < 1e-4, `[${i}] ${actual[i]} != ${expected[i]}`);
+        }
+    });
+
+    test('事件行与数据被任意切开时按帧还原', async () => {
+        const encoder = new TextEncoder();
+        const payload = new Uint8Array([1, 2, 10, 3, 10]);
+        const bytes = new Uint8Array([
+            ...encoder.encode('{"type":"plan","segments":1}\n'),
+            ...encoder.encode(`{"type":"audio","index":0,"bytes":${payload.length}}\n`), ...payload,
+            ...encoder.encode('{"type":"result","data_bytes":5}\n')
+        ]);
+        const frames = [];
+        await readFrames(byteStream(bytes), (event, parts) => {
+            frames.push([event.type, parts && Array.from(parts.flatMap(part => Array.from(part)))]);
+        });
+        assert.deepStrictEqual(frames, [['plan', null], ['audio', [1, 2, 10, 3, 10]], ['result', null]]);
+
+        await assert.rejects(readFrames(byteStream(bytes.subarray(0, bytes.length - 30)), () => {}), /截断/);
+    });
+});
@@ -0,0 +1,140 @@
+/**
+ * CloneJobRunner 的共享并发上限 (运行: node --test test/)
+ *
+ * 队列任务与 schedule() 提交的队列外请求 (批量克隆) 合计的同时请求数不能超过 limit(),
+ * 两者按轮转交替取得空位. 队列用内存中的替身代替 IndexedDB
+ */
+
+const { describe, test } = require('node:test');
+const assert = require('node:assert');
+
+const { CloneJobRunner } = require('../job_queue.js');
+
+// CloneJobQueue 的内存替身 (只实现 runner 用到的方法)
+function createQueue() {
+    return {
+        loadTarget: async () => 'target',
+        loadSource: async (jobId, index) => `source ${index}`,
+        loadOutput: async jobId => `output ${jobId}`,
+        completeSegment: async (job, index) => { job.segments[index].status = 'done'; },
+        failSegment: async (job, index) => { job.segments[index].status = 'failed'; return 'failed'; },
+        finishJob: async (job, output) => { job.status = 'done'; job.output = output; },
+        failJob: async job => { job.status = 'failed'; }
+    };
+}
+
+function createJob(id, segments, concurrency) {
+    return {
+        id,
+        name: id,
+        plan: { segmentDuration: 10, concurrency },
+        segments: Array.from({ length: segments }, () => ({ duration: 10, status: 'pending', attempts: 0 }))
+    };
+}
+
+const tick = () => new Promise(resolve => setTimeout(resolve, 1));
+
+describe('CloneJobRunner', () => {
+    test('队列任务与 schedule() 共用并发上限', async () => {
+        let inflight = 0, peak = 0;
+        const order = [];
+        const request = async label => {
+            inflight++;
+            peak = Math.max(peak, inflight);
+            order.push(label);
+            await tick();
+            inflight--;
+            return label;
+        };
+        const runner = new CloneJobRunner(createQueue(), {
+            maxConcurrency: 3,
+            clone: (job, index) => request(`job ${index}`),
+            finish: async job => job.id
+        });
+
+        const job = runner.add(createJob('job', 8, 3));
+        // 批量克隆自己的调度器按计划并发 3 发出请求
+        const external = [];
+        for (let i = 0; i < 8; i++) {
+            external.push(runner.schedule(() => request(`batch ${i}`), 3));
+        }
+
+        assert.strictEqual(await job, 'output job');
+        assert.deepStrictEqual(await Promise.all(external), external.map((p, i) => `batch ${i}`));
+        assert.strictEqual(peak, 3);
+        // 轮转: 队列任务与队列外请求交替取得空位, 一方不会等另一方全部完成
+        assert.ok(order.slice(0, 4).some(label => label.startsWith('batch')));
+        assert.ok(order.slice(0, 4).some(label => label.startsWith('job')));
+        assert.strictEqual(runner.inflight, 0);
+        assert.deepStrictEqual(runner.externalPlans, []);
+    });
+
+    test('schedule() 占用多个空位时等待空位足够, 期间队列任务不再开始', async () => {
+        let inflight = 0, peak = 0;
+        const request = async (slots) => {
+            inflight += slots;
+            peak = Math.max(peak, inflight);
+            await tick();
+            inflight -= slots;
+        };
+        const runner = new CloneJobRunner(createQueue(), {
+            maxConcurrency: 3,
+            clone: () => request(1),
+            finish: async job => job.id
+        });
+        const job = runner.add(createJob('job', 6, 3));
+        // 边缘克隆: 一个请求在后端并发 3 个片段
+        const edge = runner.schedule(() => request(3), 3, 3);
+        await Promise.all([job, edge]);
+        assert.strictEqual(peak, 3);
+        assert.strictEqual(runner.inflight, 0);
+    });
+
+    test('合并期间取消的任务不再写回队列', async () => {
+        const queue = createQueue();
+        const written = [];
+        queue.finishJob = async job => { written.push(['finish', job.id]); };
+        queue.failJob = async job => { written.push(['fail', job.id]); };
+        let releaseMerge;
+        const events = [];
+        const runner = new CloneJobRunner(queue, {
+            maxConcurrency: 2,
+            clone: async () => 'result',
+            finish: () => new Promise(resolve => { releaseMerge = () => resolve('merged'); }),
+            onUpdate: (job, event) => { if (event.type === 'job') events.push(event.status); }
+        });
+
+        const job = runner.add(createJob('job', 2, 2));
+        while (!releaseMerge) await tick();
+        // 片段已全部完成, 任务正在合并 (已不在 active 中)
+        runner.cancel('job');
+        await assert.rejects(job, /任务已取消/);
+        assert.deepStrictEqual(events, []);
+        releaseMerge();
+        await runner.finishing;
+        assert.deepStrictEqual(written, []);
+        assert.deepStrictEqual(events, ['cancelled']);
+        assert.strictEqual(runner.completing.size, 0);
+
+        // 合并失败时同样不写回
+        const failing = new CloneJobRunner(queue, {
+            maxConcurrency: 2,
+            clone: async () => 'result',
+            finish: async () => { failing.cancel('job 2'); throw new Error('合并失败'); }
+        });
+        await assert.rejects(failing.add(createJob('job 2', 1, 1)), /任务已取消/);
+        await failing.finishing;
+        assert.deepStrictEqual(written, []);
+    });
+
+    test('schedule() 的错误传给调用方, 不占用空位', async () => {
+        const runner = new CloneJobRunner(createQueue(), {
+            maxConcurrency: 2,
+            clone: async () => 'result',
+            finish: async job => job.id
+        });
+        await assert.rejects(runner.schedule(async () => { throw new Error('HTTP 503'); }, 2), /HTTP 503/);
+        assert.strictEqual(await runner.schedule(async () => 'ok', 2), 'ok');
+        assert.strictEqual(runner.inflight, 0);
+    });
+});
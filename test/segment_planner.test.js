@@ -0,0 +1,51 @@
+/**
+ * SegmentPlanner 的延迟模型与计划选择 (运行: node --test test/)
+ *
+ * 观测记录发出时的并发数, 拟合出的争用系数让计划不再一律取后端并发上限
+ */
+
+const { describe, test } = require('node:test');
+const assert = require('node:assert');
+
+const { SegmentPlanner } = require('../segment_planner.js');
+
+// 按 (a + b × duration) × (1 + g × (concurrency - 1)) 生成观测
+function observe(planner, { a, b, g }, samples) {
+    for (const [duration, concurrency] of samples) {
+        planner.record('backend', duration, (a + b * duration) * (1 + g * (concurrency - 1)), concurrency);
+    }
+}
+
+const MIXED = [[5, 1], [10, 1], [20, 1], [5, 4], [10, 4], [20, 4], [15, 2]];
+const OPTIONS = { manual: { segmentDuration: 10, concurrency: 2 }, maxConcurrency: 8, autoTune: true };
+
+describe('SegmentPlanner', () => {
+    test('按并发数拟合争用系数', () => {
+        const planner = new SegmentPlanner({ storage: null });
+        observe(planner, { a: 2000, b: 300, g: 0.5 }, MIXED);
+        const model = planner.fit('backend');
+        assert.ok(Math.abs(model.a - 2000) < 1, `a = ${model.a}`);
+        assert.ok(Math.abs(model.b - 300) < 0.1, `b = ${model.b}`);
+        assert.ok(Math.abs(model.g - 0.5) < 1e-3, `g = ${model.g}`);
+    });
+
+    test('后端串行处理时不提高并发', () => {
+        const planner = new SegmentPlanner({ storage: null });
+        observe(planner, { a: 2000, b: 300, g: 1 }, MIXED);
+        const plan = planner.plan('backend', 120, OPTIONS);
+        assert.strictEqual(plan.concurrency, 1);
+    });
+
+    test('并发互不影响时取并发上限', () => {
+        const planner = new SegmentPlanner({ storage: null });
+        observe(planner, { a: 2000, b: 300, g: 0 }, MIXED);
+        const plan = planner.plan('backend', 120, OPTIONS);
+        assert.strictEqual(plan.concurrency, 8);
+    });
+
+    test('只有一种并发数的观测时 g 取 0', () => {
+        const planner = new SegmentPlanner({ storage: null });
+        observe(planner, { a: 2000, b: 300, g: 0.5 }, [[5, 1], [10, 1], [20, 1]]);
+        assert.strictEqual(planner.fit('backend').g, 0);
+    });
+});
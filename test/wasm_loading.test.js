@@ -0,0 +1,83 @@
+/**
+ * WASM 模块加载失败时的回退 (运行: node --test test/)
+ *
+ * 胶水代码按 Emscripten 异步实例化的约定 (MODULARIZE): 工厂 Promise 只在 instantiateWasm 的 receiveInstance 被调用后完成,
+ * .wasm 由本地 HTTP 服务提供. 文件缺失 (404) 或内容损坏时, loadThreadedModule 应返回 null,
+ * 功能模块的 feature() 应抛出错误, 都不能一直等待
+ */
+
+const { describe, test, before, after } = require('node:test');
+const assert = require('node:assert');
+const fs = require('fs');
+const http = require('http');
+const path = require('path');
+
+const ROOT = path.join(__dirname, '..');
+const { WasmAudioKernels, loadThreadedModule, loadFeatureModule } = require('../wasm_audio.js');
+
+// 与异步实例化的 Emscripten 胶水代码相同的工厂: 实例化交给 instantiateWasm, 只在 receiveInstance 时完成
+// (instantiateModule 发现工厂已定义时不再加载脚本)
+const FACTORY = 'TestAudioWASM';
+globalThis[FACTORY] = moduleArg => new Promise(resolve => {
+    const imports = { a: { a: () => 0 } };     // emscripten_resize_heap
+    moduleArg.instantiateWasm(imports, instance => {
+        resolve(Object.assign(moduleArg, { exports: instance.exports }));
+        return instance.exports;
+    });
+});
+
+const WASM_BYTES = fs.readFileSync(path.join(ROOT, 'audio_processor.wasm'));
+const TIMEOUT_MS = 5000;
+
+describe('WASM 模块加载', () => {
+    let server = null;
+    let base = '';
+
+    before(async () => {
+        server = http.createServer((req, res) => {
+            if (req.url === '/audio_processor.wasm') {
+                res.writeHead(200, { 'Content-Type': 'application/wasm' });
+                res.end(WASM_BYTES);
+            } else if (req.url === '/corrupt.wasm') {
+                res.writeHead(200, { 'Content-Type': 'application/wasm' });
+                res.end(WASM_BYTES.subarray(0, 64));
+            } else {
+                res.writeHead(404);
+                res.end();
+            }
+        });
+        await new Promise(resolve => server.listen(0, '127.0.0.1', resolve));
+        base = `http://127.0.0.1:${server.address().port}`;
+    });
+
+    after(() => server.close());
+
+    test('完整部署的模块正常加载', { timeout: TIMEOUT_MS }, async () => {
+        const kernels = await loadFeatureModule({ scriptUrl: 'audio_processor.js', wasmUrl: `${base}/audio_processor.wasm`, factoryName: FACTORY });
+        assert.ok(kernels.memory instanceof WebAssembly.Memory);
+    });
+
+    test('多线程模块的 .wasm 缺失时 loadThreadedModule 返回 null', { timeout: TIMEOUT_MS }, async () => {
+        globalThis.crossOriginIsolated = true;
+        try {
+            const result = await loadThreadedModule({
+                scriptUrl: 'audio_processor.js', wasmUrl: `${base}/missing.wasm`, factoryName: FACTORY, threads: 2
+            });
+            assert.strictEqual(result, null);
+        } finally {
+            delete globalThis.crossOriginIsolated;
+        }
+    });
+
+    for (const [name, file] of [['缺失', 'missing.wasm'], ['损坏', 'corrupt.wasm']]) {
+        test(`功能模块的 .wasm ${name}时 feature() 抛出错误`, { timeout: TIMEOUT_MS }, async () => {
+            // 核心模块没有 _wasm_job_resample_begin, 按 WASM_FEATURES 加载 dsp 功能模块
+            const core = new WasmAudioKernels({}, null, feature => loadFeatureModule(Object.assign({}, feature, {
+                scriptUrl: 'audio_processor.js', wasmUrl: `${base}/${file}`, factoryName: FACTORY
+            })));
+            await assert.rejects(core.feature('_wasm_job_resample_begin'), /实例化失败/);
+            // 失败不缓存, 下次调用重新加载
+            assert.strictEqual(core.features.size, 0);
+        });
+    }
+});
@@ -0,0 +1,394 @@
+/**
+ * 目标音色参考音频预处理 - 上传前在本地解码、下混为单声道、重采样到克隆模型的采样率、
+ * 裁剪首尾静音, 并只保留有声帧 RMS 之和最大的 maxSeconds 秒, 再编码为 16 位 WAV 发送.
+ * 处理在 WASM 中完成 (wasm_prepare_reference, DSP 功能模块); 旧版 WASM 没有该导出时用同样算法的 JS 实现.
+ * 处理结果按 "文件内容 SHA-256 + 参数" 存入 IndexedDB, 同一音色再次克隆时直接复用, 不再解码和处理.
+ * 浏览器中挂到 window，Node 中通过 module.exports 导出
+ */
+(function(root) {
+    const REFERENCE_CACHE_DB = 'voice-reference-cache';
+    const REFERENCE_CACHE_STORE = 'references';
+    const REFERENCE_CACHE_LIMIT = 20;
+    // 处理算法变化时递增 (2: 降采样前低通), 旧结果不再命中, 由数量上限逐步淘汰
+    const REFERENCE_CACHE_VERSION = 2;
+
+    // 克隆模型 (OpenVoice 音色转换器) 以 22.05kHz 单声道提取音色, 几秒到十几秒的干净语音即可
+    const DEFAULT_REFERENCE_OPTIONS = {
+        sampleRate: 22050,
+        maxSeconds: 15,
+        silenceDb: -40
+    };
+
+    // 与 audio_dsp.cpp 一致: 10ms 一帧, 裁剪静音时前后各保留 2 帧
+    const FRAMES_PER_SECOND = 100;
+    const PAD_FRAMES = 2;
+
+    class MonoBuffer {
+        constructor(numberOfChannels, length, sampleRate) {
+            this.numberOfChannels = 1;
+            this.length = length;
+            this.sampleRate = sampleRate;
+            this.data = new Float32Array(length);
+        }
+
+        get duration() {
+            return this.length / this.sampleRate;
+        }
+
+        getChannelData() {
+            return this.data;
+        }
+    }
+
+    const createMonoTarget = (channels, length, sampleRate) => new MonoBuffer(channels, length, sampleRate);
+
+    // 下混为单声道 (各声道平均)
+    function downmix(audioBuffer) {
+        const mono = new Float32Array(audioBuffer.length);
+        mono.set(audioBuffer.getChannelData(0));
+        const channels = audioBuffer.numberOfChannels;
+        for (let ch = 1; ch < channels; ch++) {
+            const src = audioBuffer.getChannelData(ch);
+            for (let i = 0; i < mono.length; i++) mono[i] += src[i];
+        }
+        if (channels > 1) {
+            const scale = Math.fround(1 / channels);
+            for (let i = 0; i < mono.length; i++) mono[i] *= scale;
+        }
+        return mono;
+    }
+
+    // 与 audio_dsp.cpp 一致: 降采样前的抗混叠低通 (Blackman 窗 sinc, 截止频率 0.42 * 目标采样率, 每侧 16 个过零点)
+    const LOWPASS_CUTOFF = 0.42;
+    const LOWPASS_ZEROS = 16;
+    const LOWPASS_MAX_HALF = 512;
+
+    // 对 ratio < 1 的重采样先做低通 (线性插值本身不限制带宽, 目标 Nyquist 以上的成分会折叠回来), 两端以外按 0 处理
+    function lowpassForResample(src, ratio) {
+        const cutoff = LOWPASS_CUTOFF * ratio;
+        const half = Math.min(LOWPASS_MAX_HALF, Math.ceil(LOWPASS_ZEROS / (2 * cutoff)));
+        const taps = new Float32Array(2 * half + 1);
+        let sum = 0;
+        for (let k = 0; k <= 2 * half; k++) {
+            const n = k - half;
+            const x = 2 * Math.PI * cutoff * n;
+            const sinc = n === 0 ? 1 : Math.sin(x) / x;
+            const window = 0.42 + 0.5 * Math.cos(Math.PI * n / half) + 0.08 * Math.cos(2 * Math.PI * n / half);
+            taps[k] = sinc * window;
+            sum += taps[k];
+        }
+        for (let k = 0; k <= 2 * half; k++) taps[k] /= sum;
+
+        const dst = new Float32Array(src.length);
+        for (let i = 0; i < src.length; i++) {
+            const lo = Math.max(0, half - i);
+            const hi = Math.min(2 * half, half + src.length - 1 - i);
+            let acc = 0;
+            for (let k = lo; k <= hi; k++) acc += taps[k] * src[i + k - half];
+            dst[i] = acc;
+        }
+        return dst;
+    }
+
+    // 线性插值重采样 (与 wasm_resample_audio 相同)
+    function resampleLinear(src, ratio) {
+        const length = Math.floor(src.length * ratio);
+        const dst = new Float32Array(length);
+        const last = src.length - 1;
+        for (let i = 0; i < length; i++) {
+            const pos = i / ratio;
+            const idx = Math.floor(pos);
+            const frac = pos - idx;
+            dst[i] = idx >= last ? src[last] : src[idx] * (1 - frac) + src[idx + 1] * frac;
+        }
+        return dst;
+    }
+
+    /**
+     * 选出有效范围: 按帧 RMS 裁掉首尾静音 (低于最响帧 silenceDb), 仍超过 maxSeconds 时
+     * 取有声帧 RMS 之和最大的窗口 (滑动窗口); 全部静音时从头截取
+     * @returns {{start: number, length: number}} 样本范围
+     */
+    function selectReferenceRange(x, sampleRate, maxSeconds, silenceDb) {
+        const frame = Math.max(1, Math.floor(sampleRate / FRAMES_PER_SECOND));
+        const frames = Math.ceil(x.length / frame);
+        let window = maxSeconds > 0 ? Math.floor(maxSeconds * FRAMES_PER_SECOND) : frames;
+        if (window === 0) window = 1;
+
+        const rms = new Float32Array(frames);
+        let peak = 0;
+        for (let f = 0; f < frames; f++) {
+            const begin = f * frame;
+            const n = Math.min(frame, x.length - begin);
+            let sum = 0;
+            for (let i = begin; i < begin + n; i++) sum += x[i] * x[i];
+            rms[f] = Math.sqrt(sum / n);
+            if (rms[f] > peak) peak = rms[f];
+        }
+
+        const threshold = Math.fround(peak * Math.fround(Math.pow(10, silenceDb / 20)));
+        let first = -1, last = -1;
+        for (let f = 0; f < frames; f++) {
+            if (rms[f] > 0 && rms[f] >= threshold) {
+                if (first < 0) first = f;
+                last = f;
+            }
+        }
+        if (first < 0) {
+            first = 0;
+            last = frames - 1;
+        } else {
+            first = Math.max(0, first - PAD_FRAMES);
+            last = Math.min(frames - 1, last + PAD_FRAMES);
+        }
+
+        let best = first;
+        const span = last - first + 1;
+        if (window < span) {
+            // 滑动窗口: 只累计有声帧的 RMS
+            const voiced = f => (rms[f] >= threshold ? rms[f] : 0);
+            let sum = 0, bestSum = -1;
+            for (let f = first; f <= last; f++) {
+                sum += voiced(f);
+                if (f >= first + window) sum -= voiced(f - window);
+                if (f + 1 >= first + window && sum > bestSum) {
+                    bestSum = sum;
+                    best = f + 1 - window;
+                }
+            }
+        } else {
+            window = span;
+        }
+
+        const start = best * frame;
+        return { start, length: Math.min((best + window) * frame, x.length) - start };
+    }
+
+    /**
+     * JS 实现 (与 wasm_prepare_reference 相同的步骤)
+     * @param {AudioBuffer} audioBuffer - 解码后的参考音频
+     * @param {Object} options - { sampleRate, maxSeconds, silenceDb }
+     * @returns {MonoBuffer} 单声道缓冲区
+     */
+    function prepareReferenceJs(audioBuffer, options) {
+        const { sampleRate, maxSeconds = 0, silenceDb = -40 } = options;
+        let mono = downmix(audioBuffer);
+        if (audioBuffer.sampleRate !== sampleRate) {
+            const ratio = sampleRate / audioBuffer.sampleRate;
+            if (ratio < 1) mono = lowpassForResample(mono, ratio);
+            mono = resampleLinear(mono, ratio);
+        }
+        const target = new MonoBuffer(1, 0, sampleRate);
+        if (mono.length === 0) return target;
+        const range = selectReferenceRange(mono, sampleRate, maxSeconds, silenceDb);
+        target.data = mono.slice(range.start, range.start + range.length);
+        target.length = target.data.length;
+        return target;
+    }
+
+    // 单声道 float -> 16 位 PCM WAV (没有 WASM 内核时使用)
+    function encodeMonoWav(buffer) {
+        const samples = buffer.getChannelData(0);
+        const wav = new ArrayBuffer(44 + samples.length * 2);
+        const view = new DataView(wav);
+        const writeTag = (offset, tag) => {
+            for (let i = 0; i < 4; i++) view.setUint8(offset + i, tag.charCodeAt(i));
+        };
+        writeTag(0, 'RIFF');
+        view.setUint32(4, 36 + samples.length * 2, true);
+        writeTag(8, 'WAVE');
+        writeTag(12, 'fmt ');
+        view.setUint32(16, 16, true);
+        view.setUint16(20, 1, true);
+        view.setUint16(22, 1, true);
+        view.setUint32(24, buffer.sampleRate, true);
+        view.setUint32(28, buffer.sampleRate * 2, true);
+        view.setUint16(32, 2, true);
+        view.setUint16(34, 16, true);
+        writeTag(36, 'data');
+        view.setUint32(40, samples.length * 2, true);
+        for (let i = 0; i < samples.length; i++) {
+            const s = Math.max(-1, Math.min(1, samples[i]));
+            view.setInt16(44 + i * 2, s < 0 ? s * 0x8000 : s * 0x7FFF, true);
+        }
+        return wav;
+    }
+
+    // 分块转换, 避免 String.fromCharCode 参数过多; 与 FileReader.readAsDataURL 的结果格式相同
+    function bytesToDataUrl(bytes, type) {
+        const view = bytes instanceof Uint8Array ? bytes : new Uint8Array(bytes);
+        let binary = '';
+        for (let i = 0; i < view.length; i += 0x8000) {
+            binary += String.fromCharCode.apply(null, view.subarray(i, i + 0x8000));
+        }
+        return `data:${type || 'application/octet-stream'};base64,${btoa(binary)}`;
+    }
+
+    async function sha256Hex(bytes) {
+        const digest = await crypto.subtle.digest('SHA-256', bytes);
+        return Array.from(new Uint8Array(digest), b => b.toString(16).padStart(2, '0')).join('');
+    }
+
+    function requestPromise(request) {
+        return new Promise((resolve, reject) => {
+            request.onsuccess = () => resolve(request.result);
+            request.onerror = () => reject(request.error);
+        });
+    }
+
+    function transactionDone(tx) {
+        return new Promise((resolve, reject) => {
+            tx.oncomplete = resolve;
+            tx.onerror = () => reject(tx.error);
+            tx.onabort = () => reject(tx.error);
+        });
+    }
+
+    /**
+     * 每个音色一条记录: { base64, meta: { name, originalBytes, processedBytes, duration, processed, lastUsed } }
+     * 超过 limit 条时删除最久未使用的记录
+     */
+    class VoiceReferenceCache {
+        constructor(limit = REFERENCE_CACHE_LIMIT) {
+            this.limit = limit;
+        }
+
+        static supported() {
+            return typeof indexedDB !== 'undefined';
+        }
+
+        /**
+         * 缓存键: 文件内容哈希 + 处理参数 (参数变化后重新处理)
+         */
+        static async key(bytes, options) {
+            return `v${REFERENCE_CACHE_VERSION}:${await sha256Hex(bytes)}@${options.sampleRate}/${options.maxSeconds}/${options.silenceDb}`;
+        }
+
+        open() {
+            return new Promise((resolve, reject) => {
+                const request = indexedDB.open(REFERENCE_CACHE_DB, 1);
+                request.onupgradeneeded = () => request.result.createObjectStore(REFERENCE_CACHE_STORE);
+                request.onsuccess = () => resolve(request.result);
+                request.onerror = () => reject(request.error);
+            });
+        }
+
+        // 命中时更新 lastUsed
+        async get(key) {
+            const db = await this.open();
+            try {
+                const tx = db.transaction(REFERENCE_CACHE_STORE, 'readwrite');
+                const store = tx.objectStore(REFERENCE_CACHE_STORE);
+                const entry = await requestPromise(store.get(key));
+                if (entry) {
+                    entry.meta.lastUsed = Date.now();
+                    store.put(entry, key);
+                }
+                await transactionDone(tx);
+                return entry || null;
+            } finally {
+                db.close();
+            }
+        }
+
+        async put(key, entry) {
+            const db = await this.open();
+            try {
+                const tx = db.transaction(REFERENCE_CACHE_STORE, 'readwrite');
+                const store = tx.objectStore(REFERENCE_CACHE_STORE);
+                entry.meta.lastUsed = Date.now();
+                store.put(entry, key);
+                const keys = await requestPromise(store.getAllKeys());
+                if (keys.length > this.limit) {
+                    const entries = await requestPromise(store.getAll());
+                    keys.map((k, i) => ({ key: k, lastUsed: entries[i].meta.lastUsed }))
+                        .sort((a, b) => a.lastUsed - b.lastUsed)
+                        .slice(0, keys.length - this.limit)
+                        .forEach(old => store.delete(old.key));
+                }
+                await transactionDone(tx);
+            } finally {
+                db.close();
+            }
+        }
+
+        async clear() {
+            const db = await this.open();
+            try {
+                const tx = db.transaction(REFERENCE_CACHE_STORE, 'readwrite');
+                tx.objectStore(REFERENCE_CACHE_STORE).clear();
+                await transactionDone(tx);
+            } finally {
+                db.close();
+            }
+        }
+    }
+
+    /**
+     * 预处理参考音频并返回要发送的 base64 (data URL)
+     * 处理后的 WAV 反而比原文件大 (如原文件已是很短的压缩音频) 时发送原文件
+     * @param {Blob} file - 用户上传的参考音频
+     * @param {Object} deps - { decode: (ArrayBuffer) => Promise<AudioBuffer>, kernels?, cache? }
+     * @param {Object} [options] - { sampleRate, maxSeconds, silenceDb }, 缺省取 DEFAULT_REFERENCE_OPTIONS
+     * @returns {Promise<{base64, meta, cached: boolean}>}
+     */
+    async function prepareVoiceReference(file, deps, options = {}) {
+        const opts = Object.assign({}, DEFAULT_REFERENCE_OPTIONS, options);
+        const bytes = await file.arrayBuffer();
+        const cache = deps.cache || null;
+        let key = null;
+        if (cache) {
+            try {
+                key = await VoiceReferenceCache.key(bytes, opts);
+                const entry = await cache.get(key);
+                if (entry) return { base64: entry.base64, meta: entry.meta, cached: true };
+            } catch (error) {
+                console.warn('参考音频缓存读取失败:', error);
+            }
+        }
+
+        // decodeAudioData 会转移传入的 ArrayBuffer, 传副本
+        const decoded = await deps.decode(bytes.slice(0));
+        const kernels = deps.kernels || null;
+        let processed = null;
+        if (kernels && typeof kernels.prepareReference === 'function') {
+            processed = kernels.prepareReference(decoded, opts, createMonoTarget);
+        }
+        if (!processed) {
+            processed = prepareReferenceJs(decoded, opts);
+        }
+
+        const wav = kernels ? kernels.encodeWav(processed) : encodeMonoWav(processed);
+        const useProcessed = processed.length > 0 && wav.byteLength < bytes.byteLength;
+        const meta = {
+            name: file.name || '',
+            originalBytes: bytes.byteLength,
+            processedBytes: useProcessed ? wav.byteLength : bytes.byteLength,
+            originalDuration: decoded.duration,
+            duration: useProcessed ? processed.duration : decoded.duration,
+            processed: useProcessed
+        };
+        const base64 = useProcessed
+            ? bytesToDataUrl(new Uint8Array(wav), 'audio/wav')
+            : bytesToDataUrl(new Uint8Array(bytes), file.type);
+
+        if (cache && key) {
+            await cache.put(key, { base64, meta }).catch(error => console.warn('参考音频缓存写入失败:', error));
+        }
+        return { base64, meta, cached: false };
+    }
+
+    const api = {
+        DEFAULT_REFERENCE_OPTIONS,
+        VoiceReferenceCache,
+        prepareReferenceJs,
+        prepareVoiceReference,
+        encodeMonoWav
+    };
+
+    if (typeof module !== 'undefined' && module.exports) {
+        module.exports = api;
+    } else {
+        Object.assign(root, api);
+    }
+})(typeof window !== 'undefined' ? window : globalThis);
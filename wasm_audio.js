@@ -0,0 +1,1195 @@
+/**
+ * WASM 音频内核 - 在 WASM 线性内存中执行 WAV 编码 / 切片 / 合并
+ * 负责把 AudioBuffer 数据拷入 g_memory_buffer、调用 wasm_* 导出函数并把结果拷出
+ * 切分后立即编码的场景用 encodeSegments: 片段以视图形式引用源数据, 只拷出最终的 WAV
+ * 跨源隔离的页面可用 loadThreadedModule 加载多线程版本 (合并 / 编码 / 重采样 / 电平分析在 C++ 侧并行)
+ * 等待合并 / 播放的片段可以用 compact() 压缩为 CompactAudioBuffer (int16 / float16), 内存减半,
+ * 合并和编码直接读取紧凑数据, 只在处理或播放时展开为 float
+ * 只加载核心模块时, 重采样 / 电平分析等导出由 feature() 在首次使用时加载对应的功能模块 (WASM_FEATURES)
+ * 长输入的合并 / 重采样用 concatSliced / resampleSliced 分步执行 (wasm_job_*), 每个时间片之后让出主线程
+ * 浏览器中挂到 window，Node 中通过 module.exports 导出 (bench/bench_node.js, worker/edge_clone.js 使用)
+ *
+ * 输入均为 AudioBuffer 兼容对象: { numberOfChannels, length, sampleRate, getChannelData(ch) }
+ */
+(function(root) {
+    // wasm32 下 AudioBuffer 结构体: float* data, uint32 length, uint16 num_channels, uint16 layout, uint32 sample_rate
+    // (旧版 WASM 中 layout 位置是填充, 忽略该字段, 只支持平面布局)
+    const AUDIO_BUFFER_STRUCT_SIZE = 16;
+    // wasm32 下 AudioView 结构体: const float* base, uint32 offset, uint32 length, uint16 num_channels, uint16 layout,
+    // uint32 sample_rate, uint32 channel_stride, uint32 frame_stride
+    const AUDIO_VIEW_STRUCT_SIZE = 28;
+    // 与 audio_processor.h 中的 AUDIO_LAYOUT_* 一致
+    const AUDIO_LAYOUT_PLANAR = 0;
+    const AUDIO_LAYOUT_INTERLEAVED = 1;
+    // 与 audio_processor.h 中的 AUDIO_SAMPLE_* 一致 (存放在 layout 的高 8 位)
+    const AUDIO_SAMPLE_F32 = 0;
+    const AUDIO_SAMPLE_S16 = 1;
+    const AUDIO_SAMPLE_F16 = 2;
+    const AUDIO_FORMAT_SHIFT = 8;
+    // 批量导出的片段描述符 AudioSegment { uint32 start, uint32 length }
+    // 与输出位置 SegmentResult { uint32 offset, uint32 size, uint32 frames }
+    const AUDIO_SEGMENT_STRUCT_SIZE = 8;
+    // WAV fmt 块的 audio_format
+    const WAVE_FORMAT_PCM = 1;
+    const WAVE_FORMAT_EXTENSIBLE = 0xFFFE;
+    const SEGMENT_RESULT_STRUCT_SIZE = 12;
+
+    // 功能模块 (构建配置见 audio_processor.cpp 开头): 核心模块没有的导出按所属功能首次使用时加载
+    // 每个功能模块是独立实例, 自带核心导出, 直接用一个新的 WasmAudioKernels 包装
+    const WASM_FEATURES = {
+        dsp: {
+            scriptUrl: 'audio_dsp.js',
+            wasmUrl: 'audio_dsp.wasm',
+            factoryName: 'AudioDspWASM',
+            exports: ['_wasm_resample_audio', '_wasm_resample_view', '_wasm_adjust_volume', '_wasm_cross_fade',
+                '_wasm_gain_to_wav', '_wasm_process_to_wav', '_wasm_process_audio', '_wasm_analyze_audio',
+                '_wasm_prepare_reference', '_wasm_job_resample_begin']
+        },
+        speech: {
+            scriptUrl: 'audio_speech.js',
+            wasmUrl: 'audio_speech.wasm',
+            factoryName: 'AudioSpeechWASM',
+            exports: ['_wasm_generate_speech']
+        }
+    };
+
+    function featureOf(exportName) {
+        return Object.keys(WASM_FEATURES).find(name => WASM_FEATURES[name].exports.includes(exportName)) || null;
+    }
+
+    function align(bytes) {
+        return (bytes + 15) & ~15;
+    }
+
+    function now() {
+        return typeof performance !== 'undefined' ? performance.now() : Date.now();
+    }
+
+    // 分步执行 (wasm_job_*) 每个时间片的默认预算: 约半个 60Hz 帧, 其余时间留给渲染和输入事件
+    const JOB_SLICE_MS = 8;
+
+    // 让出主线程: 优先 scheduler.yield (继续执行时排在其他任务之前), 否则 setTimeout
+    function yieldToMain() {
+        if (typeof scheduler !== 'undefined' && typeof scheduler.yield === 'function') {
+            return scheduler.yield();
+        }
+        return new Promise(resolve => setTimeout(resolve, 0));
+    }
+
+    // 时间片: tick() 在本片用时达到 sliceMs 后让出主线程, yield() 无条件让出
+    class TimeSlicer {
+        constructor(sliceMs = JOB_SLICE_MS) {
+            this.sliceMs = sliceMs;
+            this.start = now();
+        }
+
+        // 本片剩余的毫秒数
+        remaining() {
+            return this.sliceMs - (now() - this.start);
+        }
+
+        async tick() {
+            if (this.remaining() <= 0) await this.yield();
+        }
+
+        async yield() {
+            await yieldToMain();
+            this.start = now();
+        }
+    }
+
+    function sampleBytes(format) {
+        return format === AUDIO_SAMPLE_F32 ? 4 : 2;
+    }
+
+    // float16 转换用的共享暂存区
+    const f32Scratch = new Float32Array(1);
+    const u32Scratch = new Uint32Array(f32Scratch.buffer);
+
+    // float -> float16 位模式, 就近舍入到偶数 (与 audio_samples.h 中的 audio_float_to_f16 一致)
+    function floatToF16(value) {
+        f32Scratch[0] = value;
+        const bits = u32Scratch[0];
+        const sign = (bits >>> 16) & 0x8000;
+        const abs = bits & 0x7FFFFFFF;
+        if (abs >= 0x7F800000) return sign | 0x7C00 | (abs > 0x7F800000 ? 0x200 : 0);
+        if (abs >= 0x477FF000) return sign | 0x7C00;
+        if (abs < 0x38800000) {
+            const scaled = Math.abs(Math.fround(value)) * 16777216;
+            // 就近舍入到偶数
+            let rounded = Math.round(scaled);
+            if (rounded - scaled === 0.5 && (rounded & 1)) rounded--;
+            return sign | rounded;
+        }
+        let h = (abs - 0x38000000) >>> 13;
+        const rest = abs & 0x1FFF;
+        if (rest > 0x1000 || (rest === 0x1000 && (h & 1))) h++;
+        return sign | h;
+    }
+
+    function f16ToFloat(h) {
+        const exp = (h >> 10) & 0x1F;
+        const mant = h & 0x3FF;
+        let value;
+        if (exp === 0) value = mant * 5.960464477539063e-8;            // 2^-24
+        else if (exp === 31) value = mant ? NaN : Infinity;
+        else value = (1 + mant / 1024) * Math.pow(2, exp - 15);
+        return h & 0x8000 ? -value : value;
+    }
+
+    // float -> 紧凑格式 (int16 的量化与 16 位 WAV 相同)
+    function narrowSamples(input, format) {
+        const n = input.length;
+        if (format === AUDIO_SAMPLE_S16) {
+            const out = new Int16Array(n);
+            for (let i = 0; i < n; i++) {
+                // 按 float 精度相乘后截断, 与 C++ 侧逐位一致
+                const x = Math.max(-1, Math.min(1, input[i]));
+                out[i] = Math.fround(x < 0 ? x * 0x8000 : x * 0x7FFF);
+            }
+            return out;
+        }
+        const out = new Uint16Array(n);
+        for (let i = 0; i < n; i++) out[i] = floatToF16(input[i]);
+        return out;
+    }
+
+    function widenSamples(input, format, out = new Float32Array(input.length)) {
+        const n = input.length;
+        if (format === AUDIO_SAMPLE_S16) {
+            for (let i = 0; i < n; i++) out[i] = input[i] / (input[i] < 0 ? 0x8000 : 0x7FFF);
+        } else {
+            for (let i = 0; i < n; i++) out[i] = f16ToFloat(input[i]);
+        }
+        return out;
+    }
+
+    /**
+     * 紧凑存放的音频 (平面布局, 每个声道一个 Int16Array / Uint16Array), 用于长时间驻留的片段
+     * 与 AudioBuffer 接口兼容: getChannelData 每次展开一份新的 float 副本 (用完即可回收),
+     * 传给 WasmAudioKernels 时直接上传紧凑数据, 由 WASM 内核按块展开
+     */
+    class CompactAudioBuffer {
+        constructor(numberOfChannels, length, sampleRate, format = AUDIO_SAMPLE_S16) {
+            if (format !== AUDIO_SAMPLE_S16 && format !== AUDIO_SAMPLE_F16) {
+                throw new Error(`不支持的样本格式: ${format}`);
+            }
+            this.numberOfChannels = numberOfChannels;
+            this.length = length;
+            this.sampleRate = sampleRate;
+            this.format = format;
+            this.channels = [];
+            for (let ch = 0; ch < numberOfChannels; ch++) {
+                this.channels.push(format === AUDIO_SAMPLE_S16 ? new Int16Array(length) : new Uint16Array(length));
+            }
+        }
+
+        /**
+         * 在 JS 中压缩 (没有 WASM 时使用; 有 WASM 时用 WasmAudioKernels.compact)
+         */
+        static from(audioBuffer, format = AUDIO_SAMPLE_S16) {
+            const compact = new CompactAudioBuffer(audioBuffer.numberOfChannels, audioBuffer.length,
+                audioBuffer.sampleRate, format);
+            for (let ch = 0; ch < compact.numberOfChannels; ch++) {
+                compact.channels[ch] = narrowSamples(audioBuffer.getChannelData(ch), format);
+            }
+            return compact;
+        }
+
+        get duration() {
+            return this.length / this.sampleRate;
+        }
+
+        // 驻留的样本数据字节数 (同样长度的 float 为其 2 倍)
+        get byteLength() {
+            return this.length * this.numberOfChannels * 2;
+        }
+
+        // 紧凑数据 (不复制)
+        getSamples(ch) {
+            return this.channels[ch];
+        }
+
+        getChannelData(ch) {
+            return widenSamples(this.channels[ch], this.format);
+        }
+
+        /**
+         * 播放时展开为 Web Audio 的 AudioBuffer
+         * @param {BaseAudioContext} context
+         */
+        toAudioBuffer(context) {
+            const buffer = context.createBuffer(this.numberOfChannels, this.length, this.sampleRate);
+            for (let ch = 0; ch < this.numberOfChannels; ch++) {
+                buffer.copyToChannel(this.getChannelData(ch), ch);
+            }
+            return buffer;
+        }
+    }
+
+    // 旧版 WASM 不认识紧凑格式: 在 JS 中逐声道拼接 (只是复制, 不展开)
+    function concatCompact(segments) {
+        const first = segments[0];
+        const length = segments.reduce((sum, seg) => sum + seg.length, 0);
+        const target = new CompactAudioBuffer(first.numberOfChannels, length, first.sampleRate, first.format);
+        for (let ch = 0; ch < target.numberOfChannels; ch++) {
+            let offset = 0;
+            for (const seg of segments) {
+                target.channels[ch].set(seg.getSamples(ch), offset);
+                offset += seg.length;
+            }
+        }
+        return target;
+    }
+
+    /**
+     * 多线程版本 (pthreads) 需要 SharedArrayBuffer, 浏览器只在跨源隔离 (COOP + COEP) 的页面中提供
+     */
+    function threadingAvailable() {
+        return typeof SharedArrayBuffer !== 'undefined' && root.crossOriginIsolated === true;
+    }
+
+    function loadScript(url) {
+        return new Promise((resolve, reject) => {
+            const script = document.createElement('script');
+            script.src = url;
+            script.onload = resolve;
+            script.onerror = () => reject(new Error(`脚本加载失败: ${url}`));
+            document.head.appendChild(script);
+        });
+    }
+
+    /**
+     * 加载 Emscripten 胶水代码并实例化模块, 自行实例化以拿到线性内存
+     * 页面已加载 wasm_module_cache.js 时使用缓存的已编译模块, 否则流式编译
+     * @returns {Promise<{module: Object, memory: WebAssembly.Memory}>}
+     */
+    async function instantiateModule({ scriptUrl, wasmUrl, factoryName, extraConfig = {} }) {
+        if (typeof root[factoryName] !== 'function') {
+            await loadScript(scriptUrl);
+        }
+        let memory = null;
+        // 胶水代码只在 receiveInstance 被调用后才完成工厂 Promise; 实例化失败时由这里拒绝, 否则调用方会一直等待
+        let rejectInstantiate = null;
+        const failed = new Promise((resolve, reject) => { rejectInstantiate = reject; });
+        const module = await Promise.race([failed, root[factoryName](Object.assign({
+            locateFile: filename => filename.endsWith('.wasm') ? wasmUrl : filename,
+            noExitRuntime: true,
+            instantiateWasm(imports, receiveInstance) {
+                const source = typeof root.loadCompiledModule === 'function'
+                    ? root.loadCompiledModule(wasmUrl).then(({ module }) =>
+                        WebAssembly.instantiate(module, imports).then(instance => ({ instance, module })))
+                    : WebAssembly.instantiateStreaming(fetch(wasmUrl), imports);
+                source.then(output => {
+                    // 多线程版本的内存由胶水代码创建后导入, 不在导出中
+                    memory = WasmAudioKernels.findMemory(output.instance.exports)
+                        || (imports.env && imports.env.memory) || null;
+                    receiveInstance(output.instance, output.module);
+                }).catch(error => {
+                    console.warn(`[WASM] ${wasmUrl} 实例化失败:`, error.message);
+                    rejectInstantiate(new Error(`${wasmUrl} 实例化失败: ${error.message}`));
+                });
+                return {};
+            }
+        }, extraConfig))]);
+        if (!memory) {
+            throw new Error(`${wasmUrl} 缺少线性内存`);
+        }
+        return { module, memory };
+    }
+
+    /**
+     * 加载功能模块 (浏览器), 返回包装它的 WasmAudioKernels
+     * @param {Object} feature - WASM_FEATURES 中的一项
+     */
+    async function loadFeatureModule(feature) {
+        const { module, memory } = await instantiateModule(feature);
+        return new WasmAudioKernels(module, memory);
+    }
+
+    /**
+     * 从 Emscripten 胶水代码 (-O3 压缩后) 中解析 _wasm_xxx -> 压缩后导出名 的映射
+     */
+    function parseExportNames(glueSource) {
+        const names = {};
+        const re = /(_\w+)=Module\["\1"\]=wasmExports\["(\w+)"\]/g;
+        let m;
+        while ((m = re.exec(glueSource)) !== null) {
+            names[m[1].replace(/^_/, '')] = m[2];
+        }
+        const memory = /wasmMemory=wasmExports\["(\w+)"\]/.exec(glueSource);
+        const ctors = /wasmExports\["(\w+)"\]\(\)\}function postRun/.exec(glueSource);
+        const resizeHeap = /wasmImports=\{(\w+):_emscripten_resize_heap/.exec(glueSource);
+        return { names, memory: memory && memory[1], ctors: ctors && ctors[1], resizeHeap: resizeHeap ? resizeHeap[1] : 'a' };
+    }
+
+    /**
+     * 不执行胶水代码, 按其中的导出名映射直接实例化 (Node 基准测试, Cloudflare Worker 等没有 DOM 的环境)
+     * @param {string} glueSource - 胶水代码文本
+     * @param {BufferSource|WebAssembly.Module} wasmSource - WASM 二进制或已编译模块
+     * @param {Function} [featureLoader] - 见 WasmAudioKernels 构造函数
+     * @returns {Promise<WasmAudioKernels>}
+     */
+    async function instantiateFromGlue(glueSource, wasmSource, featureLoader) {
+        const { names, memory, ctors, resizeHeap } = parseExportNames(glueSource);
+
+        let exports = null;
+        const imports = {
+            a: {
+                // emscripten_resize_heap: 按需增长内存
+                [resizeHeap]: requestedSize => {
+                    const mem = exports[memory];
+                    const needed = requestedSize - mem.buffer.byteLength;
+                    try {
+                        mem.grow(Math.ceil(needed / 65536));
+                        return 1;
+                    } catch (e) {
+                        return 0;
+                    }
+                }
+            }
+        };
+
+        const instance = wasmSource instanceof WebAssembly.Module
+            ? await WebAssembly.instantiate(wasmSource, imports)
+            : (await WebAssembly.instantiate(wasmSource, imports)).instance;
+        exports = instance.exports;
+        if (ctors) exports[ctors]();
+
+        // 与 Emscripten Module 一致的 _wasm_xxx 命名，供 WasmAudioKernels 直接使用
+        const wasm = {};
+        for (const [name, short] of Object.entries(names)) {
+            wasm['_' + name] = exports[short];
+        }
+        return new WasmAudioKernels(wasm, exports[memory], featureLoader);
+    }
+
+    /**
+     * 加载多线程 WASM 模块 (task_pool.h 中的构建命令生成 audio_processor_mt.js / .wasm)
+     * 环境不支持或任何一步失败时返回 null, 调用方继续使用单线程模块
+     * @param {Object} [options]
+     * @param {string} options.scriptUrl - Emscripten 胶水代码 (工作线程也会加载它)
+     * @param {string} options.wasmUrl - WASM 二进制
+     * @param {string} options.factoryName - MODULARIZE 导出的工厂函数名
+     * @param {number} options.threads - 线程数 (默认取 CPU 核数, 最多 8)
+     * @returns {Promise<{module: Object, memory: WebAssembly.Memory, threads: number}|null>}
+     */
+    async function loadThreadedModule(options = {}) {
+        if (!threadingAvailable()) return null;
+        const {
+            scriptUrl = 'audio_processor_mt.js',
+            wasmUrl = 'audio_processor_mt.wasm',
+            factoryName = 'AudioProcessorWASM_MT',
+            threads = Math.min(8, (typeof navigator !== 'undefined' && navigator.hardwareConcurrency) || 4)
+        } = options;
+
+        try {
+            const { module, memory } = await instantiateModule({
+                scriptUrl, wasmUrl, factoryName, extraConfig: { mainScriptUrlOrBlob: scriptUrl }
+            });
+            if (typeof module._wasm_set_threads !== 'function') {
+                throw new Error('模块缺少 wasm_set_threads 导出');
+            }
+            return { module, memory, threads: module._wasm_set_threads(threads) };
+        } catch (error) {
+            console.warn('[WASM 多线程] 不可用，使用单线程模块:', error.message);
+            return null;
+        }
+    }
+
+    // 把 buffer 的第 [from, to) 个声道按平面布局写入 dataPtr 处 (声道间隔为 buffer.length)
+    function writeChannel(memory, dataPtr, buffer, from, to, format) {
+        for (let ch = from; ch < to; ch++) {
+            if (format === AUDIO_SAMPLE_F32) {
+                new Float32Array(memory.buffer, dataPtr + ch * buffer.length * 4, buffer.length).set(buffer.getChannelData(ch));
+            } else {
+                const samples = buffer.getSamples(ch);
+                new Uint8Array(memory.buffer, dataPtr + ch * buffer.length * 2, buffer.length * 2)
+                    .set(new Uint8Array(samples.buffer, samples.byteOffset, buffer.length * 2));
+            }
+        }
+    }
+
+    /**
+     * 在 g_memory_buffer 中顺序分配区域
+     * 输出写在缓冲区开头，输入放在 outputBytes 之后，避免被输出覆盖、也不会触发 realloc
+     */
+    class WasmArena {
+        constructor(kernels, outputBytes, inputBytes) {
+            const m = kernels.module;
+            this.kernels = kernels;
+            const total = align(outputBytes) + inputBytes + 4096;
+            if (total > kernels.capacity) {
+                if (m._wasm_init_memory(total) === 0) {
+                    throw new Error(`WASM 内存分配失败 (${total} bytes)`);
+                }
+                kernels.capacity = total;
+            }
+            this.base = m._wasm_get_memory_buffer();
+            this.offset = this.base + align(outputBytes);
+        }
+
+        alloc(bytes) {
+            const ptr = this.offset;
+            this.offset += align(bytes);
+            return ptr;
+        }
+
+        // 每次重新创建视图: 内存增长后旧的 ArrayBuffer 会失效
+        f32(ptr, length) {
+            return new Float32Array(this.kernels.memory.buffer, ptr, length);
+        }
+
+        u8(ptr, length) {
+            return new Uint8Array(this.kernels.memory.buffer, ptr, length);
+        }
+
+        // layout 必须显式写入: arena 内存会被复用, 留在原处的可能是上一次的数据
+        // format 为样本格式 (AUDIO_SAMPLE_*), 写入 layout 的高 8 位
+        writeAudioBuffer(structPtr, dataPtr, length, channels, sampleRate, layout = AUDIO_LAYOUT_PLANAR,
+                         format = AUDIO_SAMPLE_F32) {
+            const view = new DataView(this.kernels.memory.buffer);
+            view.setUint32(structPtr, dataPtr, true);
+            view.setUint32(structPtr + 4, length, true);
+            view.setUint16(structPtr + 8, channels, true);
+            view.setUint16(structPtr + 10, layout | (format << AUDIO_FORMAT_SHIFT), true);
+            view.setUint32(structPtr + 12, sampleRate, true);
+        }
+
+        // 写入 AudioSegment 数组, 返回其指针
+        writeSegments(plan) {
+            const ptr = this.alloc(plan.length * AUDIO_SEGMENT_STRUCT_SIZE);
+            const words = new Uint32Array(this.kernels.memory.buffer, ptr, plan.length * 2);
+            plan.forEach((seg, i) => {
+                words[i * 2] = seg.start;
+                words[i * 2 + 1] = seg.length;
+            });
+            return ptr;
+        }
+
+        // 读取 SegmentResult 数组 (offset 相对 base), 一次建立视图
+        readResults(ptr, count) {
+            const words = new Uint32Array(this.kernels.memory.buffer, ptr, count * 3);
+            const results = [];
+            for (let i = 0; i < count; i++) {
+                results.push({ offset: words[i * 3], size: words[i * 3 + 1], frames: words[i * 3 + 2] });
+            }
+            return results;
+        }
+
+        // channels 省略时写入全部声道; 紧凑格式 (format 非 F32) 时原样写入 CompactAudioBuffer 的数据
+        writeChannels(dataPtr, buffer, channels = buffer.numberOfChannels, format = AUDIO_SAMPLE_F32) {
+            writeChannel(this.kernels.memory, dataPtr, buffer, 0, channels, format);
+        }
+
+        // 读出 count 个紧凑格式的样本 (复制)
+        readCompact(ptr, count, format) {
+            const Type = format === AUDIO_SAMPLE_S16 ? Int16Array : Uint16Array;
+            return new Type(this.kernels.memory.buffer, ptr, count).slice();
+        }
+    }
+
+    class WasmAudioKernels {
+        /**
+         * @param {Object} module - Emscripten 模块 (提供 _wasm_* 函数)
+         * @param {WebAssembly.Memory} memory - 模块的线性内存
+         * @param {Function} [featureLoader] - (feature) => Promise<WasmAudioKernels>, 默认 loadFeatureModule
+         */
+        constructor(module, memory, featureLoader = loadFeatureModule) {
+            this.module = module;
+            this.memory = memory;
+            this.capacity = 0;          // 当前 g_memory_buffer 容量 (只增不减)
+            this.lastKernelMs = 0;      // 最近一次调用中 wasm_* 本身的耗时
+            this.featureLoader = featureLoader;
+            this.features = new Map();  // 功能名 -> Promise<WasmAudioKernels>
+        }
+
+        /**
+         * 返回能调用 exportName 的内核: 本模块有该导出时返回自身, 否则加载 (只加载一次) 所属的功能模块
+         * 用法: (await kernels.feature('_wasm_analyze_audio')).analyzeLevels(buffer)
+         * @param {string} exportName - 如 '_wasm_resample_audio'
+         * @returns {Promise<WasmAudioKernels>}
+         */
+        async feature(exportName) {
+            if (typeof this.module[exportName] === 'function') return this;
+            const name = featureOf(exportName);
+            if (!name) {
+                throw new Error(`WASM 模块未导出 ${exportName}`);
+            }
+            if (!this.features.has(name)) {
+                const loading = this.featureLoader(WASM_FEATURES[name]);
+                // 加载失败时允许下次重试
+                loading.catch(() => this.features.delete(name));
+                this.features.set(name, loading);
+            }
+            const kernels = await this.features.get(name);
+            if (typeof kernels.module[exportName] !== 'function') {
+                throw new Error(`功能模块 ${name} 未导出 ${exportName}`);
+            }
+            return kernels;
+        }
+
+        /**
+         * C++ 侧的线程数 (单线程模块为 1)
+         */
+        get threads() {
+            return typeof this.module._wasm_get_threads === 'function' ? this.module._wasm_get_threads() : 1;
+        }
+
+        /**
+         * 从 instance.exports 中找到导出的内存 (Emscripten 会压缩导出名)
+         */
+        static findMemory(exports) {
+            for (const value of Object.values(exports)) {
+                if (value instanceof WebAssembly.Memory) return value;
+            }
+            return null;
+        }
+
+        /**
+         * AudioBuffer 编码为 16 位 PCM WAV (与 encodeWavLegacy 一致，最多保留 2 个声道)
+         * 支持视图的 WASM 直接读取平面数据编码; 旧版 WASM 只接受交错输入, 在 JS 中交错后再编码
+         * @returns {ArrayBuffer} WAV 文件数据
+         */
+        encodeWav(audioBuffer) {
+            if (this.supportsViews) {
+                return this.encodeSegments(audioBuffer, [{ start: 0, length: audioBuffer.length }])[0];
+            }
+            const channels = Math.min(2, audioBuffer.numberOfChannels);
+            const length = audioBuffer.length;
+            const floats = length * channels;
+            const arena = new WasmArena(this, 44 + floats * 2, floats * 4);
+            const input = arena.alloc(floats * 4);
+
+            // 交错通道数据
+            const interleaved = arena.f32(input, floats);
+            for (let ch = 0; ch < channels; ch++) {
+                const data = audioBuffer.getChannelData(ch);
+                for (let i = 0, j = ch; i < length; i++, j += channels) {
+                    interleaved[j] = data[i];
+                }
+            }
+
+            const t0 = now();
+            const size = this.module._wasm_audio_buffer_to_wav(input, length, channels, audioBuffer.sampleRate, 16);
+            this.lastKernelMs = now() - t0;
+            if (size === 0) {
+                throw new Error('WASM WAV 编码失败');
+            }
+            return arena.u8(arena.base, size).slice().buffer;
+        }
+
+        /**
+         * 解码 WAV 文件 (16 / 24 位整数 PCM), 没有 AudioContext 的环境 (Worker, Node) 用它代替 decodeAudioData
+         * wasm_wav_to_audio_buffer 只认 44 字节标准文件头, 这里先在 JS 中找到 fmt / data 块, 重写为标准文件头再解码
+         * 其他编码 (8 / 32 位整数, IEEE float, 压缩格式) 抛出错误; WAVE_FORMAT_EXTENSIBLE 只接受子格式为 PCM 的文件
+         * @param {ArrayBuffer|Uint8Array} wav - WAV 文件数据
+         * @param {Function} createTarget - (channels, length, sampleRate) => AudioBuffer
+         * @returns {AudioBuffer} 平面布局的音频
+         */
+        decodeWav(wav, createTarget) {
+            const bytes = wav instanceof Uint8Array ? wav : new Uint8Array(wav);
+            const view = new DataView(bytes.buffer, bytes.byteOffset, bytes.byteLength);
+            const tag = offset => String.fromCharCode(bytes[offset], bytes[offset + 1], bytes[offset + 2], bytes[offset + 3]);
+            if (bytes.length < 12 || tag(0) !== 'RIFF' || tag(8) !== 'WAVE') {
+                throw new Error('不是 WAV 文件');
+            }
+
+            let fmt = -1, data = -1, dataSize = 0;
+            for (let offset = 12; offset + 8 <= bytes.length;) {
+                const size = view.getUint32(offset + 4, true);
+                if (tag(offset) === 'fmt ') fmt = offset + 8;
+                if (tag(offset) === 'data') {
+                    data = offset + 8;
+                    // 流式写出的文件 data 长度可能未回填, 以实际长度为准
+                    dataSize = Math.min(size, bytes.length - data);
+                    break;
+                }
+                offset += 8 + size + (size & 1);
+            }
+            if (fmt < 0 || data < 0) {
+                throw new Error('WAV 缺少 fmt 或 data 块');
+            }
+            // audio_format: 1 = PCM, 0xFFFE = EXTENSIBLE (子格式 GUID 的前 2 字节在 fmt + 24)
+            let audioFormat = view.getUint16(fmt, true);
+            if (audioFormat === WAVE_FORMAT_EXTENSIBLE && fmt + 26 <= bytes.length) {
+                audioFormat = view.getUint16(fmt + 24, true);
+            }
+            const channels = view.getUint16(fmt + 2, true);
+            const bitsPerSample = view.getUint16(fmt + 14, true);
+            if (audioFormat !== WAVE_FORMAT_PCM || (bitsPerSample !== 16 && bitsPerSample !== 24)) {
+                throw new Error(`不支持的 WAV 编码 (格式 ${audioFormat}, ${bitsPerSample} 位), 只支持 16 / 24 位 PCM`);
+            }
+            const frameBytes = channels * (bitsPerSample >> 3);
+            if (channels === 0 || frameBytes === 0) {
+                throw new Error('WAV 格式无效');
+            }
+            dataSize -= dataSize % frameBytes;
+            const frames = dataSize / frameBytes;
+            const floats = frames * channels;
+
+            const arena = new WasmArena(this, floats * 4, 44 + dataSize + AUDIO_BUFFER_STRUCT_SIZE);
+            const outputStruct = arena.alloc(AUDIO_BUFFER_STRUCT_SIZE);
+            const input = arena.alloc(44 + dataSize);
+            const header = arena.u8(input, 44);
+            header.set(bytes.subarray(0, 12));
+            header.set([0x66, 0x6d, 0x74, 0x20, 16, 0, 0, 0], 12);
+            header.set(bytes.subarray(fmt, fmt + 16), 20);
+            new DataView(this.memory.buffer).setUint16(input + 20, WAVE_FORMAT_PCM, true);     // EXTENSIBLE 改写为 PCM
+            header.set([0x64, 0x61, 0x74, 0x61], 36);
+            new DataView(this.memory.buffer).setUint32(input + 40, dataSize, true);
+            arena.u8(input + 44, dataSize).set(bytes.subarray(data, data + dataSize));
+
+            const t0 = now();
+            const n = this.module._wasm_wav_to_audio_buffer(input, 44 + dataSize, outputStruct);
+            this.lastKernelMs = now() - t0;
+            if (n === 0 && frames > 0) {
+                throw new Error(`WASM WAV 解码失败 (${bitsPerSample} 位)`);
+            }
+
+            // 输出为交错布局, 解交错到目标缓冲区
+            const sampleRate = view.getUint32(fmt + 4, true);
+            const interleaved = arena.f32(arena.base, n * channels);
+            const target = createTarget(channels, n, sampleRate);
+            for (let ch = 0; ch < channels; ch++) {
+                const out = target.getChannelData(ch);
+                for (let i = 0, j = ch; i < n; i++, j += channels) {
+                    out[i] = interleaved[j];
+                }
+            }
+            return target;
+        }
+
+        /**
+         * 按计划切出多个片段
+         * @param {AudioBuffer} source - 源缓冲区
+         * @param {Array<{start: number, length: number}>} plan - 切分计划
+         * @param {Function} createTarget - (channels, length, sampleRate) => AudioBuffer
+         * @returns {AudioBuffer[]} 片段数组
+         */
+        sliceSegments(source, plan, createTarget) {
+            if (this.supportsBatch) {
+                return this.sliceSegmentsBatch(source, plan, createTarget);
+            }
+            const channels = source.numberOfChannels;
+            const maxLength = plan.reduce((max, seg) => Math.max(max, seg.length), 0);
+            const arena = new WasmArena(this, maxLength * channels * 4,
+                source.length * channels * 4 + AUDIO_BUFFER_STRUCT_SIZE);
+            const sourceStruct = arena.alloc(AUDIO_BUFFER_STRUCT_SIZE);
+            const sourceData = arena.alloc(source.length * channels * 4);
+            arena.writeAudioBuffer(sourceStruct, sourceData, source.length, channels, source.sampleRate);
+            arena.writeChannels(sourceData, source);
+
+            let kernelMs = 0;
+            const segments = plan.map(seg => {
+                const t0 = now();
+                const n = this.module._wasm_slice_audio(sourceStruct, seg.start, seg.length);
+                kernelMs += now() - t0;
+                if (n === 0 && seg.length > 0) {
+                    throw new Error('WASM 切片失败');
+                }
+                const target = createTarget(channels, n, source.sampleRate);
+                for (let ch = 0; ch < channels; ch++) {
+                    target.getChannelData(ch).set(arena.f32(arena.base + ch * n * 4, n));
+                }
+                return target;
+            });
+            this.lastKernelMs = kernelMs;
+            return segments;
+        }
+
+        /**
+         * 一次 wasm_slice_segments 调用切出全部片段, 各片段的平面数据依次放在输出区
+         */
+        sliceSegmentsBatch(source, plan, createTarget) {
+            const channels = source.numberOfChannels;
+            // 按未截断的长度估算输出区上限 (C++ 侧每段起点按 16 字节对齐)
+            const outputBytes = plan.reduce((sum, seg) => sum + align(seg.length * channels * 4), 0);
+            const arena = new WasmArena(this, outputBytes,
+                source.length * channels * 4 + AUDIO_BUFFER_STRUCT_SIZE
+                + plan.length * (AUDIO_SEGMENT_STRUCT_SIZE + SEGMENT_RESULT_STRUCT_SIZE) + 32);
+            const sourceStruct = arena.alloc(AUDIO_BUFFER_STRUCT_SIZE);
+            const segmentsPtr = arena.writeSegments(plan);
+            const resultsPtr = arena.alloc(plan.length * SEGMENT_RESULT_STRUCT_SIZE);
+            const sourceData = arena.alloc(source.length * channels * 4);
+            arena.writeAudioBuffer(sourceStruct, sourceData, source.length, channels, source.sampleRate);
+            arena.writeChannels(sourceData, source);
+
+            const t0 = now();
+            const total = this.module._wasm_slice_segments(sourceStruct, segmentsPtr, plan.length, resultsPtr);
+            this.lastKernelMs = now() - t0;
+            if (total === 0 && outputBytes > 0) {
+                throw new Error('WASM 批量切片失败');
+            }
+
+            const output = arena.f32(arena.base, total >> 2);
+            return arena.readResults(resultsPtr, plan.length).map(result => {
+                const n = result.frames;
+                const target = createTarget(channels, n, source.sampleRate);
+                const first = result.offset >> 2;
+                for (let ch = 0; ch < channels; ch++) {
+                    target.getChannelData(ch).set(output.subarray(first + ch * n, first + (ch + 1) * n));
+                }
+                return target;
+            });
+        }
+
+        /**
+         * 是否支持紧凑样本格式 (wasm_convert_samples); 旧版 WASM 中紧凑数据在上传前展开为 float
+         */
+        get supportsCompact() {
+            return typeof this.module._wasm_convert_samples === 'function';
+        }
+
+        // 上传 buffer 时使用的样本格式: WASM 能直接读取时保持紧凑格式
+        uploadFormat(buffer) {
+            return buffer instanceof CompactAudioBuffer && this.supportsCompact ? buffer.format : AUDIO_SAMPLE_F32;
+        }
+
+        /**
+         * 压缩为紧凑格式, 用于等待合并 / 播放的片段 (int16 与 16 位 WAV 的量化相同, 编码时逐位一致)
+         * @param {AudioBuffer} audioBuffer
+         * @param {number} [format] - AUDIO_SAMPLE_S16 (默认) / AUDIO_SAMPLE_F16
+         * @returns {CompactAudioBuffer}
+         */
+        compact(audioBuffer, format = AUDIO_SAMPLE_S16) {
+            if (!this.supportsCompact) {
+                return CompactAudioBuffer.from(audioBuffer, format);
+            }
+            const channels = audioBuffer.numberOfChannels;
+            const samples = audioBuffer.length * channels;
+            const arena = new WasmArena(this, samples * 2, samples * 4 + 2 * AUDIO_BUFFER_STRUCT_SIZE);
+            const sourceStruct = arena.alloc(AUDIO_BUFFER_STRUCT_SIZE);
+            const outputStruct = arena.alloc(AUDIO_BUFFER_STRUCT_SIZE);
+            const sourceData = arena.alloc(samples * 4);
+            arena.writeAudioBuffer(sourceStruct, sourceData, audioBuffer.length, channels, audioBuffer.sampleRate);
+            arena.writeChannels(sourceData, audioBuffer);
+
+            const t0 = now();
+            const n = this.module._wasm_convert_samples(sourceStruct, format, outputStruct);
+            this.lastKernelMs = now() - t0;
+            if (n === 0 && audioBuffer.length > 0) {
+                throw new Error('WASM 样本压缩失败');
+            }
+
+            const target = new CompactAudioBuffer(channels, n, audioBuffer.sampleRate, format);
+            for (let ch = 0; ch < channels; ch++) {
+                target.channels[ch] = arena.readCompact(arena.base + ch * n * 2, n, format);
+            }
+            return target;
+        }
+
+        /**
+         * 紧凑格式展开为 float (需要 AudioBuffer 的下游使用; 播放可直接用 CompactAudioBuffer.toAudioBuffer)
+         * @param {CompactAudioBuffer} compact
+         * @param {Function} createTarget - (channels, length, sampleRate) => AudioBuffer
+         */
+        expand(compact, createTarget) {
+            const channels = compact.numberOfChannels;
+            const n = compact.length;
+            const target = createTarget(channels, n, compact.sampleRate);
+            if (!this.supportsCompact) {
+                for (let ch = 0; ch < channels; ch++) {
+                    widenSamples(compact.getSamples(ch), compact.format, target.getChannelData(ch));
+                }
+                return target;
+            }
+            const samples = n * channels;
+            const arena = new WasmArena(this, samples * 4, samples * 2 + 2 * AUDIO_BUFFER_STRUCT_SIZE);
+            const sourceStruct = arena.alloc(AUDIO_BUFFER_STRUCT_SIZE);
+            const outputStruct = arena.alloc(AUDIO_BUFFER_STRUCT_SIZE);
+            const sourceData = arena.alloc(samples * 2);
+            arena.writeAudioBuffer(sourceStruct, sourceData, n, channels, compact.sampleRate,
+                AUDIO_LAYOUT_PLANAR, compact.format);
+            arena.writeChannels(sourceData, compact, channels, compact.format);
+
+            const t0 = now();
+            const count = this.module._wasm_convert_samples(sourceStruct, AUDIO_SAMPLE_F32, outputStruct);
+            this.lastKernelMs = now() - t0;
+            if (count === 0 && n > 0) {
+                throw new Error('WASM 样本展开失败');
+            }
+            for (let ch = 0; ch < channels; ch++) {
+                target.getChannelData(ch).set(arena.f32(arena.base + ch * n * 4, n));
+            }
+            return target;
+        }
+
+        /**
+         * 是否支持批量导出 (wasm_encode_segments / wasm_slice_segments), 一个任务阶段只需一次 WASM 调用
+         */
+        get supportsBatch() {
+            return typeof this.module._wasm_encode_segments === 'function'
+                && typeof this.module._wasm_slice_segments === 'function';
+        }
+
+        /**
+         * 是否支持切片视图 (旧版 WASM 没有 wasm_slice_view / wasm_view_to_wav)
+         */
+        get supportsViews() {
+            return typeof this.module._wasm_slice_view === 'function'
+                && typeof this.module._wasm_view_to_wav === 'function';
+        }
+
+        /**
+         * 是否支持分步执行 (wasm_job_*); 重采样的 begin 在 DSP 功能模块中, 单独检测
+         */
+        get supportsJobs() {
+            return typeof this.module._wasm_job_merge_begin === 'function';
+        }
+
+        // 分步任务第 index 个输入的数据区 (wasm_job_input 返回的 AudioBuffer.data)
+        jobInputData(job, index) {
+            return new DataView(this.memory.buffer).getUint32(this.module._wasm_job_input(job, index), true);
+        }
+
+        /**
+         * 执行分步任务直到完成: 每步用完当前时间片的剩余预算, 之后让出主线程
+         * lastKernelMs 记为各步耗时之和
+         * @returns {Promise<{data: number, length: number}>} 输出 (wasm_job_output) 的数据指针和帧数
+         */
+        async runJob(job, slicer) {
+            let kernelMs = 0;
+            for (;;) {
+                const t0 = now();
+                const remaining = this.module._wasm_job_step(job, 0, Math.max(1, slicer.remaining()));
+                kernelMs += now() - t0;
+                if (remaining === 0) break;
+                await slicer.yield();
+            }
+            this.lastKernelMs = kernelMs;
+            const output = this.module._wasm_job_output(job);
+            const view = new DataView(this.memory.buffer);
+            return { data: view.getUint32(output, true), length: view.getUint32(output + 4, true) };
+        }
+
+        /**
+         * 按计划切分并直接编码为 16 位 WAV (零拷贝切片)
+         * 源数据只上传一次; 支持批量导出时一次 wasm_encode_segments 调用编码全部片段,
+         * 否则每个片段由 wasm_slice_view 生成视图描述符, wasm_view_to_wav 直接读取源数据编码.
+         * 片段的 float 数据不会被复制或拷出. 与 encodeWav 一致, 最多保留 2 个声道
+         * @param {AudioBuffer} source - 源缓冲区
+         * @param {Array<{start: number, length: number}>} plan - 切分计划
+         * @returns {ArrayBuffer[]} 各片段的 WAV 文件数据
+         */
+        encodeSegments(source, plan) {
+            if (this.supportsBatch) {
+                return this.encodeSegmentsBatch(source, plan);
+            }
+            if (!this.supportsViews) {
+                throw new Error('WASM 模块不支持切片视图');
+            }
+            const channels = Math.min(2, source.numberOfChannels);
+            const format = this.uploadFormat(source);
+            const sourceBytes = source.length * channels * sampleBytes(format);
+            const maxLength = plan.reduce((max, seg) => Math.max(max, seg.length), 0);
+            // 输出区放得下最长片段的 WAV, 源数据在其后, 编码不会覆盖源数据
+            const arena = new WasmArena(this, 44 + maxLength * channels * 2,
+                sourceBytes + AUDIO_BUFFER_STRUCT_SIZE + AUDIO_VIEW_STRUCT_SIZE);
+            const sourceStruct = arena.alloc(AUDIO_BUFFER_STRUCT_SIZE);
+            const viewStruct = arena.alloc(AUDIO_VIEW_STRUCT_SIZE);
+            const sourceData = arena.alloc(sourceBytes);
+            arena.writeAudioBuffer(sourceStruct, sourceData, source.length, channels, source.sampleRate,
+                AUDIO_LAYOUT_PLANAR, format);
+            arena.writeChannels(sourceData, source, channels, format);
+
+            let kernelMs = 0;
+            const wavs = plan.map(seg => {
+                const t0 = now();
+                this.module._wasm_slice_view(sourceStruct, seg.start, seg.length, viewStruct);
+                const size = this.module._wasm_view_to_wav(viewStruct, 16);
+                kernelMs += now() - t0;
+                if (size === 0) {
+                    throw new Error('WASM 视图编码失败');
+                }
+                return arena.u8(arena.base, size).slice().buffer;
+            });
+            this.lastKernelMs = kernelMs;
+            return wavs;
+        }
+
+        /**
+         * 一次 wasm_encode_segments 调用编码全部片段, 各 WAV 依次放在输出区, 拷出时只建立一个视图
+         */
+        encodeSegmentsBatch(source, plan) {
+            const channels = Math.min(2, source.numberOfChannels);
+            const format = this.uploadFormat(source);
+            const sourceBytes = source.length * channels * sampleBytes(format);
+            // 按未截断的长度估算输出区上限 (C++ 侧每个 WAV 起点按 4 字节对齐)
+            const outputBytes = plan.reduce((sum, seg) => sum + ((44 + seg.length * channels * 2 + 3) & ~3), 0);
+            const arena = new WasmArena(this, outputBytes,
+                sourceBytes + AUDIO_BUFFER_STRUCT_SIZE
+                + plan.length * (AUDIO_SEGMENT_STRUCT_SIZE + SEGMENT_RESULT_STRUCT_SIZE) + 32);
+            const sourceStruct = arena.alloc(AUDIO_BUFFER_STRUCT_SIZE);
+            const segmentsPtr = arena.writeSegments(plan);
+            const resultsPtr = arena.alloc(plan.length * SEGMENT_RESULT_STRUCT_SIZE);
+            const sourceData = arena.alloc(sourceBytes);
+            arena.writeAudioBuffer(sourceStruct, sourceData, source.length, channels, source.sampleRate,
+                AUDIO_LAYOUT_PLANAR, format);
+            arena.writeChannels(sourceData, source, channels, format);
+
+            const t0 = now();
+            const total = this.module._wasm_encode_segments(sourceStruct, segmentsPtr, plan.length, 16, resultsPtr);
+            this.lastKernelMs = now() - t0;
+            if (total === 0 && plan.length > 0) {
+                throw new Error('WASM 批量编码失败');
+            }
+
+            const output = arena.u8(arena.base, total);
+            return arena.readResults(resultsPtr, plan.length).map(result =>
+                output.slice(result.offset, result.offset + result.size).buffer);
+        }
+
+        /**
+         * 拼接多个片段
+         * 全部片段都是同一格式的 CompactAudioBuffer 时结果仍为 CompactAudioBuffer (不展开), 否则按 float 合并
+         * @param {AudioBuffer[]} segments - 片段数组 (声道数 / 采样率一致)
+         * @param {Function} createTarget - (channels, length, sampleRate) => AudioBuffer
+         * @returns {AudioBuffer|CompactAudioBuffer} 合并结果
+         */
+        concat(segments, createTarget) {
+            const channels = segments[0].numberOfChannels;
+            const sampleRate = segments[0].sampleRate;
+            const totalLength = segments.reduce((sum, seg) => sum + seg.length, 0);
+            const compactFormat = segments.every(seg => seg instanceof CompactAudioBuffer
+                && seg.format === segments[0].format) ? segments[0].format : AUDIO_SAMPLE_F32;
+            if (compactFormat !== AUDIO_SAMPLE_F32 && !this.supportsCompact) {
+                return concatCompact(segments);
+            }
+            const bytes = sampleBytes(compactFormat);
+            const samples = totalLength * channels;
+            const arena = new WasmArena(this, samples * bytes,
+                samples * bytes + (segments.length + 1) * AUDIO_BUFFER_STRUCT_SIZE + segments.length * 16);
+
+            const structs = arena.alloc(segments.length * AUDIO_BUFFER_STRUCT_SIZE);
+            const output = arena.alloc(AUDIO_BUFFER_STRUCT_SIZE);
+            segments.forEach((seg, i) => {
+                const ptr = arena.alloc(seg.length * channels * bytes);
+                arena.writeAudioBuffer(structs + i * AUDIO_BUFFER_STRUCT_SIZE, ptr, seg.length, channels, seg.sampleRate,
+                    AUDIO_LAYOUT_PLANAR, compactFormat);
+                arena.writeChannels(ptr, seg, channels, compactFormat);
+            });
+
+            const t0 = now();
+            const n = this.module._wasm_merge_audio_buffers(structs, segments.length, output);
+            this.lastKernelMs = now() - t0;
+            if (n === 0 && totalLength > 0) {
+                throw new Error('WASM 合并失败 (片段格式不一致?)');
+            }
+
+            if (compactFormat !== AUDIO_SAMPLE_F32) {
+                const target = new CompactAudioBuffer(channels, n, sampleRate, compactFormat);
+                for (let ch = 0; ch < channels; ch++) {
+                    target.channels[ch] = arena.readCompact(arena.base + ch * n * 2, n, compactFormat);
+                }
+                return target;
+            }
+            const target = createTarget(channels, n, sampleRate);
+            for (let ch = 0; ch < channels; ch++) {
+                target.getChannelData(ch).set(arena.f32(arena.base + ch * n * 4, n));
+            }
+            return target;
+        }
+
+        /**
+         * 分步拼接: 结果与 concat 相同, 上传 / 合并 / 拷出按时间片执行, 片与片之间让出主线程
+         * 旧版 WASM 没有分步接口时直接调用 concat
+         * @param {Object} [options] - { sliceMs: 每个时间片的预算 (毫秒) }
+         * @returns {Promise<AudioBuffer|CompactAudioBuffer>}
+         */
+        async concatSliced(segments, createTarget, options = {}) {
+            if (!this.supportsJobs) return this.concat(segments, createTarget);
+            const channels = segments[0].numberOfChannels;
+            const sampleRate = segments[0].sampleRate;
+            const compactFormat = segments.every(seg => seg instanceof CompactAudioBuffer
+                && seg.format === segments[0].format) ? segments[0].format : AUDIO_SAMPLE_F32;
+
+            // 描述符只在 begin 时读取, 数据写入任务自己的内存
+            const arena = new WasmArena(this, 0, segments.length * AUDIO_BUFFER_STRUCT_SIZE);
+            const structs = arena.alloc(segments.length * AUDIO_BUFFER_STRUCT_SIZE);
+            segments.forEach((seg, i) => {
+                arena.writeAudioBuffer(structs + i * AUDIO_BUFFER_STRUCT_SIZE, 0, seg.length, channels, seg.sampleRate,
+                    AUDIO_LAYOUT_PLANAR, compactFormat);
+            });
+            const job = this.module._wasm_job_merge_begin(structs, segments.length);
+            if (job === 0) {
+                throw new Error('WASM 合并失败 (片段格式不一致或内存不足)');
+            }
+
+            const slicer = new TimeSlicer(options.sliceMs);
+            try {
+                for (let i = 0; i < segments.length; i++) {
+                    writeChannel(this.memory, this.jobInputData(job, i), segments[i], 0, channels, compactFormat);
+                    await slicer.tick();
+                }
+                const { data, length } = await this.runJob(job, slicer);
+
+                if (compactFormat !== AUDIO_SAMPLE_F32) {
+                    const Type = compactFormat === AUDIO_SAMPLE_S16 ? Int16Array : Uint16Array;
+                    const target = new CompactAudioBuffer(channels, length, sampleRate, compactFormat);
+                    for (let ch = 0; ch < channels; ch++) {
+                        target.channels[ch] = new Type(this.memory.buffer, data + ch * length * 2, length).slice();
+                        await slicer.tick();
+                    }
+                    return target;
+                }
+                const target = createTarget(channels, length, sampleRate);
+                for (let ch = 0; ch < channels; ch++) {
+                    target.getChannelData(ch).set(new Float32Array(this.memory.buffer, data + ch * length * 4, length));
+                    await slicer.tick();
+                }
+                return target;
+            } finally {
+                this.module._wasm_job_free(job);
+            }
+        }
+
+        /**
+         * 分步重采样: 与 wasm_resample_audio 相同的线性插值, 片与片之间让出主线程
+         * 重采样在 DSP 功能模块中, 只加载核心模块时先 feature('_wasm_job_resample_begin'); 模块没有该导出时返回 null
+         * @param {AudioBuffer|CompactAudioBuffer} audioBuffer - 输入 (紧凑格式在上传时展开为 float, 插值需要随机访问)
+         * @param {number} sampleRate - 目标采样率
+         * @param {Function} createTarget - (channels, length, sampleRate) => AudioBuffer
+         * @param {Object} [options] - { sliceMs: 每个时间片的预算 (毫秒) }
+         * @returns {Promise<AudioBuffer|null>} 平面布局的结果
+         */
+        async resampleSliced(audioBuffer, sampleRate, createTarget, options = {}) {
+            if (typeof this.module._wasm_job_resample_begin !== 'function') return null;
+            const channels = audioBuffer.numberOfChannels;
+            const arena = new WasmArena(this, 0, AUDIO_BUFFER_STRUCT_SIZE);
+            const sourceStruct = arena.alloc(AUDIO_BUFFER_STRUCT_SIZE);
+            arena.writeAudioBuffer(sourceStruct, 0, audioBuffer.length, channels, audioBuffer.sampleRate);
+            const job = this.module._wasm_job_resample_begin(sourceStruct, sampleRate);
+            if (job === 0) {
+                throw new Error('WASM 重采样失败 (参数无效或内存不足)');
+            }
+
+            const slicer = new TimeSlicer(options.sliceMs);
+            try {
+                const input = this.jobInputData(job, 0);
+                for (let ch = 0; ch < channels; ch++) {
+                    writeChannel(this.memory, input, audioBuffer, ch, ch + 1, AUDIO_SAMPLE_F32);
+                    await slicer.tick();
+                }
+                const { data, length } = await this.runJob(job, slicer);
+
+                const target = createTarget(channels, length, sampleRate);
+                for (let ch = 0; ch < channels; ch++) {
+                    target.getChannelData(ch).set(new Float32Array(this.memory.buffer, data + ch * length * 4, length));
+                    await slicer.tick();
+                }
+                return target;
+            } finally {
+                this.module._wasm_job_free(job);
+            }
+        }
+
+        /**
+         * 电平分析: 每 blockFrames 帧的 RMS 和峰值 (所有声道合并, 线性幅度)
+         * 旧版 WASM 未导出 wasm_analyze_audio 时返回 null
+         * @returns {{rms: Float32Array, peak: Float32Array}|null}
+         */
+        analyzeLevels(audioBuffer, blockFrames) {
+            if (typeof this.module._wasm_analyze_audio !== 'function') return null;
+            const channels = audioBuffer.numberOfChannels;
+            const format = this.uploadFormat(audioBuffer);
+            const sourceBytes = audioBuffer.length * channels * sampleBytes(format);
+            const blocks = Math.ceil(audioBuffer.length / blockFrames);
+            const arena = new WasmArena(this, blocks * 8, sourceBytes + AUDIO_BUFFER_STRUCT_SIZE);
+            const sourceStruct = arena.alloc(AUDIO_BUFFER_STRUCT_SIZE);
+            const sourceData = arena.alloc(sourceBytes);
+            arena.writeAudioBuffer(sourceStruct, sourceData, audioBuffer.length, channels, audioBuffer.sampleRate,
+                AUDIO_LAYOUT_PLANAR, format);
+            arena.writeChannels(sourceData, audioBuffer, channels, format);
+
+            const t0 = now();
+            const n = this.module._wasm_analyze_audio(sourceStruct, blockFrames);
+            this.lastKernelMs = now() - t0;
+            if (n === 0 && audioBuffer.length > 0) {
+                throw new Error('WASM 电平分析失败');
+            }
+
+            // AudioLevel: float rms, float peak
+            const levels = arena.f32(arena.base, n * 2);
+            const rms = new Float32Array(n);
+            const peak = new Float32Array(n);
+            for (let i = 0; i < n; i++) {
+                rms[i] = levels[i * 2];
+                peak[i] = levels[i * 2 + 1];
+            }
+            return { rms, peak };
+        }
+
+        /**
+         * 参考音频预处理 (wasm_prepare_reference, 旧版 WASM 未导出时返回 null):
+         * 下混为单声道 -> 重采样 -> 裁剪首尾静音 -> 截取有声帧 RMS 之和最大的 maxSeconds
+         * @param {AudioBuffer|CompactAudioBuffer} audioBuffer - 解码后的参考音频
+         * @param {Object} options - { sampleRate, maxSeconds, silenceDb }
+         * @param {Function} createTarget - (channels, length, sampleRate) => AudioBuffer
+         * @returns {AudioBuffer|null} 单声道缓冲区
+         */
+        prepareReference(audioBuffer, options, createTarget) {
+            if (typeof this.module._wasm_prepare_reference !== 'function') return null;
+            const { sampleRate, maxSeconds = 0, silenceDb = -40 } = options;
+            const channels = audioBuffer.numberOfChannels;
+            const format = this.uploadFormat(audioBuffer);
+            const sourceBytes = audioBuffer.length * channels * sampleBytes(format);
+            // 输出不超过重采样后的长度
+            const maxFrames = Math.ceil(audioBuffer.length * sampleRate / audioBuffer.sampleRate) + 1;
+            const arena = new WasmArena(this, maxFrames * 4, sourceBytes + 2 * AUDIO_BUFFER_STRUCT_SIZE);
+            const sourceStruct = arena.alloc(AUDIO_BUFFER_STRUCT_SIZE);
+            const outputStruct = arena.alloc(AUDIO_BUFFER_STRUCT_SIZE);
+            const sourceData = arena.alloc(sourceBytes);
+            arena.writeAudioBuffer(sourceStruct, sourceData, audioBuffer.length, channels, audioBuffer.sampleRate,
+                AUDIO_LAYOUT_PLANAR, format);
+            arena.writeChannels(sourceData, audioBuffer, channels, format);
+
+            const t0 = now();
+            const n = this.module._wasm_prepare_reference(sourceStruct, sampleRate, maxSeconds, silenceDb, outputStruct);
+            this.lastKernelMs = now() - t0;
+            if (n === 0 && audioBuffer.length > 0) {
+                throw new Error('WASM 参考音频预处理失败');
+            }
+
+            const target = createTarget(1, n, sampleRate);
+            target.getChannelData(0).set(arena.f32(arena.base, n));
+            return target;
+        }
+
+        /**
+         * 生成类语音测试信号 (wasm_generate_speech，旧版 WASM 未导出时返回 null)
+         * @param {Object} options - { frames, sampleRate, channels, seed, peak }
+         * @param {Function} createTarget - (channels, length, sampleRate) => AudioBuffer
+         * @returns {AudioBuffer|null} 平面布局的信号
+         */
+        generateSpeech(options, createTarget) {
+            if (typeof this.module._wasm_generate_speech !== 'function') return null;
+            const { frames, sampleRate, channels = 1, seed = 1, peak = 1.0 } = options;
+            const t0 = now();
+            const n = this.module._wasm_generate_speech(frames, sampleRate, channels, seed, peak);
+            this.lastKernelMs = now() - t0;
+            if (n === 0 && frames > 0) {
+                throw new Error('WASM 信号生成失败');
+            }
+
+            const base = this.module._wasm_get_memory_buffer();
+            const target = createTarget(channels, n, sampleRate);
+            for (let ch = 0; ch < channels; ch++) {
+                target.getChannelData(ch).set(new Float32Array(this.memory.buffer, base + ch * n * 4, n));
+            }
+            return target;
+        }
+    }
+
+    const api = {
+        WasmAudioKernels, AUDIO_BUFFER_STRUCT_SIZE, AUDIO_VIEW_STRUCT_SIZE, AUDIO_LAYOUT_PLANAR, AUDIO_LAYOUT_INTERLEAVED,
+        CompactAudioBuffer, AUDIO_SAMPLE_F32, AUDIO_SAMPLE_S16, AUDIO_SAMPLE_F16,
+        threadingAvailable, loadThreadedModule, WASM_FEATURES, loadFeatureModule, instantiateFromGlue, yieldToMain
+    };
+
+    if (typeof module !== 'undefined' && module.exports) {
+        module.exports = api;
+    } else {
+        Object.assign(root, api);
+    }
+})(typeof window !== 'undefined' ? window : globalThis);
@@ -0,0 +1,154 @@
+/**
+ * 已编译 WASM 模块缓存 - 流式编译 + IndexedDB 持久化 + 与 Worker 共享
+ * 首次访问用 WebAssembly.compileStreaming 边下载边编译; 编译结果 (WebAssembly.Module) 按内容哈希存入 IndexedDB,
+ * 再次访问时哈希相同就直接复用, 跳过下载和编译. 内容哈希优先取响应的 ETag (静态资源托管按内容生成),
+ * 没有 ETag 时对二进制计算 SHA-256 (此时仍需下载, 但省去编译).
+ * 部分浏览器不允许把 WebAssembly.Module 写入 IndexedDB (DataCloneError), 写入失败时忽略,
+ * 流式编译本身仍能命中浏览器的代码缓存.
+ * 浏览器中挂到 window，Node 中通过 module.exports 导出
+ */
+(function(root) {
+    const WASM_CACHE_DB = 'wasm-module-cache';
+    const WASM_CACHE_STORE = 'modules';
+    const WASM_MODULE_MESSAGE = 'wasm-module';
+
+    function openCacheDb() {
+        return new Promise((resolve, reject) => {
+            if (typeof indexedDB === 'undefined') {
+                reject(new Error('IndexedDB 不可用'));
+                return;
+            }
+            const request = indexedDB.open(WASM_CACHE_DB, 1);
+            request.onupgradeneeded = () => request.result.createObjectStore(WASM_CACHE_STORE);
+            request.onsuccess = () => resolve(request.result);
+            request.onerror = () => reject(request.error);
+        });
+    }
+
+    function requestPromise(request) {
+        return new Promise((resolve, reject) => {
+            request.onsuccess = () => resolve(request.result);
+            request.onerror = () => reject(request.error);
+        });
+    }
+
+    async function readCachedModule(key) {
+        const db = await openCacheDb();
+        try {
+            const store = db.transaction(WASM_CACHE_STORE, 'readonly').objectStore(WASM_CACHE_STORE);
+            const module = await requestPromise(store.get(key));
+            return module instanceof WebAssembly.Module ? module : null;
+        } finally {
+            db.close();
+        }
+    }
+
+    // 写入新模块并删除同一 URL 的旧版本
+    async function writeCachedModule(url, key, module) {
+        const db = await openCacheDb();
+        try {
+            const tx = db.transaction(WASM_CACHE_STORE, 'readwrite');
+            const store = tx.objectStore(WASM_CACHE_STORE);
+            const keys = await requestPromise(store.getAllKeys());
+            for (const old of keys) {
+                if (old !== key && old.startsWith(url + '@')) store.delete(old);
+            }
+            store.put(module, key);
+            await new Promise((resolve, reject) => {
+                tx.oncomplete = resolve;
+                tx.onerror = () => reject(tx.error);
+                tx.onabort = () => reject(tx.error);
+            });
+        } finally {
+            db.close();
+        }
+    }
+
+    async function sha256Hex(bytes) {
+        const digest = await crypto.subtle.digest('SHA-256', bytes);
+        return Array.from(new Uint8Array(digest), b => b.toString(16).padStart(2, '0')).join('');
+    }
+
+    /**
+     * 获取已编译的 WASM 模块 (只编译不实例化, 实例化留到第一次使用时)
+     * @param {string} url - WASM 二进制地址
+     * @returns {Promise<{module: WebAssembly.Module, cached: boolean, hash: string}>}
+     */
+    async function loadCompiledModule(url) {
+        const response = await fetch(url);
+        if (!response.ok) {
+            throw new Error('HTTP ' + response.status + ' ' + response.statusText);
+        }
+
+        const etag = response.headers.get('ETag');
+        let hash = etag ? 'etag:' + etag.replace(/^W\//, '').replace(/"/g, '') : null;
+        let bytes = null;
+        if (!hash) {
+            bytes = await response.arrayBuffer();
+            hash = 'sha256:' + await sha256Hex(bytes);
+        }
+        const key = url + '@' + hash;
+
+        try {
+            const cached = await readCachedModule(key);
+            if (cached) {
+                if (!bytes && response.body) response.body.cancel().catch(() => {});
+                return { module: cached, cached: true, hash };
+            }
+        } catch (error) {
+            console.warn('[WASM 缓存] 读取失败:', error.message);
+        }
+
+        let module;
+        if (bytes) {
+            module = await WebAssembly.compile(bytes);
+        } else if (typeof WebAssembly.compileStreaming === 'function'
+            && (response.headers.get('Content-Type') || '').includes('application/wasm')) {
+            module = await WebAssembly.compileStreaming(response);
+        } else {
+            // 服务器未返回 application/wasm 时不能流式编译
+            module = await WebAssembly.compile(await response.arrayBuffer());
+        }
+
+        writeCachedModule(url, key, module).catch(error => {
+            console.warn('[WASM 缓存] 无法持久化已编译模块:', error.message);
+        });
+        return { module, cached: false, hash };
+    }
+
+    /**
+     * 把已编译模块发给 Worker (WebAssembly.Module 可以结构化克隆, Worker 中无需重新下载和编译)
+     * @param {Worker|MessagePort} target
+     * @param {WebAssembly.Module} module
+     * @param {string} [name] - 模块名, Worker 端按名字区分
+     */
+    function postCompiledModule(target, module, name = 'audio_processor') {
+        target.postMessage({ type: WASM_MODULE_MESSAGE, name, module });
+    }
+
+    /**
+     * Worker 端: 等待 postCompiledModule 发来的模块
+     * @param {Object} [scope] - Worker 全局对象 (默认 self)
+     * @param {string} [name]
+     * @returns {Promise<WebAssembly.Module>}
+     */
+    function receiveCompiledModule(scope = root, name = 'audio_processor') {
+        return new Promise(resolve => {
+            scope.addEventListener('message', function onMessage(event) {
+                const data = event.data;
+                if (data && data.type === WASM_MODULE_MESSAGE && data.name === name) {
+                    scope.removeEventListener('message', onMessage);
+                    resolve(data.module);
+                }
+            });
+        });
+    }
+
+    const api = { loadCompiledModule, postCompiledModule, receiveCompiledModule, WASM_MODULE_MESSAGE };
+
+    if (typeof module !== 'undefined' && module.exports) {
+        module.exports = api;
+    } else {
+        Object.assign(root, api);
+    }
+})(typeof window !== 'undefined' ? window : globalThis);
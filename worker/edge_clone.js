@@ -0,0 +1,302 @@
+/**
+ * 边缘克隆 - 在 Cloudflare Worker 中完成切分 / 分发 / 合并
+ *
+ * 页面只上传一次 (TTS 音频 + 参考音频, multipart/form-data), Worker 用与页面相同的 WASM 内核
+ * (wasm_audio.js) 解码并按片段编码, 以受控并发把片段发给 ISV 后端 (/api/clone),
+ * 再把克隆结果按片段顺序流式写回合并后的 WAV. 参考音频在边缘只做一次 base64, 各片段请求复用.
+ *
+ * 响应为事件流 (每行一个 JSON 事件), 片段完成即推送进度; audio 事件行之后紧跟 bytes 个字节的 WAV 数据:
+ *   {"type":"plan", segments, segmentDuration, concurrency, duration}
+ *   {"type":"segment", index, status: "done"|"error", ms, duration, error?}
+ *   {"type":"audio", index, bytes} + 数据 (第一个 audio 事件以 44 字节 WAV 文件头开头)
+ *   {"type":"result", success, data_bytes, stats} 或 {"type":"error", error}
+ * 片段结果按顺序到齐后立即解码、编码为 16 位 PCM 写出, 不在 isolate 中保留整个合并结果.
+ * 文件头中的长度在开始写出时未知, 先写 0xFFFFFFFF (流式 WAV 的约定), 客户端收到 result 后按 data_bytes 改写
+ * (edge_client.js).
+ *
+ * 表单字段: source (WAV), target (参考音频), tau, segment_duration (秒), concurrency, auto_tune (1 / 0)
+ * 环境变量 (wrangler.toml [vars]): ISV_BACKEND, ISV_MAX_CONCURRENCY
+ */
+import planner from '../segment_planner.js';
+
+export const EDGE_CLONE_PATH = '/api/edge/clone';
+
+const WAV_HEADER_BYTES = 44;
+const WAV_STREAMING_SIZE = 0xFFFFFFFF;
+
+const DEFAULT_SEGMENT_DURATION = 10;
+const DEFAULT_MAX_CONCURRENCY = 5;
+const DEFAULT_TAU = 0.3;
+
+// 每个 isolate 一个分段计划器: 没有 localStorage, 观测只保存在内存中, isolate 存活期间持续调优
+const segmentPlanner = new planner.SegmentPlanner({ storage: null });
+
+/**
+ * Worker 中的 AudioBuffer 替身 (平面存储)
+ */
+class EdgeAudioBuffer {
+    constructor(numberOfChannels, length, sampleRate) {
+        this.numberOfChannels = numberOfChannels;
+        this.length = length;
+        this.sampleRate = sampleRate;
+        this.channels = [];
+        for (let ch = 0; ch < numberOfChannels; ch++) {
+            this.channels.push(new Float32Array(length));
+        }
+    }
+
+    get duration() {
+        return this.length / this.sampleRate;
+    }
+
+    getChannelData(ch) {
+        return this.channels[ch];
+    }
+}
+
+const createTarget = (channels, length, sampleRate) => new EdgeAudioBuffer(channels, length, sampleRate);
+
+// 分块转换, 避免 String.fromCharCode 参数过多
+function bytesToBase64(bytes) {
+    const view = bytes instanceof Uint8Array ? bytes : new Uint8Array(bytes);
+    let binary = '';
+    for (let i = 0; i < view.length; i += 0x8000) {
+        binary += String.fromCharCode.apply(null, view.subarray(i, i + 0x8000));
+    }
+    return btoa(binary);
+}
+
+function base64ToBytes(base64) {
+    const binary = atob(base64.replace(/^data:[^,]*,/, ''));
+    const bytes = new Uint8Array(binary.length);
+    for (let i = 0; i < binary.length; i++) {
+        bytes[i] = binary.charCodeAt(i);
+    }
+    return bytes;
+}
+
+function jsonError(status, message) {
+    return new Response(JSON.stringify({ success: false, error: message }), {
+        status,
+        headers: { 'Content-Type': 'application/json' }
+    });
+}
+
+/**
+ * 按时长切分的计划 (与页面的 splitAudioIntoSegments 一致, 最后一段取余下部分)
+ */
+function segmentPlan(audioBuffer, segmentDuration) {
+    const segmentFrames = Math.max(1, Math.round(segmentDuration * audioBuffer.sampleRate));
+    const plan = [];
+    for (let start = 0; start < audioBuffer.length; start += segmentFrames) {
+        plan.push({ start, length: Math.min(segmentFrames, audioBuffer.length - start) });
+    }
+    return plan;
+}
+
+// 切分并编码为 16 位 WAV; 旧版 WASM 没有视图导出时先切片再逐段编码
+function encodePlan(kernels, audioBuffer, plan) {
+    if (kernels.supportsBatch || kernels.supportsViews) {
+        return kernels.encodeSegments(audioBuffer, plan);
+    }
+    return kernels.sliceSegments(audioBuffer, plan, createTarget).map(seg => kernels.encodeWav(seg));
+}
+
+/**
+ * 受控并发执行: 同时最多 limit 个任务, 一个完成立即开始下一个 (不按批次等待)
+ */
+async function runPool(count, limit, task) {
+    let next = 0;
+    const workers = [];
+    for (let w = 0; w < Math.min(limit, count); w++) {
+        workers.push((async () => {
+            while (next < count) {
+                await task(next++);
+            }
+        })());
+    }
+    await Promise.all(workers);
+}
+
+async function cloneSegment(backend, targetBase64, wav, tau) {
+    const response = await fetch(`${backend}/api/clone`, {
+        method: 'POST',
+        headers: { 'Content-Type': 'application/json' },
+        body: JSON.stringify({ target_audio: targetBase64, source_audio: bytesToBase64(wav), tau })
+    });
+    if (!response.ok) {
+        const errorText = await response.text();
+        throw new Error(`HTTP ${response.status} - ${errorText.substring(0, 100)}`);
+    }
+    const result = await response.json();
+    if (!result.success) {
+        throw new Error(result.error || '片段处理失败');
+    }
+    return result.result_audio;
+}
+
+/**
+ * 克隆结果 (base64 WAV) 转为 16 位 PCM 数据; format 为已写出的格式 ({channels, sampleRate}), 不一致时抛出错误
+ * @returns {{format: Object, wav: Uint8Array}} 含 44 字节文件头的 WAV
+ */
+function encodeResult(kernels, base64, format) {
+    const audio = kernels.decodeWav(base64ToBytes(base64), createTarget);
+    const channels = Math.min(2, audio.numberOfChannels);
+    if (format && (format.channels !== channels || format.sampleRate !== audio.sampleRate)) {
+        throw new Error(`格式与之前的片段不一致 (${channels} 声道 ${audio.sampleRate} Hz)`);
+    }
+    return { format: { channels, sampleRate: audio.sampleRate }, wav: new Uint8Array(kernels.encodeWav(audio)) };
+}
+
+/**
+ * 处理 POST /api/edge/clone
+ * @param {Request} request
+ * @param {Object} env - Worker 环境 (ISV_BACKEND, ISV_MAX_CONCURRENCY)
+ * @param {WasmAudioKernels} kernels - 已实例化的 WASM 内核
+ * @param {Object} [ctx] - ExecutionContext, 响应返回后继续处理
+ * @returns {Promise<Response>}
+ */
+export async function handleEdgeClone(request, env, kernels, ctx) {
+    if (request.method !== 'POST') {
+        return jsonError(405, '只支持 POST');
+    }
+    if (!env.ISV_BACKEND) {
+        return jsonError(500, '未配置 ISV_BACKEND');
+    }
+
+    let form;
+    try {
+        form = await request.formData();
+    } catch (error) {
+        return jsonError(400, '请求体不是 multipart/form-data');
+    }
+    const source = form.get('source');
+    const target = form.get('target');
+    if (!source || typeof source === 'string' || !target || typeof target === 'string') {
+        return jsonError(400, '缺少 source 或 target 文件');
+    }
+
+    let audio;
+    try {
+        audio = kernels.decodeWav(await source.arrayBuffer(), createTarget);
+    } catch (error) {
+        return jsonError(400, `source 解码失败: ${error.message}`);
+    }
+    if (audio.length === 0) {
+        return jsonError(400, 'source 为空');
+    }
+
+    const backend = env.ISV_BACKEND.replace(/\/$/, '');
+    const maxConcurrency = parseInt(env.ISV_MAX_CONCURRENCY) || DEFAULT_MAX_CONCURRENCY;
+    const tau = form.has('tau') ? parseFloat(form.get('tau')) : DEFAULT_TAU;
+    const plan = segmentPlanner.plan(backend, audio.duration, {
+        manual: {
+            segmentDuration: parseFloat(form.get('segment_duration')) || DEFAULT_SEGMENT_DURATION,
+            concurrency: parseInt(form.get('concurrency')) || maxConcurrency
+        },
+        maxConcurrency,
+        autoTune: form.get('auto_tune') === '1'
+    });
+    const targetBase64 = bytesToBase64(await target.arrayBuffer());
+
+    const { readable, writable } = new TransformStream();
+    const writer = writable.getWriter();
+    const encoder = new TextEncoder();
+    const send = event => writer.write(encoder.encode(JSON.stringify(event) + '\n'));
+    // 事件行与数据在同一同步段内写入, 其他事件不会插在两者之间
+    const sendAudio = (index, data) => Promise.all([
+        send({ type: 'audio', index, bytes: data.length }),
+        writer.write(data)
+    ]);
+
+    const job = (async () => {
+        try {
+            // 支持批量导出时一次 WASM 调用切分并编码全部片段, 之后源数据不再需要
+            const segments = segmentPlan(audio, plan.segmentDuration);
+            const durations = segments.map(seg => seg.length / audio.sampleRate);
+            const wavs = encodePlan(kernels, audio, segments);
+            audio = null;
+            await send({
+                type: 'plan',
+                segments: wavs.length,
+                segmentDuration: plan.segmentDuration,
+                concurrency: plan.concurrency,
+                duration: plan.audioDuration
+            });
+
+            // 按片段顺序写出: results[i] 为 undefined (未完成) / null (失败或已写出) / base64 结果
+            // 只合并成功的片段 (与页面一致, 失败片段跳过)
+            const results = new Array(wavs.length);
+            let nextOutput = 0, format = null, dataBytes = 0, successful = 0;
+            const flush = () => {
+                const writes = [];
+                while (nextOutput < results.length && results[nextOutput] !== undefined) {
+                    const index = nextOutput++;
+                    const base64 = results[index];
+                    results[index] = null;
+                    if (base64 === null) continue;
+                    try {
+                        const encoded = encodeResult(kernels, base64, format);
+                        let data = encoded.wav.subarray(WAV_HEADER_BYTES);
+                        if (!format) {
+                            format = encoded.format;
+                            const view = new DataView(encoded.wav.buffer, encoded.wav.byteOffset);
+                            view.setUint32(4, WAV_STREAMING_SIZE, true);
+                            view.setUint32(40, WAV_STREAMING_SIZE, true);
+                            data = encoded.wav;
+                        }
+                        dataBytes += encoded.wav.length - WAV_HEADER_BYTES;
+                        successful++;
+                        writes.push(sendAudio(index, data));
+                    } catch (error) {
+                        writes.push(send({ type: 'segment', index, status: 'error', error: error.message }));
+                    }
+                }
+                return Promise.all(writes);
+            };
+
+            await runPool(wavs.length, plan.concurrency, async index => {
+                const start = Date.now();
+                try {
+                    results[index] = await cloneSegment(backend, targetBase64, wavs[index], tau);
+                    const ms = Date.now() - start;
+                    segmentPlanner.record(backend, durations[index], ms, plan.concurrency);
+                    await send({ type: 'segment', index, status: 'done', ms, duration: durations[index] });
+                } catch (error) {
+                    results[index] = null;
+                    await send({ type: 'segment', index, status: 'error', ms: Date.now() - start,
+                        duration: durations[index], error: error.message });
+                }
+                wavs[index] = null;
+                await flush();
+            });
+
+            if (successful === 0) {
+                throw new Error('所有片段处理都失败了');
+            }
+            await send({
+                type: 'result',
+                success: true,
+                data_bytes: dataBytes,
+                stats: {
+                    total_segments: results.length,
+                    successful_segments: successful,
+                    failed_segments: results.length - successful,
+                    edge: true
+                }
+            });
+        } catch (error) {
+            await send({ type: 'error', success: false, error: error.message }).catch(() => {});
+        } finally {
+            await writer.close().catch(() => {});
+        }
+    })();
+    if (ctx && typeof ctx.waitUntil === 'function') ctx.waitUntil(job);
+
+    return new Response(readable, {
+        headers: {
+            'Content-Type': 'application/octet-stream',
+            'Cache-Control': 'no-store'
+        }
+    });
+}
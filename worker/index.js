@@ -0,0 +1,65 @@
+/**
+ * Cloudflare Worker 入口
+ * /api/edge/clone 在边缘执行切分 / 分发 / 合并 (edge_clone.js), /api/tts 经边缘缓存代理 (tts_cache.js),
+ * /api/edge/health 告诉页面哪些边缘服务已配置 (页面由 Worker 提供时改用同源接口), 其余请求交给静态资源,
+ * 静态资源加上跨源隔离响应头 (ISOLATION_HEADERS)
+ *
+ * WASM 与页面使用同一份构建产物: audio_processor.wasm 作为已编译模块导入,
+ * 胶水代码按文本导入 (wrangler.toml [[rules]]), 只用来解析压缩后的导出名, 不执行
+ * 本地调试: node worker/stub_backend.js 启动桩后端, 再
+ *   wrangler dev --var ISV_BACKEND:http://localhost:8790 --var TTS_BACKEND:http://localhost:8790
+ */
+import glueSource from '../audio_processor.js';
+import wasmModule from '../audio_processor.wasm';
+import wasmAudio from '../wasm_audio.js';
+import { EDGE_CLONE_PATH, handleEdgeClone } from './edge_clone.js';
+import { TTS_PATH, handleTtsCache } from './tts_cache.js';
+
+export const EDGE_HEALTH_PATH = '/api/edge/health';
+
+// 跨源隔离后页面才有 SharedArrayBuffer, loadThreadedModule (wasm_audio.js) 才会加载多线程模块;
+// pthread Worker 的脚本同样需要这些头. COEP 用 credentialless 而不是 require-corp:
+// CDN 上的 Bootstrap 与 hf.space 的响应不带 CORP 头, 无凭据加载即可, 不会被拦截 (不支持 credentialless 的浏览器不隔离, 用单线程模块)
+export const ISOLATION_HEADERS = {
+    'Cross-Origin-Opener-Policy': 'same-origin',
+    'Cross-Origin-Embedder-Policy': 'credentialless'
+};
+
+function withIsolationHeaders(response) {
+    const isolated = new Response(response.body, response);
+    for (const [name, value] of Object.entries(ISOLATION_HEADERS)) {
+        isolated.headers.set(name, value);
+    }
+    return isolated;
+}
+
+// isolate 内复用同一个实例; 实例化失败时下次请求重试
+let kernelsPromise = null;
+
+function getKernels() {
+    if (!kernelsPromise) {
+        // 边缘只用核心导出 (解码 / 编码 / 合并), 不加载功能模块
+        kernelsPromise = wasmAudio.instantiateFromGlue(glueSource, wasmModule,
+            feature => Promise.reject(new Error(`边缘未部署功能模块 ${feature.wasmUrl}`)));
+        kernelsPromise.catch(() => { kernelsPromise = null; });
+    }
+    return kernelsPromise;
+}
+
+export default {
+    async fetch(request, env, ctx) {
+        const url = new URL(request.url);
+        if (url.pathname === EDGE_CLONE_PATH) {
+            return handleEdgeClone(request, env, await getKernels(), ctx);
+        }
+        if (url.pathname === TTS_PATH) {
+            return handleTtsCache(request, env, ctx);
+        }
+        if (url.pathname === EDGE_HEALTH_PATH) {
+            return new Response(JSON.stringify({ success: true, clone: !!env.ISV_BACKEND, tts: !!env.TTS_BACKEND }), {
+                headers: { 'Content-Type': 'application/json', 'Cache-Control': 'no-store' }
+            });
+        }
+        return withIsolationHeaders(await env.ASSETS.fetch(request));
+    }
+};
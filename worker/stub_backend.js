@@ -0,0 +1,112 @@
+/**
+ * 后端桩 - 本地调试 Worker (wrangler dev / Miniflare) 用, 同时充当 ISV 与 TTS 后端
+ * POST /api/clone: 原样返回 source_audio, 按音频长度模拟处理延迟, 可按比例随机失败
+ * POST /api/tts: 按文本生成确定的 16 位单声道 WAV (同一文本每次字节相同), 模拟合成延迟
+ *
+ * 用法: node worker/stub_backend.js [--port=8790] [--ms_per_second=200] [--fail_rate=0] [--tts_ms=500]
+ */
+'use strict';
+
+const http = require('http');
+
+const options = { port: 8790, msPerSecond: 200, failRate: 0, ttsMs: 500 };
+for (const arg of process.argv.slice(2)) {
+    const [key, value] = arg.replace(/^--/, '').split('=');
+    if (key === 'port') options.port = Number(value);
+    else if (key === 'ms_per_second') options.msPerSecond = Number(value);
+    else if (key === 'fail_rate') options.failRate = Number(value);
+    else if (key === 'tts_ms') options.ttsMs = Number(value);
+    else throw new Error(`未知参数: ${arg}`);
+}
+
+let active = 0;
+let ttsRequests = 0;
+
+function send(res, status, body) {
+    res.writeHead(status, { 'Content-Type': 'application/json' });
+    res.end(JSON.stringify(body));
+}
+
+// 每个字 0.15 秒的正弦音, 频率由字符编码决定
+function synthesize(text, speed) {
+    const sampleRate = 22050;
+    const chars = Array.from(text);
+    const charFrames = Math.round(0.15 * sampleRate / speed);
+    const wav = Buffer.alloc(44 + chars.length * charFrames * 2);
+    wav.write('RIFF', 0);
+    wav.writeUInt32LE(wav.length - 8, 4);
+    wav.write('WAVEfmt ', 8);
+    wav.writeUInt32LE(16, 16);
+    wav.writeUInt16LE(1, 20);
+    wav.writeUInt16LE(1, 22);
+    wav.writeUInt32LE(sampleRate, 24);
+    wav.writeUInt32LE(sampleRate * 2, 28);
+    wav.writeUInt16LE(2, 32);
+    wav.writeUInt16LE(16, 34);
+    wav.write('data', 36);
+    wav.writeUInt32LE(wav.length - 44, 40);
+    chars.forEach((c, i) => {
+        const freq = 200 + (c.codePointAt(0) % 400);
+        for (let n = 0; n < charFrames; n++) {
+            const v = Math.round(8000 * Math.sin(2 * Math.PI * freq * n / sampleRate));
+            wav.writeInt16LE(v, 44 + (i * charFrames + n) * 2);
+        }
+    });
+    return wav;
+}
+
+function handleTts(res, body) {
+    if (!body.text || !body.model) {
+        send(res, 400, { success: false, error: 'missing text or model' });
+        return;
+    }
+    ttsRequests++;
+    console.log(`[stub] TTS #${ttsRequests}: ${body.model} "${body.text.substring(0, 20)}"`);
+    setTimeout(() => {
+        const wav = synthesize(body.text, body.speed || 1.0);
+        res.writeHead(200, { 'Content-Type': 'audio/wav', 'Content-Length': wav.length });
+        res.end(wav);
+    }, options.ttsMs);
+}
+
+http.createServer((req, res) => {
+    if (req.method !== 'POST' || (req.url !== '/api/clone' && req.url !== '/api/tts')) {
+        send(res, 404, { success: false, error: 'not found' });
+        return;
+    }
+    const chunks = [];
+    req.on('data', chunk => chunks.push(chunk));
+    req.on('end', () => {
+        let body;
+        try {
+            body = JSON.parse(Buffer.concat(chunks).toString());
+        } catch (error) {
+            send(res, 400, { success: false, error: 'invalid json' });
+            return;
+        }
+        if (req.url === '/api/tts') {
+            handleTts(res, body);
+            return;
+        }
+        if (!body.source_audio || !body.target_audio) {
+            send(res, 400, { success: false, error: 'missing audio' });
+            return;
+        }
+
+        // 16 位 WAV: 数据字节数 / (声道数 × 2) / 采样率
+        const wav = Buffer.from(body.source_audio, 'base64');
+        const seconds = wav.length > 44 ? (wav.length - 44) / (wav.readUInt16LE(22) * 2) / wav.readUInt32LE(24) : 0;
+        active++;
+        console.log(`[stub] ${seconds.toFixed(2)}s, 并发 ${active}`);
+        setTimeout(() => {
+            active--;
+            if (Math.random() < options.failRate) {
+                send(res, 500, { success: false, error: 'stub failure' });
+            } else {
+                send(res, 200, { success: true, result_audio: body.source_audio, stats: { stub: true, seconds } });
+            }
+        }, seconds * options.msPerSecond);
+    });
+}).listen(options.port, () => {
+    console.log(`[stub] 桩后端: http://localhost:${options.port}/api/clone, /api/tts`);
+});
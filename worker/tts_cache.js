@@ -0,0 +1,179 @@
+/**
+ * TTS 边缘缓存 - 代理 /api/tts, 相同参数的合成结果直接从 Cache API 返回
+ *
+ * 同一组 (text, model, speed, volume, noise_scale, sentence_silence) 的合成结果是确定的:
+ * 参数先规范化 (文本 NFC + 合并空白, 缺省值补齐, 数值按滑块精度取整), 规范化后的 JSON 做 SHA-256 作为缓存键.
+ * 未命中时把规范化参数转发给 TTS_BACKEND, 成功的响应写入缓存 (TTS_CACHE_TTL 秒).
+ * 支持单个 Range (bytes=a-b / a- / -n), 客户端可以先取文件头和开头部分尽早开始解码.
+ * 注意 Cache API 只在绑定自定义域名的区域生效, *.workers.dev 上 match 总是未命中.
+ *
+ * 请求: POST JSON (与 /api/tts 相同) 或 GET 查询参数
+ * 响应头:
+ *   X-Cache: HIT | MISS
+ *   X-Cache-Hit-Ratio: 本 isolate 的命中率 (hits/requests)
+ *   X-Cache-Latency-Saved-Ms: 命中时省下的时间 (写入缓存时记录的后端耗时 - 本次耗时)
+ *   Server-Timing: cache;desc=HIT|MISS, origin;dur=后端耗时
+ */
+
+export const TTS_PATH = '/api/tts';
+
+const TTS_CACHE_NAME = 'tts-v1';
+const DEFAULT_TTL = 7 * 24 * 3600;
+
+// 与页面发出的请求一致的缺省值, 以及各参数参与缓存键时的小数位数
+const TTS_DEFAULTS = { speed: 1.0, volume: 1.0, noise_scale: 0.667, sentence_silence: 0.5 };
+const TTS_DECIMALS = { speed: 2, volume: 2, noise_scale: 3, sentence_silence: 2 };
+
+// 本 isolate 的命中统计 (isolate 回收后清零)
+const stats = { hits: 0, requests: 0 };
+
+async function sha256Hex(text) {
+    const digest = await crypto.subtle.digest('SHA-256', new TextEncoder().encode(text));
+    return Array.from(new Uint8Array(digest), b => b.toString(16).padStart(2, '0')).join('');
+}
+
+/**
+ * 规范化 TTS 参数, 键顺序固定 (作为缓存键和转发给后端的请求体)
+ * @returns {Object|null} 缺少文本或模型时返回 null
+ */
+export function normalizeTtsParams(params) {
+    const text = String(params.text || '').normalize('NFC').replace(/\s+/g, ' ').trim();
+    const model = String(params.model || '').trim();
+    if (!text || !model) return null;
+
+    const normalized = { text, model };
+    for (const name of Object.keys(TTS_DEFAULTS)) {
+        let value = parseFloat(params[name]);
+        if (!Number.isFinite(value)) value = TTS_DEFAULTS[name];
+        normalized[name] = Number(value.toFixed(TTS_DECIMALS[name]));
+    }
+    return normalized;
+}
+
+/**
+ * 解析单个字节范围
+ * @returns {{start: number, end: number}|null|false} 无 Range 时 null, 无法满足时 false
+ */
+function parseRange(header, size) {
+    if (!header) return null;
+    const m = /^bytes=(\d*)-(\d*)$/.exec(header.trim());
+    if (!m || (m[1] === '' && m[2] === '')) return false;
+    let start, end;
+    if (m[1] === '') {
+        // bytes=-n: 最后 n 个字节
+        start = Math.max(0, size - Number(m[2]));
+        end = size - 1;
+    } else {
+        start = Number(m[1]);
+        end = m[2] === '' ? size - 1 : Math.min(Number(m[2]), size - 1);
+    }
+    return start <= end && start < size ? { start, end } : false;
+}
+
+/**
+ * 按 Range 返回完整内容或其中一段, 附加统计头
+ */
+function respond(body, headers, rangeHeader, extraHeaders) {
+    const out = new Headers(headers);
+    out.set('Accept-Ranges', 'bytes');
+    for (const [name, value] of Object.entries(extraHeaders)) {
+        out.set(name, value);
+    }
+
+    const size = body.byteLength;
+    const range = parseRange(rangeHeader, size);
+    if (range === false) {
+        out.set('Content-Range', `bytes */${size}`);
+        out.delete('Content-Length');
+        return new Response(null, { status: 416, headers: out });
+    }
+    if (range) {
+        out.set('Content-Range', `bytes ${range.start}-${range.end}/${size}`);
+        out.set('Content-Length', String(range.end - range.start + 1));
+        return new Response(body.slice(range.start, range.end + 1), { status: 206, headers: out });
+    }
+    out.set('Content-Length', String(size));
+    return new Response(body, { status: 200, headers: out });
+}
+
+/**
+ * 处理 /api/tts
+ * @param {Request} request
+ * @param {Object} env - Worker 环境 (TTS_BACKEND, TTS_CACHE_TTL)
+ * @param {Object} [ctx] - ExecutionContext, 缓存写入在响应返回后完成
+ * @returns {Promise<Response>}
+ */
+export async function handleTtsCache(request, env, ctx) {
+    const start = Date.now();
+    if (!env.TTS_BACKEND) {
+        return new Response('未配置 TTS_BACKEND', { status: 500 });
+    }
+
+    let params;
+    if (request.method === 'GET') {
+        params = Object.fromEntries(new URL(request.url).searchParams);
+    } else if (request.method === 'POST') {
+        try {
+            params = await request.json();
+        } catch (error) {
+            return new Response('请求体不是 JSON', { status: 400 });
+        }
+    } else {
+        return new Response('只支持 GET / POST', { status: 405 });
+    }
+    const normalized = normalizeTtsParams(params);
+    if (!normalized) {
+        return new Response('缺少 text 或 model', { status: 400 });
+    }
+
+    const body = JSON.stringify(normalized);
+    const hash = await sha256Hex(body);
+    // Cache API 只能以 GET 请求为键
+    const key = new Request(`${new URL(request.url).origin}/__tts_cache/${hash}`);
+    const cache = await caches.open(TTS_CACHE_NAME);
+    const rangeHeader = request.headers.get('Range');
+    stats.requests++;
+
+    const cached = await cache.match(key);
+    if (cached) {
+        stats.hits++;
+        const audio = await cached.arrayBuffer();
+        const originMs = Number(cached.headers.get('X-Origin-Ms')) || 0;
+        const elapsed = Date.now() - start;
+        return respond(audio, cached.headers, rangeHeader, {
+            'X-Cache': 'HIT',
+            'X-Cache-Hit-Ratio': (stats.hits / stats.requests).toFixed(3),
+            'X-Cache-Latency-Saved-Ms': String(Math.max(0, originMs - elapsed)),
+            'Server-Timing': `cache;desc=HIT, origin;dur=${originMs}`
+        });
+    }
+
+    const originStart = Date.now();
+    const response = await fetch(`${env.TTS_BACKEND.replace(/\/$/, '')}${TTS_PATH}`, {
+        method: 'POST',
+        headers: { 'Content-Type': 'application/json' },
+        body
+    });
+    if (!response.ok) {
+        // 错误不缓存, 原样返回
+        return new Response(response.body, { status: response.status, headers: response.headers });
+    }
+    const audio = await response.arrayBuffer();
+    const originMs = Date.now() - originStart;
+
+    const headers = new Headers();
+    headers.set('Content-Type', response.headers.get('Content-Type') || 'audio/wav');
+    headers.set('Cache-Control', `public, max-age=${parseInt(env.TTS_CACHE_TTL) || DEFAULT_TTL}`);
+    headers.set('X-Origin-Ms', String(originMs));
+    const put = cache.put(key, new Response(audio.slice(0), { headers })).catch(error => {
+        console.warn('[TTS 缓存] 写入失败:', error.message);
+    });
+    if (ctx && typeof ctx.waitUntil === 'function') ctx.waitUntil(put);
+
+    return respond(audio, headers, rangeHeader, {
+        'X-Cache': 'MISS',
+        'X-Cache-Hit-Ratio': (stats.hits / stats.requests).toFixed(3),
+        'X-Cache-Latency-Saved-Ms': '0',
+        'Server-Timing': `cache;desc=MISS, origin;dur=${originMs}`
+    });
+}